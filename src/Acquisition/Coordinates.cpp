@@ -244,6 +244,8 @@ void KITGPI::Acquisition::Coordinates<ValueType>::init(std::vector<IndexType> &d
 
         varDH[layer] = DH * dhFactor[layer];
     }
+
+    initTables();
 }
 
 /*! \brief constructor for regular grid
@@ -292,6 +294,61 @@ void KITGPI::Acquisition::Coordinates<ValueType>::init()
     SCAI_ASSERT_ERROR(NX > 0, "NX<=0");
     SCAI_ASSERT_ERROR(NY > 0, "NY<=0");
     SCAI_ASSERT_ERROR(NZ > 0, "NZ<=0");
+
+    initTables();
+}
+
+/*! \brief Initialization of the lookup tables of the mapping
+ *
+ * The index of the first gridpoint of each layer is stored as a prefix sum and the layer, the interface distance and the transition are stored per y coordinate,
+ * so the mapping between coordinates and indices does not search the layers. Has to be called after the layers are defined.
+ */
+template <typename ValueType>
+void KITGPI::Acquisition::Coordinates<ValueType>::initTables()
+{
+    layerOffset.assign(numLayers + 1, 0);
+    nGridpointsXZ.assign(numLayers, 0);
+    for (IndexType layer = 0; layer < numLayers; layer++) {
+        layerOffset[layer + 1] = layerOffset[layer] + nGridpointsPerLayer[layer];
+        nGridpointsXZ[layer] = varNX[layer] * varNZ[layer];
+    }
+
+    // the getters below search the layers as long as the tables are empty
+    mapLayerOfY.clear();
+    layerOfY.clear();
+    distToInterfaceOfY.clear();
+    transitionOfY.clear();
+    onInterfaceOfY.clear();
+
+    std::vector<IndexType> mapLayer(NY, -1);
+    std::vector<IndexType> layerTable(NY, 0);
+    std::vector<IndexType> distTable(NY, 0);
+    std::vector<int> transitionTable(NY, 0);
+    std::vector<char> onInterfaceTable(NY, 0);
+    for (IndexType y = 0; y < NY; y++) {
+        for (IndexType layer = 0; layer < numLayers; layer++) {
+            if ((y <= layerEnd[layer]) && (y >= layerStart[layer])) {
+                mapLayer[y] = layer;
+                break;
+            }
+        }
+        coordinate3D coordinate;
+        coordinate.x = 0;
+        coordinate.y = y;
+        coordinate.z = 0;
+        layerTable[y] = getLayer(coordinate);
+        distTable[y] = distToInterface(y);
+        onInterfaceTable[y] = locatedOnInterface(y);
+        if (onInterfaceTable[y]) {
+            transitionTable[y] = getTransition(y);
+        }
+    }
+
+    mapLayerOfY.swap(mapLayer);
+    layerOfY.swap(layerTable);
+    distToInterfaceOfY.swap(distTable);
+    transitionOfY.swap(transitionTable);
+    onInterfaceOfY.swap(onInterfaceTable);
 }
 
 /*! \brief getter function for DH
@@ -391,6 +448,10 @@ IndexType KITGPI::Acquisition::Coordinates<ValueType>::getNGridpoints(IndexType
 template <typename ValueType>
 IndexType KITGPI::Acquisition::Coordinates<ValueType>::getLayer(coordinate3D coordinate) const
 {
+    if ((coordinate.y >= 0) && (coordinate.y < IndexType(layerOfY.size()))) {
+        return (layerOfY[coordinate.y]);
+    }
+
     IndexType layer = 0;
 
     for (layer = 0; layer < numLayers; layer++) {
@@ -481,6 +542,10 @@ bool KITGPI::Acquisition::Coordinates<ValueType>::locatedOnInterface(coordinate3
 template <typename ValueType>
 bool KITGPI::Acquisition::Coordinates<ValueType>::locatedOnInterface(IndexType yCoordinate) const
 {
+    if ((yCoordinate >= 0) && (yCoordinate < IndexType(onInterfaceOfY.size()))) {
+        return (onInterfaceOfY[yCoordinate] != 0);
+    }
+
     bool isOnInterface = false;
     for (IndexType layer = 0; layer < numLayers; layer++) {
         if (int(yCoordinate) == interface[layer]) {
@@ -497,6 +562,10 @@ bool KITGPI::Acquisition::Coordinates<ValueType>::locatedOnInterface(IndexType y
 template <typename ValueType>
 IndexType KITGPI::Acquisition::Coordinates<ValueType>::distToInterface(IndexType Y) const
 {
+    if ((Y >= 0) && (Y < IndexType(distToInterfaceOfY.size()))) {
+        return (distToInterfaceOfY[Y]);
+    }
+
     IndexType dist = NY;
     for (auto i = interface.begin() + 1; i != interface.end() - 1; ++i) {
         IndexType temp = std::abs(int(Y) - int(*i));
@@ -526,6 +595,10 @@ int KITGPI::Acquisition::Coordinates<ValueType>::getTransition(IndexType yCoordi
     if (!locatedOnInterface(yCoordinate)) {
         COMMON_THROWEXCEPTION("Y Coordinate Y=" << yCoordinate << " is not located on an variable grid interface");
     }
+    if ((yCoordinate >= 0) && (yCoordinate < IndexType(transitionOfY.size()))) {
+        return (transitionOfY[yCoordinate]);
+    }
+
     int fineToCoarse = 0;
     for (IndexType layer = 0; layer < numLayers; layer++) {
         if (int(yCoordinate) == interface[layer + 1]) {
@@ -554,8 +627,11 @@ std::vector<scai::lama::DenseVector<ValueType>> KITGPI::Acquisition::Coordinates
         assembly[i].reserve(ownedIndexes.size());
     }
 
+    std::vector<coordinate3D> ownedCoordinates = index2coordinate(ownedIndexes);
+    IndexType localIndex = 0;
     for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
-        coordinate3D coordinate = index2coordinate(ownedIndex);
+        coordinate3D const &coordinate = ownedCoordinates[localIndex];
+        localIndex++;
 
         assembly[0].push(ownedIndex, ValueType(coordinate.x));
         assembly[1].push(ownedIndex, ValueType(coordinate.y));
@@ -614,36 +690,37 @@ bool KITGPI::Acquisition::Coordinates<ValueType>::locatedOnSurface(IndexType ind
 template <typename ValueType>
 KITGPI::Acquisition::coordinate3D KITGPI::Acquisition::Coordinates<ValueType>::mapIndex2coordinate(IndexType index) const
 {
-    IndexType layer;
-    // find out which in which layer the index is and reduce index to index inside this layer
-    for (layer = 0; layer < numLayers; layer++) {
-        if (index >= nGridpointsPerLayer[layer])
-            index -= nGridpointsPerLayer[layer];
-        else
-            break;
-    }
+    IndexType layer = getLayerOfIndex(index);
+    // reduce index to index inside this layer
+    index -= layerOffset[layer];
 
     coordinate3D result;
 
-    result.y = IndexType(index / (varNX[layer] * varNZ[layer]));
-    index -= result.y * (varNX[layer] * varNZ[layer]);
+    result.y = index / nGridpointsXZ[layer];
+    index -= result.y * nGridpointsXZ[layer];
 
-    result.z = IndexType(index / (varNX[layer]));
-    index -= result.z * (varNX[layer]);
+    result.z = index / varNX[layer];
+    result.x = index - result.z * varNX[layer];
 
-    result.x = index;
-
-    // coordinates in reference to the fine grid
+    // coordinates in reference to the fine grid, the subgrid coordinates are moved to global coordinates
     result.x *= dhFactor[layer];
-    result.y *= dhFactor[layer];
+    result.y = result.y * dhFactor[layer] + layerStart[layer];
     result.z *= dhFactor[layer];
 
-    // move the subgrid coordinates to global coordinates
-    result.y += layerStart[layer];
-
     return (result);
 }
 
+/*! \brief Layer which contains a 1-D index
+ *
+ \param index Model vector Index
+ */
+template <typename ValueType>
+IndexType KITGPI::Acquisition::Coordinates<ValueType>::getLayerOfIndex(IndexType index) const
+{
+    // first layer whose end is behind the index (the regular grid has only one layer)
+    return (std::upper_bound(layerOffset.begin() + 1, layerOffset.end() - 1, index) - (layerOffset.begin() + 1));
+}
+
 /*! \brief General mapping from 1-D index to 3-D coordinate
  *
  * Maps a 1-D index into 3-D coordinates.
@@ -667,30 +744,11 @@ KITGPI::Acquisition::coordinate3D KITGPI::Acquisition::Coordinates<ValueType>::i
 template <typename ValueType>
 IndexType KITGPI::Acquisition::Coordinates<ValueType>::map3Dcoordinate2index(IndexType X, IndexType Y, IndexType Z) const
 {
+    IndexType layer = ((Y >= 0) && (Y < IndexType(mapLayerOfY.size()))) ? mapLayerOfY[Y] : -1;
 
-    SCAI_ASSERT(X < NX, "X=" << X << " Y=" << Y << " Z=" << Z << " NX=" << NX << " Could not map from coordinate to index!");
-    SCAI_ASSERT(Y < NY, "X=" << X << " Y=" << Y << " Z=" << Z << " NY=" << NY << " Could not map from coordinate to index!");
-    SCAI_ASSERT(Z < NZ, "X=" << X << " Y=" << Y << " Z=" << Z << " NZ=" << NZ << " Could not map from coordinate to index!");
-    SCAI_ASSERT(X >= 0, "X=" << X << " Y=" << Y << " Z=" << Z << " Could not map from coordinate to index!");
-    SCAI_ASSERT(Y >= 0, "X=" << X << " Y=" << Y << " Z=" << Z << " Could not map from coordinate to index!");
-    SCAI_ASSERT(Z >= 0, "X=" << X << " Y=" << Y << " Z=" << Z << " Could not map from coordinate to index!");
-
-    IndexType layer;
-
-    for (layer = 0; layer < numLayers; layer++) {
-        if ((Y <= layerEnd[layer]) && (Y >= layerStart[layer])) {
-            Y -= layerStart[layer];
-            break;
-        }
-    }
+    SCAI_ASSERT((X >= 0) && (X < NX) && (Z >= 0) && (Z < NZ) && (layer >= 0), "X=" << X << " Y=" << Y << " Z=" << Z << " NX=" << NX << " NY=" << NY << " NZ=" << NZ << " Could not map from coordinate to index!");
 
-    IndexType index = (X / dhFactor[layer]) + (Z / dhFactor[layer]) * varNX[layer] + (Y / dhFactor[layer]) * varNX[layer] * varNZ[layer];
-
-    for (IndexType l = 1; l <= layer; l++) {
-        index += nGridpointsPerLayer[l - 1];
-    }
-
-    return (index);
+    return (layerOffset[layer] + (X / dhFactor[layer]) + (Z / dhFactor[layer]) * varNX[layer] + ((Y - layerStart[layer]) / dhFactor[layer]) * nGridpointsXZ[layer]);
 }
 
 /* ---------- */
@@ -723,6 +781,72 @@ IndexType KITGPI::Acquisition::Coordinates<ValueType>::coordinate2index(coordina
     return (map3Dcoordinate2index(coordinate.x, coordinate.y, coordinate.z));
 }
 
+/*! \brief Convert an array of 1-D indices to 3-D coordinates
+ *
+ * For consecutive indices inside a layer (e.g. the owned indices of a block distribution) the next coordinate is found by incrementing the previous one without divisions.
+ \param indexes 1-D indices
+ \return 3-D coordinates of the indices
+ */
+template <typename ValueType>
+std::vector<KITGPI::Acquisition::coordinate3D> KITGPI::Acquisition::Coordinates<ValueType>::index2coordinate(hmemo::HArray<IndexType> const &indexes) const
+{
+    std::vector<coordinate3D> coordinates(indexes.size());
+
+    IndexType layer = 0;
+    IndexType previousIndex = -2;
+    coordinate3D local; // coordinate in the grid of the layer
+    local.x = 0;
+    local.y = 0;
+    local.z = 0;
+
+    IndexType i = 0;
+    for (IndexType index : hmemo::hostReadAccess(indexes)) {
+        if ((index == previousIndex + 1) && (index < layerOffset[layer + 1])) {
+            local.x++;
+            if (local.x == varNX[layer]) {
+                local.x = 0;
+                local.z++;
+                if (local.z == varNZ[layer]) {
+                    local.z = 0;
+                    local.y++;
+                }
+            }
+        } else {
+            layer = getLayerOfIndex(index);
+            IndexType localIndex = index - layerOffset[layer];
+            local.y = localIndex / nGridpointsXZ[layer];
+            localIndex -= local.y * nGridpointsXZ[layer];
+            local.z = localIndex / varNX[layer];
+            local.x = localIndex - local.z * varNX[layer];
+        }
+        coordinates[i].x = local.x * dhFactor[layer];
+        coordinates[i].y = local.y * dhFactor[layer] + layerStart[layer];
+        coordinates[i].z = local.z * dhFactor[layer];
+        previousIndex = index;
+        i++;
+    }
+
+    return (coordinates);
+}
+
+/*! \brief Convert an array of 3-D coordinates to 1-D indices
+ *
+ \param coordinates 3-D coordinates
+ \return 1-D indices of the coordinates
+ */
+template <typename ValueType>
+hmemo::HArray<IndexType> KITGPI::Acquisition::Coordinates<ValueType>::coordinate2index(std::vector<coordinate3D> const &coordinates) const
+{
+    hmemo::HArray<IndexType> indexes(coordinates.size());
+    {
+        auto write_indexes = hmemo::hostWriteAccess(indexes);
+        for (size_t i = 0; i < coordinates.size(); i++) {
+            write_indexes[i] = map3Dcoordinate2index(coordinates[i].x, coordinates[i].y, coordinates[i].z);
+        }
+    }
+    return (indexes);
+}
+
 /*! \brief Calculation of distance to boundaries of the modelling domain
  *
  * This method calculates the distance of a given coordinate to the boundaries of the modelling domain.
@@ -760,5 +884,87 @@ KITGPI::Acquisition::coordinate3D KITGPI::Acquisition::Coordinates<ValueType>::e
     return (estimateDistanceToEdges3D(coordinate.x, coordinate.y, coordinate.z));
 }
 
+/*! \brief Count gridpoints by conditions on their position without walking all gridpoints
+ *
+ * The gridpoints are counted per xz plane: conditionX(edgeDistanceX, layer) and conditionZ(edgeDistanceZ, layer) are evaluated once per x and z coordinate of the layer,
+ * then countPlane(y, layer, countX, countZ, numX, numZ) returns the number of counted gridpoints of the plane at y, where countX and countZ are the numbers of x and z coordinates
+ * of the plane which fulfil the conditions and numX and numZ the numbers of x and z coordinates of the plane. layer is the layer of the plane as given by getLayer.
+ * The effort is proportional to NX + NY + NZ per layer instead of the number of gridpoints, the result is the same on all processes.
+ \param conditionX condition on the edge distance in x direction (in gridpoints of the finest grid)
+ \param conditionZ condition on the edge distance in z direction (in gridpoints of the finest grid)
+ \param countPlane number of counted gridpoints of a plane
+ \return number of counted gridpoints of the model
+ */
+template <typename ValueType>
+IndexType KITGPI::Acquisition::Coordinates<ValueType>::countGridpoints(std::function<bool(IndexType, IndexType)> const &conditionX, std::function<bool(IndexType, IndexType)> const &conditionZ, std::function<IndexType(IndexType, IndexType, IndexType, IndexType, IndexType, IndexType)> const &countPlane) const
+{
+    // number of x and z coordinates of the grid of a layer which fulfil the conditions for the layer of a plane
+    auto countXZ = [&](IndexType layer, IndexType planeLayer, IndexType &countX, IndexType &countZ) {
+        countX = 0;
+        for (IndexType i = 0; i < varNX[layer]; i++) {
+            IndexType X = i * dhFactor[layer];
+            countX += conditionX(std::min(X, NX - 1 - X), planeLayer);
+        }
+        countZ = 0;
+        for (IndexType i = 0; i < varNZ[layer]; i++) {
+            IndexType Z = i * dhFactor[layer];
+            countZ += conditionZ(std::min(Z, NZ - 1 - Z), planeLayer);
+        }
+    };
+
+    IndexType count = 0;
+    for (IndexType layer = 0; layer < numLayers; layer++) {
+        IndexType countX = 0;
+        IndexType countZ = 0;
+        countXZ(layer, layer, countX, countZ);
+
+        for (IndexType i = 0; i < varNY[layer]; i++) {
+            coordinate3D coordinate;
+            coordinate.x = 0;
+            coordinate.y = layerStart[layer] + i * dhFactor[layer];
+            coordinate.z = 0;
+            IndexType planeLayer = getLayer(coordinate);
+            if (planeLayer != layer) {
+                // gridpoints on an interface are stored in the grid of the fine layer, but belong to the coarse layer
+                IndexType planeCountX = 0;
+                IndexType planeCountZ = 0;
+                countXZ(layer, planeLayer, planeCountX, planeCountZ);
+                count += countPlane(coordinate.y, planeLayer, planeCountX, planeCountZ, varNX[layer], varNZ[layer]);
+            } else {
+                count += countPlane(coordinate.y, layer, countX, countZ, varNX[layer], varNZ[layer]);
+            }
+        }
+    }
+    return (count);
+}
+
+/*! \brief Index ranges of the gridpoints with the same layer
+ *
+ * The layer (see getLayer) only depends on the y coordinate, so the gridpoints of a layer are stored in a few ranges of consecutive indices.
+ * The gridpoints rangeStart[i] to rangeStart[i + 1] - 1 belong to the layer rangeLayer[i]. On a regular grid there is a single range.
+ \param rangeStart first index of every range and the total number of gridpoints (number of ranges + 1 entries)
+ \param rangeLayer layer of every range
+ */
+template <typename ValueType>
+void KITGPI::Acquisition::Coordinates<ValueType>::getLayerRanges(std::vector<IndexType> &rangeStart, std::vector<IndexType> &rangeLayer) const
+{
+    rangeStart.clear();
+    rangeLayer.clear();
+    for (IndexType layer = 0; layer < numLayers; layer++) {
+        for (IndexType i = 0; i < varNY[layer]; i++) {
+            coordinate3D coordinate;
+            coordinate.x = 0;
+            coordinate.y = layerStart[layer] + i * dhFactor[layer];
+            coordinate.z = 0;
+            IndexType planeLayer = getLayer(coordinate);
+            if (rangeLayer.empty() || rangeLayer.back() != planeLayer) {
+                rangeStart.push_back(layerOffset[layer] + i * nGridpointsXZ[layer]);
+                rangeLayer.push_back(planeLayer);
+            }
+        }
+    }
+    rangeStart.push_back(nGridpoints);
+}
+
 template class KITGPI::Acquisition::Coordinates<float>;
 template class KITGPI::Acquisition::Coordinates<double>;
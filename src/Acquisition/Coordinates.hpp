@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Configuration/Configuration.hpp"
+#include <functional>
 #include <scai/lama.hpp>
 
 using namespace scai;
@@ -98,11 +99,19 @@ namespace KITGPI
             IndexType coordinate2index(coordinate3D coordinate) const;
             IndexType coordinate2index(IndexType X, IndexType Y, IndexType Z) const;
 
+            // Batched conversions of index arrays
+            std::vector<coordinate3D> index2coordinate(scai::hmemo::HArray<IndexType> const &indexes) const;
+            scai::hmemo::HArray<IndexType> coordinate2index(std::vector<coordinate3D> const &coordinates) const;
+
             // Index --> Coordinate:
             coordinate3D index2coordinate(IndexType index) const;
 
             coordinate3D edgeDistance(coordinate3D coordinate) const;
 
+            IndexType countGridpoints(std::function<bool(IndexType, IndexType)> const &conditionX, std::function<bool(IndexType, IndexType)> const &conditionZ, std::function<IndexType(IndexType, IndexType, IndexType, IndexType, IndexType, IndexType)> const &countPlane) const;
+
+            void getLayerRanges(std::vector<IndexType> &rangeStart, std::vector<IndexType> &rangeLayer) const;
+
             bool locatedOnSurface(IndexType index) const;
 
             IndexType distToInterface(IndexType Y) const;
@@ -139,14 +148,24 @@ namespace KITGPI
             IndexType nGridpoints;                      //!< total number of gridpoints
             std::vector<IndexType> nGridpointsPerLayer; //!< number of gridpoints per layer
 
+            std::vector<IndexType> layerOffset;        //!< index of the first gridpoint of each layer (prefix sum of nGridpointsPerLayer, numLayers + 1 entries)
+            std::vector<IndexType> nGridpointsXZ;      //!< number of gridpoints of an xz plane per layer
+            std::vector<IndexType> mapLayerOfY;        //!< layer which contains the gridpoints at each y coordinate (-1 between the grids of two layers)
+            std::vector<IndexType> layerOfY;           //!< layer of each y coordinate (see getLayer)
+            std::vector<IndexType> distToInterfaceOfY; //!< distance of each y coordinate to the next interface
+            std::vector<int> transitionOfY;            //!< transition at each y coordinate (0 if not located on an interface)
+            std::vector<char> onInterfaceOfY;          //!< 1 if the y coordinate is located on an interface
+
             void init();
             void init(std::vector<IndexType> &dhFactor, std::vector<int> &interface);
+            void initTables();
 
             // Coordinate --> Index:
             IndexType map3Dcoordinate2index(IndexType X, IndexType Y, IndexType Z) const;
 
             // Index --> Coordinate:
             coordinate3D mapIndex2coordinate(IndexType index) const;
+            IndexType getLayerOfIndex(IndexType index) const;
 
             coordinate3D estimateDistanceToEdges3D(IndexType X, IndexType Y, IndexType Z) const;
 
@@ -1,4 +1,5 @@
 #include "Seismogram.hpp"
+#include "../IO/ChunkedIO.hpp"
 #include "../IO/IO.hpp"
 #include "../IO/SUIO.hpp"
 
@@ -77,10 +78,17 @@ void KITGPI::Acquisition::Seismogram<ValueType>::setContextPtr(scai::hmemo::Cont
  \param filename base filename of the seismogram
  \param modelCoordinates Coordinate class, which eg. maps 3D coordinates to 1D model indices
  \param seismogramFormat =1 MTX: MatrixMaker format, =4 SU: SeismicUnix format
+ \param outputFilenames Names of the written files including suffix are appended (optional)
  */
 template <typename ValueType>
-void KITGPI::Acquisition::Seismogram<ValueType>::write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates)
+void KITGPI::Acquisition::Seismogram<ValueType>::write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates, std::vector<std::string> *outputFilenames)
 {
+    auto addOutputFilename = [outputFilenames](std::string const &name, scai::IndexType format) {
+        if (outputFilenames != nullptr) {
+            outputFilenames->push_back(name + (format == 4 ? ".su" : IO::getFileSuffix(format)));
+        }
+    };
+
     bool writedata = true;
     if (data.getNumValues() > 0 && data.getNumRows() == 1 && dataCOP.getNumRows() > 1) {
         scai::lama::DenseVector<ValueType> tempRow;
@@ -107,8 +115,10 @@ void KITGPI::Acquisition::Seismogram<ValueType>::write(scai::IndexType const sei
         
         if (seismogramFormat != 5) {
             dataResample = data * resampleMat;
-            if (refTraces.maxNorm() != 0)
-            IO::writeMatrix(refTraces, filenameTmp + ".refTraces", seismoFormat);
+            if (refTraces.maxNorm() != 0) {
+                IO::writeMatrix(refTraces, filenameTmp + ".refTraces", seismoFormat);
+                addOutputFilename(filenameTmp + ".refTraces", seismoFormat);
+            }
         } else {
             seismoFormat = 1;
             dataResample = inverseAGC * resampleMat;
@@ -123,6 +133,7 @@ void KITGPI::Acquisition::Seismogram<ValueType>::write(scai::IndexType const sei
             IO::writeMatrix(dataResample, filenameTmp, seismoFormat);
             break;
         }
+        addOutputFilename(filenameTmp, seismoFormat);
         
         if (outputInstantaneous != 0 && seismogramFormat != 5) {
             if (outputInstantaneous == 1) {
@@ -142,6 +153,7 @@ void KITGPI::Acquisition::Seismogram<ValueType>::write(scai::IndexType const sei
                 IO::writeMatrix(dataResample, filenameTmp, seismoFormat);
                 break;
             }
+            addOutputFilename(filenameTmp, seismoFormat);
         }
     }
 }
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <scai/dmemo.hpp>
 #include <scai/lama.hpp>
 
@@ -37,7 +38,7 @@ namespace KITGPI
             Seismogram(const Seismogram &rhs);
 
             void swap(KITGPI::Acquisition::Seismogram<ValueType> &rhs);
-            void write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates);
+            void write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates, std::vector<std::string> *outputFilenames = nullptr);
             void read(scai::IndexType const seismogramFormat, std::string const &filename, bool readOriginal = 0);
             //void read(scai::IndexType const SeismogramFormat, std::string const &filename, scai::dmemo::DistributionPtr distTraces, scai::dmemo::DistributionPtr distSamples);
 
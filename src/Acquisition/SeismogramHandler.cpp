@@ -11,12 +11,13 @@ using namespace scai;
  \param seismogramFormat =1 MTX: MatrixMaker format, =4 SU: SeismicUnix format
  \param filename base filename of the seismogram
  \param modelCoordinates Coordinate class, which eg. maps 3D coordinates to 1D model indices
+ \param outputFilenames Names of the written files are appended, e.g. to record them in the shot manifest (optional)
  */
 template <typename ValueType>
-void KITGPI::Acquisition::SeismogramHandler<ValueType>::write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates)
+void KITGPI::Acquisition::SeismogramHandler<ValueType>::write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates, std::vector<std::string> *outputFilenames)
 {
     for (auto &i : seismo) {
-        i.write(seismogramFormat, filename, modelCoordinates);
+        i.write(seismogramFormat, filename, modelCoordinates, outputFilenames);
     }
 }
 
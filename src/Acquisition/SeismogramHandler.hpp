@@ -26,7 +26,7 @@ namespace KITGPI
             ~SeismogramHandler(){};
 
             void read(scai::IndexType const seismogramFormat, std::string const &filename, bool readOriginal = 0);
-            void write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates);
+            void write(scai::IndexType const seismogramFormat, std::string const &filename, Coordinates<ValueType> const &modelCoordinates, std::vector<std::string> *outputFilenames = nullptr);
             void normalize(scai::IndexType normalizeTraces);
             void integrate();
             void differentiate();
@@ -6,6 +6,11 @@
 #include "../Configuration/Configuration.hpp"
 #include "../Modelparameter/Modelparameter.hpp"
 #include <scai/lama.hpp>
+#include <scai/tracing.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace KITGPI
 {
@@ -160,66 +165,163 @@ namespace KITGPI
             }
         }
 
-        //! \brief Wrapper Function who calls checkStabilityCriterion and checkNumericalDispersion
+        //! \brief Minimum and maximum velocity of a model per layer of the variable grid
         template <typename ValueType>
-        void checkNumericalArtefactsAndInstabilities(Configuration::Configuration const &config, std::vector<Acquisition::sourceSettings<ValueType>> sourceSettings, Modelparameter::Modelparameter<ValueType> &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::IndexType shotNumber = -1)
-        {
-            if (!config.get<bool>("initSourcesFromSU")) {
-                /* identify seismic and EM wave */
-                std::string equationType = config.get<std::string>("equationType");
-                bool isSeismic = Common::checkEquationType<ValueType>(equationType);
-                
-                scai::dmemo::DistributionPtr dist;
-                scai::IndexType numlayer = modelCoordinates.getNumLayers();
+        struct VelocityRange {
+            std::vector<ValueType> vMin; //!< minimum velocity (> 0) per layer (S-wave velocity, P-wave velocity for acoustic modelling)
+            std::vector<ValueType> vMax; //!< maximum velocity per layer (P-wave velocity, S-wave velocity for sh modelling)
+            bool valid = false;          //!< ==true if vMin and vMax are computed; has to be reset if the model changes
+        };
 
-                ValueType vMax[numlayer] = {0};
-                ValueType vMin[numlayer] = {0};
-                std::fill_n(vMin, numlayer, 3e8);
+        /*! \brief Local values of a vector without a copy for dense vectors
+        *
+        \param vector vector
+        \param buffer local values if the vector is not dense
+        */
+        template <typename ValueType>
+        scai::hmemo::HArray<ValueType> const &getLocalValues(scai::lama::Vector<ValueType> const &vector, scai::hmemo::HArray<ValueType> &buffer)
+        {
+            auto denseVector = dynamic_cast<scai::lama::DenseVector<ValueType> const *>(&vector);
+            if (denseVector != nullptr) {
+                return (denseVector->getLocalValues());
+            }
+            vector.buildLocalValues(buffer);
+            return (buffer);
+        }
 
-                scai::IndexType localIndex = 0;
+        /*! \brief Compute the minimum and maximum velocity of a model per layer
+        *
+        * The local values are reduced in runs of gridpoints with the same layer (see Coordinates::getLayerRanges), so no coordinate is computed per gridpoint.
+        * For elastic and viscoelastic modelling vp/vs >= sqrt(2) is checked.
+        \param velocityRange result
+        \param equationType equation type
+        \param model model
+        \param modelCoordinates coordinates of the model
+        */
+        template <typename ValueType>
+        void calcVelocityRange(VelocityRange<ValueType> &velocityRange, std::string const &equationType, Modelparameter::Modelparameter<ValueType> &model, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            SCAI_REGION("CheckParameter.calcVelocityRange")
+
+            bool isSeismic = Common::checkEquationType<ValueType>(equationType);
+            bool checkRatio = (equationType.compare("elastic") == 0) || (equationType.compare("viscoelastic") == 0);
+            scai::IndexType numlayer = modelCoordinates.getNumLayers();
+
+            scai::dmemo::DistributionPtr dist;
+            scai::lama::Vector<ValueType> const *vMaxVector;
+            scai::lama::Vector<ValueType> const *vMinVector;
+            if (isSeismic) {
+                dist = model.getDensity().getDistributionPtr();
+                vMaxVector = (equationType.compare("sh") == 0 || equationType.compare("viscosh") == 0) ? &model.getVelocityS() : &model.getVelocityP();
+                vMinVector = (equationType.compare("acoustic") == 0) ? &model.getVelocityP() : &model.getVelocityS();
+            } else {
+                dist = model.getMagneticPermeability().getDistributionPtr();
+                vMaxVector = &model.getVelocityEM();
+                vMinVector = vMaxVector;
+            }
 
-                scai::lama::DenseVector<ValueType> vMaxTmp;
-                scai::lama::DenseVector<ValueType> vMinTmp;
-                if (isSeismic) {
-                    dist = model.getDensity().getDistributionPtr();
-                    vMaxTmp = (config.get<std::string>("equationType").compare("sh") == 0 || config.get<std::string>("equationType").compare("viscosh") == 0) ? model.getVelocityS() : model.getVelocityP();
-                    vMinTmp = (config.get<std::string>("equationType").compare("acoustic") == 0) ? model.getVelocityP() : model.getVelocityS();
-                } else {
-                    dist = model.getMagneticPermeability().getDistributionPtr();
-                    vMaxTmp = model.getVelocityEM();
-                    vMinTmp = vMaxTmp;
+            scai::hmemo::HArray<ValueType> vMaxBuffer;
+            scai::hmemo::HArray<ValueType> vMinBuffer;
+            auto read_vMax = scai::hmemo::hostReadAccess(getLocalValues(*vMaxVector, vMaxBuffer));
+            auto read_vMin = scai::hmemo::hostReadAccess(getLocalValues(*vMinVector, vMinBuffer));
+            ValueType const *vMaxLocal = read_vMax.get();
+            ValueType const *vMinLocal = read_vMin.get();
+
+            std::vector<ValueType> vMax(numlayer, 0);
+            std::vector<ValueType> vMin(numlayer, 3e8);
+
+            // reduction of the local values localStart to localEnd - 1 which belong to one layer
+            auto reduce = [&](scai::IndexType localStart, scai::IndexType localEnd, scai::IndexType layer) {
+                ValueType vMaxLayer = vMax[layer];
+                ValueType vMinLayer = vMin[layer];
+                for (scai::IndexType localIndex = localStart; localIndex < localEnd; localIndex++) {
+                    vMaxLayer = std::max(vMaxLayer, vMaxLocal[localIndex]);
+                    ValueType value = vMinLocal[localIndex];
+                    vMinLayer = (value > 0 && value < vMinLayer) ? value : vMinLayer;
                 }
-                
-                auto commShot = dist->getCommunicatorPtr();
-                scai::hmemo::HArray<scai::IndexType> ownedIndexes; // all (global) points owned by this process
+                vMax[layer] = vMaxLayer;
+                vMin[layer] = vMinLayer;
+            };
+
+            scai::IndexType numLocal = dist->getLocalSize();
+            scai::hmemo::HArray<scai::IndexType> ownedIndexes; // all (global) points owned by this process
+            std::vector<scai::IndexType> rangeStart;
+            std::vector<scai::IndexType> rangeLayer;
+            modelCoordinates.getLayerRanges(rangeStart, rangeLayer);
+
+            if (rangeLayer.size() == 1) {
+                reduce(0, numLocal, rangeLayer[0]);
+            } else {
                 dist->getOwnedIndexes(ownedIndexes);
-                
-                auto read_vMaxTmp = scai::hmemo::hostReadAccess(vMaxTmp.getLocalValues());
-                auto read_vMinTmp = scai::hmemo::hostReadAccess(vMinTmp.getLocalValues());
+                auto read_ownedIndexes = scai::hmemo::hostReadAccess(ownedIndexes);
+                scai::IndexType localIndex = 0;
+                while (localIndex < numLocal) {
+                    scai::IndexType ownedIndex = read_ownedIndexes[localIndex];
+                    scai::IndexType range = std::upper_bound(rangeStart.begin(), rangeStart.end(), ownedIndex) - rangeStart.begin() - 1;
+                    scai::IndexType localEnd = localIndex + 1;
+                    while (localEnd < numLocal && read_ownedIndexes[localEnd] >= rangeStart[range] && read_ownedIndexes[localEnd] < rangeStart[range + 1]) {
+                        localEnd++;
+                    }
+                    reduce(localIndex, localEnd, rangeLayer[range]);
+                    localIndex = localEnd;
+                }
+            }
 
-                for (scai::IndexType ownedIndex : scai::hmemo::hostReadAccess(ownedIndexes)) {
+            if (checkRatio) {
+                // vp/vs = sqrt((lambda+2*mu)/mu) >= sqrt(2.0)
+                scai::IndexType firstInvalid = numLocal;
+                for (scai::IndexType localIndex = 0; localIndex < numLocal; localIndex++) {
+                    if (!(vMaxLocal[localIndex] / vMinLocal[localIndex] >= sqrt(2.0))) {
+                        firstInvalid = localIndex;
+                        break;
+                    }
+                }
+                if (firstInvalid < numLocal) {
+                    Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(dist->local2Global(firstInvalid));
+                    SCAI_ASSERT_ERROR(false, "\n vp/vs (" << vMaxLocal[firstInvalid] << "/" << vMinLocal[firstInvalid] << ") < sqrt(2.0) at X,Y,Z =" << coordinate.x << "," << coordinate.y << "," << coordinate.z << "\n\n");
+                }
+            }
 
-                    Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
-                    auto layer = modelCoordinates.getLayer(coordinate);
+            // communicate vMin and vMax and find the minimu and maximum of all processes
+            auto commShot = dist->getCommunicatorPtr();
+            commShot->minImpl(vMin.data(), vMin.data(), numlayer, scai::common::TypeTraits<ValueType>::stype);
+            commShot->maxImpl(vMax.data(), vMax.data(), numlayer, scai::common::TypeTraits<ValueType>::stype);
 
-                    if ((config.get<std::string>("equationType").compare("elastic") == 0) || (config.get<std::string>("equationType").compare("viscoelastic") == 0)) {
-                        SCAI_ASSERT_ERROR(read_vMaxTmp[localIndex] / read_vMinTmp[localIndex] >= sqrt(2.0), "\n vp/vs (" << read_vMaxTmp[localIndex] << "/" << read_vMinTmp[localIndex] << ") < sqrt(2.0) at X,Y,Z =" << coordinate.x << "," << coordinate.y << "," << coordinate.z << "\n\n");
-                        // vp/vs = sqrt((lambda+2*mu)/mu) >= sqrt(2.0)
-                    }
-                    if (read_vMaxTmp[localIndex] > vMax[layer]) {
-                        vMax[layer] = read_vMaxTmp[localIndex];
-                    }
+            velocityRange.vMin = vMin;
+            velocityRange.vMax = vMax;
+            velocityRange.valid = true;
+        }
 
-                    if ((read_vMinTmp[localIndex] < vMin[layer]) && (read_vMinTmp[localIndex] > 0.0)) {
-                        vMin[layer] = read_vMinTmp[localIndex];
-                    }
+        /*! \brief Wrapper Function who calls checkStabilityCriterion and checkNumericalDispersion
+        *
+        * The velocity range of the model is computed once per model if velocityRange is given: it is reused for all shots until velocityRange.valid is reset,
+        * which is required if the model changes.
+        \param config configuration
+        \param sourceSettings sources of the shot
+        \param model model
+        \param modelCoordinates coordinates of the model
+        \param shotNumber shot number for the messages
+        \param velocityRange cached velocity range of the model (nullptr = compute for every call)
+        */
+        template <typename ValueType>
+        void checkNumericalArtefactsAndInstabilities(Configuration::Configuration const &config, std::vector<Acquisition::sourceSettings<ValueType>> const &sourceSettings, Modelparameter::Modelparameter<ValueType> &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::IndexType shotNumber = -1, VelocityRange<ValueType> *velocityRange = nullptr)
+        {
+            if (!config.get<bool>("initSourcesFromSU")) {
+                std::string equationType = config.get<std::string>("equationType");
+                std::string dimension = config.get<std::string>("dimension");
+                ValueType DT = config.get<ValueType>("DT");
+                bool useVariableGrid = config.get<bool>("useVariableGrid");
+                scai::IndexType numlayer = modelCoordinates.getNumLayers();
 
-                    localIndex++;
+                VelocityRange<ValueType> localVelocityRange;
+                if (velocityRange == nullptr) {
+                    velocityRange = &localVelocityRange;
+                }
+                if (!velocityRange->valid) {
+                    calcVelocityRange(*velocityRange, equationType, model, modelCoordinates);
                 }
 
-                // communicate vMin and vMax and find the minimu and maximum of all processes
-                commShot->minImpl(vMin, vMin, numlayer, scai::common::TypeTraits<ValueType>::stype);
-                commShot->maxImpl(vMax, vMax, numlayer, scai::common::TypeTraits<ValueType>::stype);
+                auto commShot = Common::checkEquationType<ValueType>(equationType) ? model.getDensity().getDistributionPtr()->getCommunicatorPtr() : model.getMagneticPermeability().getDistributionPtr()->getCommunicatorPtr();
 
                 ValueType fcMax = 0;
                 for (unsigned i = 0; i < sourceSettings.size(); i++) {
@@ -238,12 +340,12 @@ namespace KITGPI
                 }
 
                 for (scai::IndexType layer = 0; layer < numlayer; layer++) {
-                    if (config.get<bool>("useVariableGrid")) {
-                        checkStabilityCriterion<ValueType>(config.get<ValueType>("DT"), modelCoordinates.getDH(layer), vMax[layer], config.get<std::string>("dimension"), spatialFDorderVec[layer], commShot, shotNumber, layer);
-                        checkNumericalDispersion<ValueType>(modelCoordinates.getDH(layer), vMin[layer], fcMax, spatialFDorderVec[layer], commShot, shotNumber, layer);
+                    if (useVariableGrid) {
+                        checkStabilityCriterion<ValueType>(DT, modelCoordinates.getDH(layer), velocityRange->vMax[layer], dimension, spatialFDorderVec[layer], commShot, shotNumber, layer);
+                        checkNumericalDispersion<ValueType>(modelCoordinates.getDH(layer), velocityRange->vMin[layer], fcMax, spatialFDorderVec[layer], commShot, shotNumber, layer);
                     } else {
-                        checkStabilityCriterion<ValueType>(config.get<ValueType>("DT"), modelCoordinates.getDH(layer), vMax[layer], config.get<std::string>("dimension"), spatialFDorderVec[layer], commShot, shotNumber);
-                        checkNumericalDispersion<ValueType>(modelCoordinates.getDH(layer), vMin[layer], fcMax, spatialFDorderVec[layer], commShot, shotNumber);
+                        checkStabilityCriterion<ValueType>(DT, modelCoordinates.getDH(layer), velocityRange->vMax[layer], dimension, spatialFDorderVec[layer], commShot, shotNumber);
+                        checkNumericalDispersion<ValueType>(modelCoordinates.getDH(layer), velocityRange->vMin[layer], fcMax, spatialFDorderVec[layer], commShot, shotNumber);
                     }
                 }
             }
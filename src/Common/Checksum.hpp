@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace KITGPI
+{
+    namespace Common
+    {
+
+        /*! \brief FNV-1a checksum which can be computed block by block
+         *
+         * Unlike std::hash the checksum does not depend on the compiler or the build, so it can be stored in files or used in filenames,
+         * e.g. by the shot manifest and the partition cache.
+         */
+        class Checksum
+        {
+          public:
+            //! \brief Add data to the checksum
+            void add(char const *data, std::size_t size)
+            {
+                for (std::size_t i = 0; i < size; i++) {
+                    hash ^= static_cast<unsigned char>(data[i]);
+                    hash *= 1099511628211ULL;
+                }
+            }
+
+            //! \brief Add a string to the checksum
+            void add(std::string const &data) { add(data.data(), data.size()); }
+
+            //! \brief Return the checksum of the added data
+            unsigned long long get() const { return hash; }
+
+            //! \brief Checksum of a string
+            static unsigned long long of(std::string const &data)
+            {
+                Checksum checksum;
+                checksum.add(data);
+                return checksum.get();
+            }
+
+            /*! \brief Checksum and size of a file
+             *
+             * The file is read in blocks of fixed size, so large files are never copied into memory.
+             \param filename Name of the file
+             \param checksum Checksum of the content
+             \param size Size of the file in bytes
+             \return false if the file cannot be read
+             */
+            static bool ofFile(std::string const &filename, unsigned long long &checksum, unsigned long long &size)
+            {
+                std::ifstream file(filename, std::ios::binary);
+                if (!file.good()) {
+                    return false;
+                }
+                Checksum fileChecksum;
+                std::vector<char> block(blockSize);
+                size = 0;
+                while (file.read(block.data(), blockSize) || file.gcount() > 0) {
+                    fileChecksum.add(block.data(), file.gcount());
+                    size += file.gcount();
+                }
+                if (file.bad()) {
+                    return false;
+                }
+                checksum = fileChecksum.get();
+                return true;
+            }
+
+          private:
+            static constexpr std::size_t blockSize = 1 << 20; //!< size of the blocks in which files are read
+
+            unsigned long long hash = 14695981039346656037ULL; //!< FNV-1a offset basis
+        };
+    }
+}
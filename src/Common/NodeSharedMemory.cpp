@@ -0,0 +1,114 @@
+#include "NodeSharedMemory.hpp"
+#include "HostPrint.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace scai;
+
+/*! \brief Initialize the node communicator
+ *
+ * Has to be called by all processes.
+ \param commAll Communicator of all processes
+ */
+void KITGPI::Common::NodeSharedMemory::init(dmemo::CommunicatorPtr commAll)
+{
+    commNode = commAll->split(commAll->getNodeId());
+
+    // the pid of the node master makes the segment names unique on the node
+    IndexType pid = getpid();
+    commNode->bcast(&pid, 1, MASTERGPI);
+    segmentPrefix = "/wave_simulation_" + std::to_string(pid) + "_";
+    numSegments = 0;
+
+    HOST_PRINT(commAll, "", "Node shared memory: " << commNode->getSize() << " processes on the node of the master\n");
+}
+
+//! \brief Return true if init() has been called
+bool KITGPI::Common::NodeSharedMemory::isActive() const
+{
+    return (commNode != nullptr);
+}
+
+/*! \brief Publish the data of the node master in a shared memory segment
+ *
+ * Has to be called by all processes of the node with the same number of bytes. The data of the node master is shared, the data of the other processes is ignored.
+ * The segment is unlinked as soon as all processes have mapped it, so it is released by the operating system when the last mapping is destroyed.
+ \param data Data which is shared
+ \param numBytes Size of the data
+ \return read-only mapping of the segment, nullptr if the node is not shared or the data is empty
+ */
+std::shared_ptr<void const> KITGPI::Common::NodeSharedMemory::share(void const *data, std::size_t numBytes)
+{
+    if (!isActive() || commNode->getSize() == 1) {
+        return (nullptr);
+    }
+    double bytes = numBytes;
+    SCAI_ASSERT_ERROR(commNode->min(bytes) == commNode->max(bytes), "Node shared data differs in size between the processes of a node");
+    if (numBytes == 0) {
+        return (nullptr);
+    }
+
+    std::string name = segmentPrefix + std::to_string(numSegments++);
+    bool isNodeMaster = (commNode->getRank() == MASTERGPI);
+
+    // the node master reports failures to the node before anyone asserts, otherwise the other processes wait forever in the next collective call
+    IndexType created = 1;
+    std::string error;
+    if (isNodeMaster) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        void *segment = MAP_FAILED;
+        if (fd < 0) {
+            error = "Could not create shared memory segment " + name + ": " + std::strerror(errno);
+        } else if (ftruncate(fd, numBytes) != 0) {
+            error = "Could not resize shared memory segment " + name + ": " + std::strerror(errno);
+        } else {
+            segment = mmap(nullptr, numBytes, PROT_WRITE, MAP_SHARED, fd, 0);
+            if (segment == MAP_FAILED) {
+                error = "Could not map shared memory segment " + name + ": " + std::strerror(errno);
+            }
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        if (segment != MAP_FAILED) {
+            std::memcpy(segment, data, numBytes);
+            munmap(segment, numBytes);
+        } else {
+            created = 0;
+            if (fd >= 0) {
+                shm_unlink(name.c_str());
+            }
+        }
+    }
+    commNode->bcast(&created, 1, MASTERGPI);
+    SCAI_ASSERT_ERROR(created == 1, "Node master could not publish shared memory segment " << name << (error.empty() ? "" : ": " + error));
+
+    void *segment = MAP_FAILED;
+    int fd = shm_open(name.c_str(), O_RDONLY, 0600);
+    if (fd < 0) {
+        error = "Could not open shared memory segment " + name + ": " + std::strerror(errno);
+    } else {
+        segment = mmap(nullptr, numBytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (segment == MAP_FAILED) {
+            error = "Could not map shared memory segment " + name + ": " + std::strerror(errno);
+        }
+        close(fd);
+    }
+    IndexType mapped = (segment != MAP_FAILED) ? 1 : 0;
+    mapped = commNode->min(mapped);
+
+    if (isNodeMaster) {
+        shm_unlink(name.c_str());
+    }
+    if (mapped == 0 && segment != MAP_FAILED) {
+        munmap(segment, numBytes);
+    }
+    SCAI_ASSERT_ERROR(mapped == 1, "Shared memory segment " << name << " could not be mapped by all processes of the node" << (error.empty() ? "" : ": " + error));
+
+    return (std::shared_ptr<void const>(segment, [numBytes](void const *segment) { munmap(const_cast<void *>(segment), numBytes); }));
+}
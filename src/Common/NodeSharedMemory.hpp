@@ -0,0 +1,99 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+
+#include "../Configuration/Configuration.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace scai;
+namespace KITGPI
+{
+    namespace Common
+    {
+
+        /*! \brief Read-only memory which is shared by all processes of a node
+         *
+         * The processes of a node are grouped by a node communicator (the equivalent of MPI_Comm_split_type with MPI_COMM_TYPE_SHARED).
+         * The master of the node publishes its data in a POSIX shared memory segment, all other processes of the node map the same segment read-only.
+         * This is used for per-model data which is identical in all shot domains (e.g. derivative matrices, model parameters and boundary coefficients),
+         * so it is stored once per node instead of once per shot domain.
+         */
+        class NodeSharedMemory
+        {
+          public:
+            //! \brief Default constructor
+            NodeSharedMemory(){};
+
+            //! \brief Default destructor
+            ~NodeSharedMemory(){};
+
+            void init(dmemo::CommunicatorPtr commAll);
+
+            bool isActive() const;
+
+            std::shared_ptr<void const> share(void const *data, std::size_t numBytes);
+
+          private:
+            dmemo::CommunicatorPtr commNode; //!< communicator of the processes of a node
+            std::string segmentPrefix;       //!< prefix of the names of the shared memory segments, unique per node and run
+            IndexType numSegments = 0;       //!< number of segments created so far
+        };
+
+        /*! \brief Array which can be moved into node shared memory
+         *
+         * The array is filled like a std::vector. After share() the values are stored in node shared memory and the local copy is released.
+         */
+        template <typename T>
+        class NodeSharedArray
+        {
+          public:
+            //! \brief Default constructor
+            NodeSharedArray(){};
+
+            //! \brief Replace the values by a local copy of [first, last)
+            template <typename Iterator>
+            void assign(Iterator first, Iterator last)
+            {
+                local.assign(first, last);
+                values = local.data();
+                numValues = local.size();
+                segment.reset();
+            }
+
+            /*! \brief Move the values into node shared memory
+             *
+             * Has to be called by all processes of the node with identical values.
+             \param nodeSharedMemory Node shared memory
+             */
+            void share(NodeSharedMemory &nodeSharedMemory)
+            {
+                segment = nodeSharedMemory.share(values, numValues * sizeof(T));
+                if (segment) {
+                    values = static_cast<T const *>(segment.get());
+                    std::vector<T>().swap(local);
+                }
+            }
+
+            //! \brief Access to value i
+            T const &operator[](std::size_t i) const { return values[i]; }
+            //! \brief Pointer to the values
+            T const *data() const { return values; }
+            //! \brief Number of values
+            std::size_t size() const { return numValues; }
+            //! \brief Begin of the values
+            T const *begin() const { return values; }
+            //! \brief End of the values
+            T const *end() const { return values + numValues; }
+
+          private:
+            std::vector<T> local;                 //!< local copy of the values
+            T const *values = nullptr;            //!< values (local copy or shared segment)
+            std::size_t numValues = 0;            //!< number of values
+            std::shared_ptr<void const> segment;  //!< mapping of the shared segment
+        };
+    }
+}
@@ -0,0 +1,156 @@
+#include "Profiler.hpp"
+#include "HostPrint.hpp"
+
+#include <scai/common/Walltime.hpp>
+
+#include <fstream>
+#include <sstream>
+
+//! \brief Profiler of the process
+KITGPI::Common::Profiler &KITGPI::Common::Profiler::global()
+{
+    static Profiler profiler;
+    return (profiler);
+}
+
+/*! \brief Add a timed interval to a phase
+ *
+ \param phase Phase
+ \param seconds Runtime in seconds
+ */
+void KITGPI::Common::Profiler::addTime(Phase phase, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    time[static_cast<IndexType>(phase)] += seconds;
+    count[static_cast<IndexType>(phase)]++;
+}
+
+/*! \brief Add bytes read by this process
+ *
+ \param bytes Number of bytes
+ */
+void KITGPI::Common::Profiler::addBytesRead(double bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bytesRead += bytes;
+}
+
+/*! \brief Add bytes written by this process
+ *
+ \param bytes Number of bytes
+ */
+void KITGPI::Common::Profiler::addBytesWritten(double bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bytesWritten += bytes;
+}
+
+/*! \brief Name of a phase in the report
+ *
+ \param phase Phase
+ */
+char const *KITGPI::Common::Profiler::getPhaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::Partitioning:
+        return ("partitioning");
+    case Phase::Derivatives:
+        return ("derivatives");
+    case Phase::Wavefields:
+        return ("wavefields");
+    case Phase::Acquisition:
+        return ("acquisition");
+    case Phase::Model:
+        return ("model");
+    case Phase::ForwardSolverInit:
+        return ("forwardSolverInit");
+    case Phase::ShotSetup:
+        return ("shotSetup");
+    case Phase::TimeLoop:
+        return ("timeLoop");
+    case Phase::Output:
+        return ("output");
+    default:
+        COMMON_THROWEXCEPTION("Unknown phase")
+    }
+}
+
+/*! \brief Write the minimum, average and maximum over all processes as JSON
+ *
+ * Has to be called by all processes of comm. Nothing is written if filename is empty.
+ \param filename Filename of the report
+ \param comm Communicator of all processes
+ \param runtime Total runtime of this process in seconds
+ */
+void KITGPI::Common::Profiler::writeReport(std::string const &filename, dmemo::CommunicatorPtr comm, double runtime) const
+{
+    if (filename.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    IndexType numProcesses = comm->getSize();
+    std::ostringstream report;
+
+    // "name": {"min": ..., "avg": ..., "max": ... of a value over all processes, the object is closed by the caller
+    auto statistics = [&](std::string const &name, double value) {
+        double minValue = comm->min(value);
+        double avgValue = comm->sum(value) / numProcesses;
+        double maxValue = comm->max(value);
+        report << "\"" << name << "\": {\"min\": " << minValue << ", \"avg\": " << avgValue << ", \"max\": " << maxValue;
+    };
+
+    report << "{\n";
+    report << "  \"unit\": {\"time\": \"s\", \"io\": \"bytes\"},\n";
+    report << "  \"numProcesses\": " << numProcesses << ",\n";
+    report << "  ";
+    statistics("runtime", runtime);
+    report << "},\n";
+    report << "  \"phases\": {\n";
+    for (IndexType phase = 0; phase < numPhases; phase++) {
+        report << "    ";
+        statistics(getPhaseName(static_cast<Phase>(phase)), time[phase]);
+        IndexType maxCount = comm->max(count[phase]);
+        report << ", \"count\": " << maxCount << "}" << (phase + 1 < numPhases ? ",\n" : "\n");
+    }
+    report << "  },\n";
+    report << "  ";
+    statistics("bytesRead", bytesRead);
+    double totalRead = comm->sum(bytesRead);
+    report << ", \"total\": " << totalRead << "},\n";
+    report << "  ";
+    statistics("bytesWritten", bytesWritten);
+    double totalWritten = comm->sum(bytesWritten);
+    report << ", \"total\": " << totalWritten << "}\n";
+    report << "}\n";
+
+    if (comm->getRank() == MASTERGPI) {
+        std::ofstream file(filename);
+        file << report.str();
+        SCAI_ASSERT_ERROR(file.good(), "Could not write profiler report " << filename);
+    }
+}
+
+/*! \brief Start timing a phase
+ *
+ \param phase Phase
+ */
+KITGPI::Common::PhaseTimer::PhaseTimer(Phase phase)
+    : phase(phase), startTime(common::Walltime::get())
+{
+}
+
+//! \brief Add the time since construction to the phase if stop() was not called
+KITGPI::Common::PhaseTimer::~PhaseTimer()
+{
+    stop();
+}
+
+//! \brief Add the time since construction to the phase
+void KITGPI::Common::PhaseTimer::stop()
+{
+    if (startTime >= 0) {
+        Profiler::global().addTime(phase, common::Walltime::get() - startTime);
+        startTime = -1.0;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+
+#include <mutex>
+#include <string>
+
+using namespace scai;
+namespace KITGPI
+{
+    namespace Common
+    {
+
+        //! \brief Phases of the simulation which are timed by the Profiler
+        enum class Phase {
+            Partitioning,      //!< graph partitioning, partition cache and renumbering
+            Derivatives,       //!< initialization of the derivative matrices
+            Wavefields,        //!< initialization of the wavefields
+            Acquisition,       //!< initialization of the sources and receivers
+            Model,             //!< reading and preparation of the model
+            ForwardSolverInit, //!< initialization of the forward solver
+            ShotSetup,         //!< sources, receivers and checks of every shot
+            TimeLoop,          //!< time stepping of every shot
+            Output,            //!< normalization and output of the seismograms
+            numPhases
+        };
+
+        /*! \brief Runtime and I/O volume of the phases of the simulation
+         *
+         * Every process accumulates the runtime of the phases and the number of bytes read and written by the IO functions.
+         * writeReport() computes the minimum, average and maximum over all processes and writes them as JSON,
+         * e.g. to track the runtime of the phases between releases or to find the phase which dominates for a model.
+         * The profiler can be used by several threads of a process (e.g. the helper thread of the shot pipeline).
+         */
+        class Profiler
+        {
+          public:
+            static Profiler &global();
+
+            void addTime(Phase phase, double seconds);
+            void addBytesRead(double bytes);
+            void addBytesWritten(double bytes);
+
+            void writeReport(std::string const &filename, dmemo::CommunicatorPtr comm, double runtime) const;
+
+            static char const *getPhaseName(Phase phase);
+
+          private:
+            Profiler(){};
+
+            static constexpr IndexType numPhases = static_cast<IndexType>(Phase::numPhases);
+
+            mutable std::mutex mutex;          //!< protects time, count and the byte counters
+            double time[numPhases] = {};       //!< accumulated runtime per phase in seconds
+            IndexType count[numPhases] = {};   //!< number of timed intervals per phase
+            double bytesRead = 0;              //!< bytes read by this process
+            double bytesWritten = 0;           //!< bytes written by this process
+        };
+
+        /*! \brief Adds the time between construction and stop() (or destruction) to a phase of the global profiler
+         */
+        class PhaseTimer
+        {
+          public:
+            explicit PhaseTimer(Phase phase);
+            ~PhaseTimer();
+
+            void stop();
+
+          private:
+            Phase phase;       //!< timed phase
+            double startTime;  //!< start time, negative after stop()
+        };
+    }
+}
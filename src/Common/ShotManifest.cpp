@@ -0,0 +1,222 @@
+#include "ShotManifest.hpp"
+#include "Checksum.hpp"
+#include "HostPrint.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace scai;
+
+/*! \brief Read and verify the manifest
+ *
+ * Has to be called by all processes. The manifest is only used if shotManifestFilename is set.
+ \param config Configuration
+ \param commAll Communicator of all processes
+ \param commShot Communicator of the shot domain
+ */
+void KITGPI::Common::ShotManifest::init(Configuration::Configuration const &config, dmemo::CommunicatorPtr commAll, dmemo::CommunicatorPtr commShot)
+{
+    this->commShot = commShot;
+    manifestFilename = config.getAndCatch("shotManifestFilename", std::string(""));
+    completed.clear();
+    if (manifestFilename.empty()) {
+        return;
+    }
+
+    IndexType numLines = 0;
+    if (commAll->getRank() == MASTERGPI) {
+        std::ifstream manifest(manifestFilename);
+        std::string line;
+        bool newlineMissing = false;
+        while (std::getline(manifest, line)) {
+            verify(line);
+            numLines++;
+            newlineMissing = manifest.eof();
+        }
+        // terminate a line which was interrupted by a crash, otherwise the next entry would be appended to it
+        if (newlineMissing) {
+            std::ofstream repair(manifestFilename, std::ios::app);
+            repair << "\n";
+            SCAI_ASSERT_ERROR(repair.good(), "Could not write shot manifest " << manifestFilename);
+        }
+    }
+
+    // completed shots as (round, shotInd) pairs
+    std::vector<IndexType> shots;
+    for (IndexType round = 0; round < IndexType(completed.size()); round++) {
+        for (auto shotInd : completed[round]) {
+            shots.push_back(round);
+            shots.push_back(shotInd);
+        }
+    }
+    IndexType numValues = shots.size();
+    commAll->bcast(&numValues, 1, MASTERGPI);
+    shots.resize(numValues);
+    if (numValues > 0) {
+        commAll->bcast(shots.data(), numValues, MASTERGPI);
+    }
+    completed.clear();
+    for (IndexType i = 0; i < numValues; i += 2) {
+        if (shots[i] >= IndexType(completed.size())) {
+            completed.resize(shots[i] + 1);
+        }
+        completed[shots[i]].push_back(shots[i + 1]);
+    }
+
+    HOST_PRINT(commAll, "Shot manifest " << manifestFilename << ": " << numValues / 2 << " finished shots found\n", "(" << numLines << " entries, entries with missing or modified output files are computed again)\n");
+}
+
+//! \brief Return true if the manifest is used
+bool KITGPI::Common::ShotManifest::isActive() const
+{
+    return (!manifestFilename.empty());
+}
+
+/*! \brief Return the verified shots of a round
+ *
+ \param round Round of the shot loop
+ \return sorted shot indices
+ */
+std::vector<IndexType> KITGPI::Common::ShotManifest::getCompletedShots(IndexType round) const
+{
+    if (round < 0 || round >= IndexType(completed.size())) {
+        return {};
+    }
+    return completed[round];
+}
+
+/*! \brief Append a finished shot to the manifest
+ *
+ * Has to be called by all processes of the shot domain after the output of the shot is written.
+ \param round Round of the shot loop
+ \param shotInd Index of the shot in the shot scheduler
+ \param shotNumber Shot number
+ \param outputFilenames Names of the output files of the shot, as returned by SeismogramHandler::write
+ */
+void KITGPI::Common::ShotManifest::recordShot(IndexType round, IndexType shotInd, IndexType shotNumber, std::vector<std::string> const &outputFilenames) const
+{
+    if (!isActive()) {
+        return;
+    }
+    // wait for the output of all processes, a single process has nothing to wait for
+    if (commShot->getSize() > 1) {
+        commShot->synchronize();
+    }
+    if (commShot->getRank() != MASTERGPI) {
+        return;
+    }
+
+    std::vector<std::string> filenames = outputFilenames;
+    std::sort(filenames.begin(), filenames.end());
+    filenames.erase(std::unique(filenames.begin(), filenames.end()), filenames.end());
+    if (filenames.empty()) {
+        return; // nothing to verify, the shot is computed again
+    }
+
+    std::ostringstream entry;
+    entry << "shot\t" << round << "\t" << shotInd << "\t" << shotNumber << "\t" << filenames.size();
+    for (auto const &filename : filenames) {
+        OutputFile file;
+        file.name = filename;
+        SCAI_ASSERT_ERROR(readOutputFile(file), "Could not read output file " << filename << " of shot " << shotNumber);
+        entry << "\t" << file.name << "\t" << file.size << "\t" << std::hex << file.checksum << std::dec;
+    }
+    std::string text = entry.str();
+    std::ostringstream lineChecksum;
+    lineChecksum << "\t" << std::hex << Checksum::of(text) << "\n";
+
+    // a single append of the whole line, so the entries of the shot domains do not interleave
+    text += lineChecksum.str();
+    int fd = ::open(manifestFilename.c_str(), O_CREAT | O_WRONLY | O_APPEND, 0644);
+    SCAI_ASSERT_ERROR(fd >= 0, "Could not open shot manifest " << manifestFilename << ": " << std::strerror(errno));
+    ssize_t written = ::write(fd, text.c_str(), text.size());
+    ::fsync(fd);
+    ::close(fd);
+    SCAI_ASSERT_ERROR(written == ssize_t(text.size()), "Could not write shot manifest " << manifestFilename);
+}
+
+/*! \brief Read the size and checksum of an output file
+ *
+ \param file Output file, name is input, size and checksum are output
+ \return false if the file cannot be read
+ */
+bool KITGPI::Common::ShotManifest::readOutputFile(OutputFile &file)
+{
+    return Checksum::ofFile(file.name, file.checksum, file.size);
+}
+
+/*! \brief Check if an output file still has the recorded size and checksum
+ *
+ * The size is compared first, so only files of the recorded size are read.
+ \param file Recorded output file
+ */
+bool KITGPI::Common::ShotManifest::isUnchanged(OutputFile const &file)
+{
+    struct stat status;
+    if (::stat(file.name.c_str(), &status) != 0 || static_cast<unsigned long long>(status.st_size) != file.size) {
+        return false;
+    }
+    OutputFile current;
+    current.name = file.name;
+    return readOutputFile(current) && current.size == file.size && current.checksum == file.checksum;
+}
+
+/*! \brief Verify one line of the manifest
+ *
+ * A valid line whose output files are unchanged marks its shot as finished.
+ \param line Line of the manifest
+ */
+void KITGPI::Common::ShotManifest::verify(std::string const &line)
+{
+    auto lastTab = line.find_last_of('\t');
+    if (line.compare(0, 5, "shot\t") != 0 || lastTab == std::string::npos) {
+        return;
+    }
+    std::string entry = line.substr(0, lastTab);
+    unsigned long long lineChecksum = 0;
+    std::istringstream(line.substr(lastTab + 1)) >> std::hex >> lineChecksum;
+    if (lineChecksum != Checksum::of(entry)) {
+        return; // interrupted or corrupt line
+    }
+
+    std::vector<std::string> fields;
+    std::istringstream entryStream(entry);
+    std::string field;
+    while (std::getline(entryStream, field, '\t')) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 5) {
+        return;
+    }
+    IndexType round = std::stol(fields[1]);
+    IndexType shotInd = std::stol(fields[2]);
+    size_t numFiles = std::stoul(fields[4]);
+    if (round < 0 || shotInd < 0 || numFiles == 0 || fields.size() != 5 + 3 * numFiles) {
+        return;
+    }
+
+    for (size_t i = 0; i < numFiles; i++) {
+        OutputFile file;
+        file.name = fields[5 + 3 * i];
+        file.size = std::stoull(fields[6 + 3 * i]);
+        file.checksum = std::stoull(fields[7 + 3 * i], nullptr, 16);
+        if (!isUnchanged(file)) {
+            return; // missing or modified output
+        }
+    }
+
+    if (round >= IndexType(completed.size())) {
+        completed.resize(round + 1);
+    }
+    auto &shots = completed[round];
+    auto position = std::lower_bound(shots.begin(), shots.end(), shotInd);
+    if (position == shots.end() || *position != shotInd) {
+        shots.insert(position, shotInd);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+
+#include "../Configuration/Configuration.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace scai;
+namespace KITGPI
+{
+    namespace Common
+    {
+
+        /*! \brief Journal of the finished shots to resume an interrupted run
+         *
+         * After the seismograms of a shot are written, the master of the shot domain appends one line to the manifest shotManifestFilename:
+         * the round of the shot loop, the shot index, the shot number and the name, size and checksum of every output file of the shot.
+         * Every line is written by a single append and carries its own checksum, so a line which was interrupted by a crash is ignored.
+         * On startup the master verifies all entries against the files on disk. Shots with a valid entry are not scheduled again,
+         * shots with missing or modified output files are computed again.
+         */
+        class ShotManifest
+        {
+          public:
+            //! \brief Default constructor
+            ShotManifest(){};
+
+            //! \brief Default destructor
+            ~ShotManifest(){};
+
+            void init(Configuration::Configuration const &config, dmemo::CommunicatorPtr commAll, dmemo::CommunicatorPtr commShot);
+
+            bool isActive() const;
+
+            std::vector<IndexType> getCompletedShots(IndexType round) const;
+
+            void recordShot(IndexType round, IndexType shotInd, IndexType shotNumber, std::vector<std::string> const &outputFilenames) const;
+
+          private:
+            //! \brief Output file of a shot
+            struct OutputFile {
+                std::string name;                 //!< filename
+                unsigned long long size = 0;      //!< size in bytes
+                unsigned long long checksum = 0;  //!< FNV-1a checksum of the content
+            };
+
+            static bool readOutputFile(OutputFile &file);
+            static bool isUnchanged(OutputFile const &file);
+
+            void verify(std::string const &line);
+
+            std::string manifestFilename;                    //!< filename of the manifest, empty if not used
+            std::vector<std::vector<IndexType>> completed;   //!< verified shot indices per round
+            dmemo::CommunicatorPtr commShot;                 //!< communicator of the shot domain
+        };
+    }
+}
@@ -0,0 +1,218 @@
+#include "ShotScheduler.hpp"
+#include "HostPrint.hpp"
+
+#include <scai/common/Walltime.hpp>
+#include <scai/hmemo/ReadAccess.hpp>
+#include <scai/hmemo/WriteAccess.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace scai;
+
+/*! \brief Initialize the shot queue of this shot domain
+ *
+ * Has to be called by all processes. Stale claim files of an aborted run are removed by the master before any domain starts claiming shots.
+ \param config Configuration
+ \param commAll Communicator of all processes
+ \param commShot Communicator of the shot domain
+ \param commInterShot Communicator between the shot domains
+ \param numShots Number of shots
+ \param round Round of the shot loop, claims of different rounds are independent
+ */
+void KITGPI::Common::ShotScheduler::init(Configuration::Configuration const &config, dmemo::CommunicatorPtr commAll, dmemo::CommunicatorPtr commShot, dmemo::CommunicatorPtr commInterShot, IndexType numShots, IndexType round)
+{
+    this->commShot = commShot;
+    this->commInterShot = commInterShot;
+    this->round = round;
+
+    scheduling = config.getAndCatch("shotScheduling", 0);
+    SCAI_ASSERT_ERROR(scheduling == 0 || scheduling == 1, "unknown shotScheduling = " << scheduling);
+
+    if (startTime < 0) {
+        startTime = common::Walltime::get();
+    }
+
+    auto shotDist = dmemo::blockDistribution(numShots, commInterShot);
+
+    shotQueue.clear();
+    queuePosition = 0;
+    for (IndexType shotInd = shotDist->lb(); shotInd < shotDist->ub(); shotInd++) {
+        shotQueue.push_back(shotInd);
+    }
+
+    if (scheduling == 1) {
+        claimFilename = config.getAndCatch("shotClaimFilename", config.get<std::string>("SeismogramFilename") + ".claim");
+
+        // steal from the end of the blocks of the other domains to disturb them as late as possible
+        for (IndexType shotInd = numShots - 1; shotInd >= 0; shotInd--) {
+            if (shotInd < shotDist->lb() || shotInd >= shotDist->ub()) {
+                shotQueue.push_back(shotInd);
+            }
+        }
+
+        if (commAll->getRank() == MASTERGPI) {
+            for (IndexType shotInd = 0; shotInd < numShots; shotInd++) {
+                std::remove(getClaimFilename(shotInd).c_str());
+            }
+        }
+        commAll->synchronize();
+    }
+}
+
+/*! \brief Remove shots from the queue (e.g. shots which are already finished)
+ *
+ * Has to be called by all processes with the same shots after init().
+ \param shotInds Sorted indices of the shots which are not computed
+ */
+void KITGPI::Common::ShotScheduler::skipShots(std::vector<IndexType> const &shotInds)
+{
+    auto skipped = [&shotInds](IndexType shotInd) { return std::binary_search(shotInds.begin(), shotInds.end(), shotInd); };
+    shotQueue.erase(std::remove_if(shotQueue.begin() + queuePosition, shotQueue.end(), skipped), shotQueue.end());
+}
+
+/*! \brief Get the next shot of this shot domain
+ *
+ * Has to be called by all processes of the shot domain. The runtime between two calls is accounted as busy time of the domain.
+ \param shotInd Index of the next shot
+ \return false if no shot is left
+ */
+bool KITGPI::Common::ShotScheduler::getNextShot(IndexType &shotInd)
+{
+    double now = common::Walltime::get();
+    if (shotActive) {
+        busyTime += now - shotStartTime;
+        shotActive = false;
+    }
+
+    shotInd = -1;
+    if (scheduling == 0) {
+        if (queuePosition < IndexType(shotQueue.size())) {
+            shotInd = shotQueue[queuePosition++];
+        }
+    } else {
+        if (commShot->getRank() == MASTERGPI) {
+            while (queuePosition < IndexType(shotQueue.size())) {
+                IndexType candidate = shotQueue[queuePosition++];
+                if (claimShot(candidate)) {
+                    shotInd = candidate;
+                    break;
+                }
+            }
+        }
+        commShot->bcast(&shotInd, 1, MASTERGPI);
+    }
+
+    if (shotInd < 0) {
+        return false;
+    }
+
+    shotStartTime = common::Walltime::get();
+    shotActive = true;
+    numShotsDone++;
+    return true;
+}
+
+/*! \brief Print the number of shots and the utilisation of every shot domain
+ *
+ * Has to be called by all processes. The utilisation is the accumulated shot runtime relative to the time since the first initialization.
+ \param commAll Communicator of all processes
+ */
+void KITGPI::Common::ShotScheduler::printUtilisation(dmemo::CommunicatorPtr commAll)
+{
+    double now = common::Walltime::get();
+    if (shotActive) {
+        busyTime += now - shotStartTime;
+        shotActive = false;
+    }
+    double wallTime = now - startTime;
+
+    IndexType numDomains = commInterShot->getSize();
+    hmemo::HArray<double> domainBusyTime(numDomains, 0.0);
+    hmemo::HArray<double> domainNumShots(numDomains, 0.0);
+    {
+        auto write_domainBusyTime = hmemo::hostWriteAccess(domainBusyTime);
+        auto write_domainNumShots = hmemo::hostWriteAccess(domainNumShots);
+        write_domainBusyTime[commInterShot->getRank()] = busyTime;
+        write_domainNumShots[commInterShot->getRank()] = numShotsDone;
+    }
+    commInterShot->sumArray(domainBusyTime);
+    commInterShot->sumArray(domainNumShots);
+    wallTime = commAll->max(wallTime);
+
+    auto read_domainBusyTime = hmemo::hostReadAccess(domainBusyTime);
+    auto read_domainNumShots = hmemo::hostReadAccess(domainNumShots);
+    double sumBusyTime = 0.0;
+    HOST_PRINT(commAll, "\nShot domain utilisation (" << (scheduling == 0 ? "static" : "dynamic") << " shot scheduling):\n");
+    for (IndexType domain = 0; domain < numDomains; domain++) {
+        sumBusyTime += read_domainBusyTime[domain];
+        HOST_PRINT(commAll, " - domain " << domain << ": " << IndexType(read_domainNumShots[domain]) << " shots, busy " << read_domainBusyTime[domain] << " sec. (" << std::fixed << std::setprecision(1) << 100.0 * read_domainBusyTime[domain] / wallTime << std::defaultfloat << "%)\n");
+    }
+    HOST_PRINT(commAll, " - average utilisation: " << std::fixed << std::setprecision(1) << 100.0 * sumBusyTime / (numDomains * wallTime) << std::defaultfloat << "%\n\n");
+}
+
+/*! \brief Remove the claim files of this run
+ *
+ * Has to be called by all processes after the last round. The processes are synchronized first, so no domain claims a shot of a removed claim file again.
+ \param commAll Communicator of all processes
+ */
+void KITGPI::Common::ShotScheduler::finish(dmemo::CommunicatorPtr commAll)
+{
+    if (scheduling == 0) {
+        return;
+    }
+    commAll->synchronize();
+    for (auto const &filename : claimFiles) {
+        std::remove(filename.c_str());
+    }
+    claimFiles.clear();
+}
+
+/*! \brief Claim a shot by linking a file of this domain to its claim file
+ *
+ * link() fails if the claim file exists and is atomic on NFS, where O_EXCL is not reliable.
+ * If a retransmitted link() reports EEXIST for the link of this domain, the link count of the file of this domain shows that the link was created.
+ \param shotInd Index of the shot
+ \return true if the shot was not claimed by another domain before
+ */
+bool KITGPI::Common::ShotScheduler::claimShot(IndexType shotInd)
+{
+    std::string filename = getClaimFilename(shotInd);
+    std::string domainFilename = filename + ".domain_" + std::to_string(commInterShot->getRank());
+
+    int fd = ::open(domainFilename.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    SCAI_ASSERT_ERROR(fd >= 0, "Could not create claim file " << domainFilename << ": " << std::strerror(errno));
+    std::string domain = std::to_string(commInterShot->getRank()) + "\n";
+    ssize_t written = ::write(fd, domain.c_str(), domain.size());
+    ::close(fd);
+    SCAI_ASSERT_ERROR(written == ssize_t(domain.size()), "Could not write claim file " << domainFilename);
+
+    bool claimed = (::link(domainFilename.c_str(), filename.c_str()) == 0);
+    if (!claimed) {
+        SCAI_ASSERT_ERROR(errno == EEXIST, "Could not create claim file " << filename << ": " << std::strerror(errno));
+        struct stat status;
+        claimed = (::stat(domainFilename.c_str(), &status) == 0 && status.st_nlink == 2);
+    }
+    std::remove(domainFilename.c_str());
+
+    if (claimed) {
+        claimFiles.push_back(filename);
+    }
+    return claimed;
+}
+
+/*! \brief Return the name of the claim file of a shot
+ *
+ \param shotInd Index of the shot
+ */
+std::string KITGPI::Common::ShotScheduler::getClaimFilename(IndexType shotInd) const
+{
+    return claimFilename + ".round_" + std::to_string(round) + ".shot_" + std::to_string(shotInd);
+}
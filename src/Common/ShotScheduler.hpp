@@ -0,0 +1,66 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+#include <scai/hmemo/HArray.hpp>
+
+#include "../Configuration/Configuration.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace scai;
+namespace KITGPI
+{
+    namespace Common
+    {
+
+        /*! \brief Distribution of the shots to the shot domains
+         *
+         * shotScheduling = 0 (static): every shot domain computes a contiguous block of shots.
+         * shotScheduling = 1 (dynamic): every shot domain first works on its own block and afterwards steals the remaining shots of the other domains starting from the end of their blocks.
+         * A shot is claimed by the master of the shot domain by linking a file of the domain to the claim file shotClaimFilename.round_<round>.shot_<shotInd> on the shared file system,
+         * so no shot is computed twice and no communication between the shot domains is required. Unlike an exclusive create, a hard link is atomic on NFS.
+         * The claim files are removed by finish() at the end of the run.
+         * In both modes the number of shots does not have to be a multiple of the number of shot domains.
+         */
+        class ShotScheduler
+        {
+          public:
+            //! \brief Default constructor
+            ShotScheduler(){};
+
+            //! \brief Default destructor
+            ~ShotScheduler(){};
+
+            void init(Configuration::Configuration const &config, dmemo::CommunicatorPtr commAll, dmemo::CommunicatorPtr commShot, dmemo::CommunicatorPtr commInterShot, IndexType numShots, IndexType round = 0);
+
+            void skipShots(std::vector<IndexType> const &shotInds);
+
+            bool getNextShot(IndexType &shotInd);
+
+            void printUtilisation(dmemo::CommunicatorPtr commAll);
+
+            void finish(dmemo::CommunicatorPtr commAll);
+
+          private:
+            bool claimShot(IndexType shotInd);
+            std::string getClaimFilename(IndexType shotInd) const;
+
+            IndexType scheduling = 0;         //!< 0 = static, 1 = dynamic
+            std::string claimFilename;        //!< prefix of the claim files
+            IndexType round = 0;              //!< round of the shot loop (e.g. Hilbert decomposition)
+            std::vector<IndexType> shotQueue; //!< shots in the order in which this domain tries to compute them
+            IndexType queuePosition = 0;      //!< position of the next shot in the queue
+            std::vector<std::string> claimFiles; //!< claim files created by this domain in all rounds
+
+            dmemo::CommunicatorPtr commShot;      //!< communicator of the shot domain
+            dmemo::CommunicatorPtr commInterShot; //!< communicator between the shot domains
+
+            double startTime = -1.0;    //!< start time of the first round
+            double shotStartTime = 0.0; //!< start time of the current shot
+            bool shotActive = false;    //!< true if a shot is computed at the moment
+            double busyTime = 0.0;      //!< accumulated runtime of all computed shots
+            IndexType numShotsDone = 0; //!< number of shots computed by this domain
+        };
+    }
+}
@@ -0,0 +1,64 @@
+#include "SimulationParameters.hpp"
+#include "../Common/HostPrint.hpp"
+
+/*! \brief Read and validate the parameters
+ *
+ \param config Configuration
+ */
+template <typename ValueType>
+KITGPI::Configuration::SimulationParameters<ValueType>::SimulationParameters(Configuration const &config)
+{
+    DT = config.get<ValueType>("DT");
+    SCAI_ASSERT_ERROR(DT > 0, "DT = " << DT << " has to be positive");
+    DTinv = 1 / DT;
+    tStepEnd = Common::time2index(config.get<ValueType>("T"), DT);
+    SCAI_ASSERT_ERROR(tStepEnd > 0, "T = " << config.get<ValueType>("T") << " is shorter than DT");
+
+    useCompensation = (config.getAndCatch("compensation", 0) != 0);
+
+    decomposition = config.getAndCatch("decomposeWavefieldType", 0);
+    snapType = (decomposition != 0) ? decomposition + 3 : config.get<scai::IndexType>("snapType");
+    tStepFirstSnapshot = 0;
+    tStepLastSnapshot = -1;
+    tStepIncSnapshot = 1;
+    fileFormat = 0;
+    if (snapType > 0) {
+        tStepFirstSnapshot = Common::time2index(config.get<ValueType>("tFirstSnapshot"), DT);
+        tStepLastSnapshot = Common::time2index(config.get<ValueType>("tlastSnapshot"), DT);
+        tStepIncSnapshot = Common::time2index(config.get<ValueType>("tincSnapshot"), DT);
+        // invalid snapshot windows are not fatal, the modelling itself is not affected
+        auto comm = scai::dmemo::Communicator::getCommunicatorPtr();
+        if (tStepIncSnapshot < 1) {
+            HOST_PRINT(comm, "Warning: tincSnapshot = " << config.get<ValueType>("tincSnapshot") << " is shorter than DT, a snapshot is written every time step\n");
+            tStepIncSnapshot = 1;
+        }
+        if (tStepFirstSnapshot > tStepLastSnapshot) {
+            HOST_PRINT(comm, "Warning: tFirstSnapshot is larger than tlastSnapshot, no snapshots are written\n");
+        }
+        wavefieldFilename = config.get<std::string>("WavefieldFileName");
+        fileFormat = config.get<scai::IndexType>("FileFormat");
+    }
+
+    seismogramFilename = config.get<std::string>("SeismogramFilename");
+    seismogramFormat = config.get<scai::IndexType>("SeismogramFormat");
+    normalizeTraces = config.get<scai::IndexType>("normalizeTraces");
+    frequencyAGC = (normalizeTraces == 3) ? config.get<ValueType>("CenterFrequencyCPML") : 0;
+    writeSource = config.getAndCatch("writeSource", false);
+    if (writeSource) {
+        writeSourceFilename = config.get<std::string>("writeSourceFilename");
+    }
+    useReceiversPerShot = (config.get<scai::IndexType>("useReceiversPerShot") != 0);
+}
+
+/*! \brief Return true if a snapshot is written at a time step
+ *
+ \param tStep time step
+ */
+template <typename ValueType>
+bool KITGPI::Configuration::SimulationParameters<ValueType>::isSnapshot(scai::IndexType tStep) const
+{
+    return (snapType > 0 && tStep >= tStepFirstSnapshot && tStep <= tStepLastSnapshot && (tStep - tStepFirstSnapshot) % tStepIncSnapshot == 0);
+}
+
+template struct KITGPI::Configuration::SimulationParameters<float>;
+template struct KITGPI::Configuration::SimulationParameters<double>;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../Common/Common.hpp"
+#include "Configuration.hpp"
+
+#include <string>
+
+namespace KITGPI
+{
+
+    namespace Configuration
+    {
+
+        //! \brief Typed parameters of the forward modelling
+        /*!
+         * The parameters which are used during the time stepping and the output of the shots are read and validated once from the configuration,
+         * so the shot and time loops do not parse the configuration. The object is created once after the configuration is read and used as const.
+         * Parameters which are only required for certain settings (e.g. the snapshot times for snapType > 0) are only read for these settings.
+         */
+        template <typename ValueType>
+        struct SimulationParameters {
+            explicit SimulationParameters(Configuration const &config);
+
+            bool isSnapshot(scai::IndexType tStep) const;
+
+            ValueType DT;             //!< temporal sampling in seconds
+            ValueType DTinv;          //!< inverse of the temporal sampling
+            scai::IndexType tStepEnd; //!< number of time steps
+
+            bool useCompensation; //!< ==true if the wavefields are compensated for the attenuation (compensation)
+
+            scai::IndexType decomposition;      //!< type of the wavefield decomposition (decomposeWavefieldType)
+            scai::IndexType snapType;           //!< type of the snapshots, decomposition + 3 with wavefield decomposition
+            scai::IndexType tStepFirstSnapshot; //!< time step of the first snapshot (tFirstSnapshot)
+            scai::IndexType tStepLastSnapshot;  //!< time step of the last snapshot (tlastSnapshot)
+            scai::IndexType tStepIncSnapshot;   //!< time steps between two snapshots (tincSnapshot)
+            std::string wavefieldFilename;      //!< prefix of the snapshots (WavefieldFileName)
+            scai::IndexType fileFormat;         //!< file format of the snapshots (FileFormat)
+
+            std::string seismogramFilename;  //!< prefix of the seismograms (SeismogramFilename)
+            scai::IndexType seismogramFormat; //!< file format of the seismograms (SeismogramFormat)
+            scai::IndexType normalizeTraces;  //!< normalization of the seismograms (normalizeTraces)
+            ValueType frequencyAGC;           //!< frequency of the AGC for normalizeTraces = 3 (CenterFrequencyCPML)
+            bool writeSource;                 //!< ==true if the source signals are written (writeSource)
+            std::string writeSourceFilename;  //!< prefix of the source signals (writeSourceFilename)
+            bool useReceiversPerShot;         //!< ==true if every shot has its own receivers (useReceiversPerShot)
+        };
+    }
+}
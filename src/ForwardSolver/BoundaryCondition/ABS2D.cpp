@@ -1,4 +1,5 @@
 #include "ABS2D.hpp"
+#include <algorithm>
 using namespace scai;
 
 /*! \brief Application of the damping boundary
@@ -56,41 +57,18 @@ void KITGPI::ForwardSolver::BoundaryCondition::ABS2D<ValueType>::apply(scai::lam
 template <typename ValueType>
 ValueType KITGPI::ForwardSolver::BoundaryCondition::ABS2D<ValueType>::estimateMemory(IndexType BoundaryWidth, IndexType useFreeSurface, scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
 {
-    /* Get local owned global indices */
-    hmemo::HArray<IndexType> ownedIndeces;
-    dist->getOwnedIndexes(ownedIndeces);
-
-    IndexType counter = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndeces)) {
-
-        Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
-        Acquisition::coordinate3D coordinatedist = modelCoordinates.edgeDistance(coordinate);
-
-        IndexType temp = 0;
-        if (coordinatedist.x < coordinatedist.y) {
-            temp = coordinatedist.x;
-        } else {
-            temp = coordinatedist.y;
+    // the boundary gridpoints are counted per xz plane from the grids of the layers
+    auto nearEdge = [&](IndexType distance, IndexType /*layer*/) { return (distance < BoundaryWidth); };
+    IndexType NY = modelCoordinates.getNY();
+
+    IndexType sum = modelCoordinates.countGridpoints(nearEdge, nearEdge, [&](IndexType y, IndexType /*layer*/, IndexType countX, IndexType countZ, IndexType numX, IndexType numZ) {
+        // at the free surface only the horizontal boundaries are damped
+        if (nearEdge(std::min(y, NY - 1 - y), 0) && ((useFreeSurface == 0) || (y >= BoundaryWidth))) {
+            return (numX * numZ);
         }
-        IndexType coordinateMin = temp;
-        if (useFreeSurface == 0) {
-            if (coordinateMin < BoundaryWidth) {
-                counter++;
-            }
-
-        } else {
-            if (coordinate.y < BoundaryWidth) {
-                if ((coordinatedist.x < BoundaryWidth)) {
-                    counter++;
-                }
-            } else if (coordinateMin < BoundaryWidth) {
-                counter++;
-            }
-        }
-    }
+        return (countX * numZ);
+    });
 
-    IndexType sum=dist->getCommunicator().sum(counter);
     ValueType mega = 1024 * 1024;
     ValueType size = sum * sizeof(ValueType) / mega;
     return size;
@@ -36,6 +36,9 @@ namespace KITGPI
                 void apply(scai::lama::Vector<ValueType> &v1, scai::lama::Vector<ValueType> &v2, scai::lama::Vector<ValueType> &v3);
                 void apply(scai::lama::Vector<ValueType> &v1, scai::lama::Vector<ValueType> &v2, scai::lama::Vector<ValueType> &v3, scai::lama::Vector<ValueType> &v4, scai::lama::Vector<ValueType> &v5);
 
+                //! \brief Getter method for the damping coefficients (e.g. for the batched modelling)
+                scai::lama::SparseVector<ValueType> const &getDamping() const { return (damping); };
+
               private:
                 typedef typename ABS<ValueType>::VectorType VectorType;
                 VectorType damping; //!< Absorbing Coefficient DenseVector. damping=1.0 in the interior and  damping < 1.0 inside the boundary frame.
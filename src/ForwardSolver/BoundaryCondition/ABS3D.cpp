@@ -1,4 +1,5 @@
 #include "ABS3D.hpp"
+#include <algorithm>
 using namespace scai;
 
 /*! \brief Application of the damping boundary
@@ -100,41 +101,19 @@ void KITGPI::ForwardSolver::BoundaryCondition::ABS3D<ValueType>::apply(
 template <typename ValueType>
 ValueType KITGPI::ForwardSolver::BoundaryCondition::ABS3D<ValueType>::estimateMemory(IndexType BoundaryWidth, IndexType useFreeSurface, scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
 {
-    /* Get local owned global indices */
-    hmemo::HArray<IndexType> ownedIndeces;
-    dist->getOwnedIndexes(ownedIndeces);
-
-    Acquisition::coordinate3D coordinate;
-    Acquisition::coordinate3D coordinatedist;
-
-    IndexType coordinateMin = 0;
-
-    IndexType counter = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndeces)) {
-
-        coordinate = modelCoordinates.index2coordinate(ownedIndex);
-        coordinatedist = modelCoordinates.edgeDistance(coordinate);
-
-        coordinateMin = coordinatedist.min();
-
-        if (useFreeSurface == 0) {
-            if (coordinateMin < BoundaryWidth) {
-                counter++;
-            }
-
-        } else {
-            if (coordinate.y < BoundaryWidth) {
-                if ((coordinatedist.z < BoundaryWidth) || (coordinatedist.x < BoundaryWidth)) {
-                    counter++;
-                }
-            } else if (coordinateMin < BoundaryWidth) {
-                counter++;
-            }
+    // the boundary gridpoints are counted per xz plane from the grids of the layers
+    auto nearEdge = [&](IndexType distance, IndexType /*layer*/) { return (distance < BoundaryWidth); };
+    IndexType NY = modelCoordinates.getNY();
+
+    IndexType sum = modelCoordinates.countGridpoints(nearEdge, nearEdge, [&](IndexType y, IndexType /*layer*/, IndexType countX, IndexType countZ, IndexType numX, IndexType numZ) {
+        // at the free surface only the horizontal boundaries are damped
+        if (nearEdge(std::min(y, NY - 1 - y), 0) && ((useFreeSurface == 0) || (y >= BoundaryWidth))) {
+            return (numX * numZ);
         }
-    }
+        // gridpoints near the x or the z boundary
+        return (countX * numZ + numX * countZ - countX * countZ);
+    });
 
-     IndexType sum=dist->getCommunicator().sum(counter);
     ValueType mega = 1024 * 1024;
     ValueType size = sum * sizeof(ValueType) / mega;
     return size;
@@ -39,6 +39,16 @@ namespace KITGPI
                 void apply_p_x(scai::lama::DenseVector<ValueType> &p_x);
                 void apply_p_y(scai::lama::DenseVector<ValueType> &p_y);
 
+                //! \brief Getter methods for the CPML coefficients (e.g. for the batched modelling)
+                scai::lama::SparseVector<ValueType> const &getA_x() const { return (a_x); };
+                scai::lama::SparseVector<ValueType> const &getB_x() const { return (b_x); };
+                scai::lama::SparseVector<ValueType> const &getA_x_half() const { return (a_x_half); };
+                scai::lama::SparseVector<ValueType> const &getB_x_half() const { return (b_x_half); };
+                scai::lama::SparseVector<ValueType> const &getA_y() const { return (a_y); };
+                scai::lama::SparseVector<ValueType> const &getB_y() const { return (b_y); };
+                scai::lama::SparseVector<ValueType> const &getA_y_half() const { return (a_y_half); };
+                scai::lama::SparseVector<ValueType> const &getB_y_half() const { return (b_y_half); };
+
               private:
                 using CPML<ValueType>::active;
                 typedef typename CPML<ValueType>::VectorType VectorType;
@@ -1,4 +1,5 @@
 #include "CPML3DAcoustic.hpp"
+#include <algorithm>
 using namespace scai;
 
 //! \brief resetting the CPML memory variables
@@ -67,44 +68,21 @@ void KITGPI::ForwardSolver::BoundaryCondition::CPML3DAcoustic<ValueType>::apply_
 template <typename ValueType>
 ValueType KITGPI::ForwardSolver::BoundaryCondition::CPML3DAcoustic<ValueType>::estimateMemory(IndexType BoundaryWidth, IndexType useFreeSurface, scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
 {
-
-    IndexType counter = 0;
-
-    hmemo::HArray<IndexType> ownedIndeces;
-    dist->getOwnedIndexes(ownedIndeces);
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndeces)) {
-
-        Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
-        IndexType layer = modelCoordinates.getLayer(coordinate);
-
-        Acquisition::coordinate3D gdist = modelCoordinates.edgeDistance(coordinate);
-
-        IndexType width = std::ceil((float)BoundaryWidth / modelCoordinates.getDHFactor(layer));
-        IndexType xDist = gdist.x / modelCoordinates.getDHFactor(layer);
-        IndexType yDist = gdist.y / modelCoordinates.getDHFactor(layer);
-        IndexType zDist = gdist.z / modelCoordinates.getDHFactor(layer);
-
-        if (xDist < width) {
-            counter++;
-        }
-
-        if (yDist < width) {
-            IndexType yCoord = coordinate.y / modelCoordinates.getDHFactor(layer);
-            if (yCoord < width) {
-                if (useFreeSurface == 0) {
-                    counter++;
-                }
-            } else {
-                counter++;
-            }
+    // the boundary gridpoints are counted per xz plane from the grids of the layers
+    auto width = [&](IndexType layer) { return (IndexType(std::ceil((float)BoundaryWidth / modelCoordinates.getDHFactor(layer)))); };
+    auto nearEdge = [&](IndexType distance, IndexType layer) { return (distance / modelCoordinates.getDHFactor(layer) < width(layer)); };
+    IndexType NY = modelCoordinates.getNY();
+
+    IndexType sum = modelCoordinates.countGridpoints(nearEdge, nearEdge, [&](IndexType y, IndexType layer, IndexType countX, IndexType countZ, IndexType numX, IndexType numZ) {
+        IndexType counter = countX * numZ;
+        // no damping in y direction at the free surface
+        if (nearEdge(std::min(y, NY - 1 - y), layer) && ((useFreeSurface == 0) || (y / modelCoordinates.getDHFactor(layer) >= width(layer)))) {
+            counter += numX * numZ;
         }
+        counter += numX * countZ;
+        return (counter);
+    });
 
-        if (zDist < width) {
-            counter++;
-        }
-    }
-    IndexType sum=dist->getCommunicator().sum(counter);
     IndexType numVectorsPerDim = 6;
     return(sum * sizeof(ValueType) * numVectorsPerDim / (1024 * 1024));
 }
@@ -1,8 +1,34 @@
 #include "Derivatives.hpp"
 #include "../Common/Common.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <thread>
+
 using namespace scai;
 
+namespace
+{
+    /*! \brief Run work(chunk) for all chunks, every chunk on its own thread
+     *
+     * Chunk 0 runs on the calling thread. Exceptions of the threads are passed on to the caller.
+     \param numChunks Number of chunks
+     \param work Function which processes one chunk
+     */
+    void runChunks(IndexType numChunks, std::function<void(IndexType)> const &work)
+    {
+        std::vector<std::future<void>> helpers;
+        for (IndexType chunk = 1; chunk < numChunks; chunk++) {
+            helpers.push_back(std::async(std::launch::async, work, chunk));
+        }
+        work(0);
+        for (auto &helper : helpers) {
+            helper.get();
+        }
+    }
+}
+
 //! \brief Setup configuration of the derivative object
 /*!
  *
@@ -23,6 +49,11 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::setup(Configura
     DT = config.get<ValueType>("DT");
     setFDCoef();
 
+    numAssemblyThreads = config.getAndCatch("numAssemblyThreads", 0);
+    sparseFormat = config.getAndCatch("sparseFormat", std::string("CSR"));
+    maxPaddingELL = config.getAndCatch("sparseFormatMaxPadding", ValueType(1.3));
+    SCAI_ASSERT_ERROR(sparseFormat == "CSR" || sparseFormat == "ELL" || sparseFormat == "JDS" || sparseFormat == "auto", "unknown sparseFormat = " << sparseFormat);
+
     try {
         useStencilMatrix = config.get<bool>("useStencilMatrix");
     } catch (...) {
@@ -74,6 +105,11 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::setup(Configura
 
     DT = config.get<ValueType>("DT");
 
+    numAssemblyThreads = config.getAndCatch("numAssemblyThreads", 0);
+    sparseFormat = config.getAndCatch("sparseFormat", std::string("CSR"));
+    maxPaddingELL = config.getAndCatch("sparseFormatMaxPadding", ValueType(1.3));
+    SCAI_ASSERT_ERROR(sparseFormat == "CSR" || sparseFormat == "ELL" || sparseFormat == "JDS" || sparseFormat == "auto", "unknown sparseFormat = " << sparseFormat);
+
     useStencilMatrix = false;
     useHybridFreeSurface = false;
 
@@ -103,6 +139,122 @@ ValueType KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getMemoryU
     return (size + sizeInterp);
 }
 
+/*! \brief Finish the current row
+ *
+ * Sorts the entries of the row by their column index. An entry which is pushed twice for the same column keeps the last value.
+ \param rowStart Position of the first entry of the row in columns and values
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::RowAssembly::finishRow(IndexType rowStart)
+{
+    IndexType rowEnd = columns.size();
+
+    // insertion sort, the rows have only a few entries
+    for (IndexType i = rowStart + 1; i < rowEnd; i++) {
+        IndexType column = columns[i];
+        ValueType value = values[i];
+        IndexType k = i;
+        for (; k > rowStart && columns[k - 1] > column; k--) {
+            columns[k] = columns[k - 1];
+            values[k] = values[k - 1];
+        }
+        columns[k] = column;
+        values[k] = value;
+    }
+
+    IndexType rowLength = 0;
+    for (IndexType i = rowStart; i < rowEnd; i++) {
+        if (rowLength > 0 && columns[rowStart + rowLength - 1] == columns[i]) {
+            values[rowStart + rowLength - 1] = values[i];
+        } else {
+            columns[rowStart + rowLength] = columns[i];
+            values[rowStart + rowLength] = values[i];
+            rowLength++;
+        }
+    }
+    columns.resize(rowStart + rowLength);
+    values.resize(rowStart + rowLength);
+    rowLengths.push_back(rowLength);
+}
+
+/*! \brief Assemble a sparse matrix row by row with several threads
+ *
+ * The owned rows are split into contiguous chunks, one per thread. Every thread calls rowFunction(ownedIndex, assembly) for the rows of its chunk,
+ * which pushes the entries of the row like a lama::MatrixAssembly. The row lengths of all chunks give the row offsets of the local CSR storage (count pass),
+ * then every thread copies its chunk into the pre-sized CSR arrays (fill pass). The matrix is built from the local storage without a MatrixAssembly and a COO conversion.
+ * The number of threads is numAssemblyThreads, by default the number of cores of the node divided by the number of processes of the node.
+ \param matrix Sparse matrix, distributed with dist for rows and columns
+ \param dist Distribution
+ \param rowFunction Function which pushes the entries of one row, has to be thread safe
+ */
+template <typename ValueType>
+template <typename RowFunction>
+void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::assembleRows(scai::lama::CSRSparseMatrix<ValueType> &matrix, scai::dmemo::DistributionPtr dist, RowFunction const &rowFunction) const
+{
+    SCAI_REGION("Derivatives.assembleRows")
+
+    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
+    dist->getOwnedIndexes(ownedIndexes);
+    IndexType numRows = ownedIndexes.size();
+
+    IndexType numThreads = numAssemblyThreads;
+    if (numThreads <= 0) {
+        numThreads = IndexType(std::thread::hardware_concurrency()) / dist->getCommunicatorPtr()->getNodeSize();
+    }
+    numThreads = std::max(std::min(numThreads, numRows / minAssemblyRows), IndexType(1));
+
+    std::vector<RowAssembly> chunks(numThreads);
+    {
+        auto read_ownedIndexes = hmemo::hostReadAccess(ownedIndexes);
+        runChunks(numThreads, [&](IndexType chunk) {
+            IndexType firstRow = chunk * numRows / numThreads;
+            IndexType endRow = (chunk + 1) * numRows / numThreads;
+            RowAssembly &assembly = chunks[chunk];
+            assembly.rowLengths.reserve(endRow - firstRow);
+            for (IndexType localRow = firstRow; localRow < endRow; localRow++) {
+                IndexType rowStart = assembly.columns.size();
+                rowFunction(read_ownedIndexes[localRow], assembly);
+                assembly.finishRow(rowStart);
+            }
+        });
+    }
+
+    // count pass: row offsets from the row lengths of the chunks
+    hmemo::HArray<IndexType> ia(numRows + 1);
+    std::vector<IndexType> chunkOffsets(numThreads + 1, 0);
+    {
+        auto write_ia = hmemo::hostWriteAccess(ia);
+        IndexType localRow = 0;
+        write_ia[0] = 0;
+        for (IndexType chunk = 0; chunk < numThreads; chunk++) {
+            for (auto rowLength : chunks[chunk].rowLengths) {
+                write_ia[localRow + 1] = write_ia[localRow] + rowLength;
+                localRow++;
+            }
+            chunkOffsets[chunk + 1] = write_ia[localRow];
+        }
+    }
+
+    // fill pass: every thread copies its chunk into the CSR arrays
+    IndexType numValues = chunkOffsets[numThreads];
+    hmemo::HArray<IndexType> ja(numValues);
+    hmemo::HArray<ValueType> values(numValues);
+    {
+        auto write_ja = hmemo::hostWriteAccess(ja);
+        auto write_values = hmemo::hostWriteAccess(values);
+        runChunks(numThreads, [&](IndexType chunk) {
+            std::copy(chunks[chunk].columns.begin(), chunks[chunk].columns.end(), write_ja.get() + chunkOffsets[chunk]);
+            std::copy(chunks[chunk].values.begin(), chunks[chunk].values.end(), write_values.get() + chunkOffsets[chunk]);
+            chunks[chunk] = RowAssembly();
+        });
+    }
+
+    // local storage with global column indices, the halo is built by the column distribution
+    lama::CSRStorage<ValueType> localStorage(numRows, dist->getGlobalSize(), std::move(ia), std::move(ja), std::move(values));
+    matrix = SparseFormat(dist, std::move(localStorage));
+    matrix.redistribute(dist, dist);
+}
+
 //! \brief Calculate Dxf matrix
 /*!
  *
@@ -129,18 +281,12 @@ template <typename ValueType>
 void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDxf(Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::dmemo::DistributionPtr dist)
 {
     SCAI_REGION("Derivatives.calcDxfSparse")
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType X = 0;
-    IndexType Xmin = 0;
-    IndexType Xmax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DxfSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType X = 0;
+        IndexType Xmin = 0;
+        IndexType Xmax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         const IndexType &dhFactor = modelCoordinates.getDHFactor(coordinate);
@@ -175,13 +321,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDxf(Acquisi
                 j--;
             } else if ((Xmin >= 0) && (Xmax < modelCoordinates.getNX())) {
                 columnIndex = modelCoordinates.coordinate2index(X, coordinate.y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DxfSparse = lama::zero<SparseFormat>(dist, dist);
-    DxfSparse.fillFromAssembly(assembly);
+    });
 //     DxfSparse.writeToFile("model/DxfSparse.mtx");
 }
 
@@ -210,21 +353,15 @@ template <typename ValueType>
 void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyf(Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::dmemo::DistributionPtr dist)
 {
     SCAI_REGION("Derivatives.calcDyfSparse")
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    IndexType Ymin = 0;
-    IndexType Ymax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-    ValueType DH = 0;
-    IndexType dhFactor = 0;
-    IndexType layer = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DyfSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType Ymin = 0;
+        IndexType Ymax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
+        ValueType DH = 0;
+        IndexType dhFactor = 0;
+        IndexType layer = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -269,13 +406,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyf(Acquisi
                 j--;
             } else if ((Ymin >= 0) && (Ymax < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, Y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / DH);
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / DH);
             }
         }
-    }
-
-    DyfSparse = lama::zero<SparseFormat>(dist, dist);
-    DyfSparse.fillFromAssembly(assembly);
+    });
 //     DyfSparse.writeToFile("model/DyfSparse.mtx");
 }
 
@@ -304,18 +438,12 @@ template <typename ValueType>
 void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDzf(Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::dmemo::DistributionPtr dist)
 {
     SCAI_REGION("Derivatives.calcDzfSparse")
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    // assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Z = 0;
-    IndexType Zmin = 0;
-    IndexType Zmax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DzfSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Z = 0;
+        IndexType Zmin = 0;
+        IndexType Zmax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -350,12 +478,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDzf(Acquisi
                 j--;
             } else if ((Zmin >= 0) && (Zmax < modelCoordinates.getNZ())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, coordinate.y, Z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-    DzfSparse = lama::zero<SparseFormat>(dist, dist);
-    DzfSparse.fillFromAssembly(assembly);
+    });
 }
 //! \brief Calculate DyfFreeSurface matrix
 /*!
@@ -367,17 +493,11 @@ template <typename ValueType>
 void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfFreeSurface(Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::dmemo::DistributionPtr dist)
 {
     SCAI_REGION("Derivatives.calcDyfFreeSurface")
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-
-    const ValueType ZERO = 0;
+    assembleRows(DyfFreeSurfaceSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        const ValueType ZERO = 0;
 
-    ValueType DH = ZERO;
-    IndexType dhFactor = ZERO;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+        ValueType DH = ZERO;
+        IndexType dhFactor = ZERO;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         IndexType layer = modelCoordinates.getLayer(coordinate);
@@ -407,12 +527,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfFreeSurf
         for (IndexType j = 0; j < spatialFDorder; j++) {
             IndexType Y = coordinate.y + dhFactor * (j - spatialFDorder / 2 + 1);
 
-            ValueType fdCoeff = stencilFDmap[spatialFDorder].values()[j];
+            ValueType fdCoeff = stencilFDmap.at(spatialFDorder).values()[j];
             ValueType diffCoeff = ZERO;
 
             if (spatialFDorder >= (2 + 2 * coordinate.y / dhFactor + j)) {
                 IndexType ImageIndex = spatialFDorder - 2 - 2 * coordinate.y / dhFactor - j;
-                diffCoeff = stencilFDmap[spatialFDorder].values()[ImageIndex];
+                diffCoeff = stencilFDmap.at(spatialFDorder).values()[ImageIndex];
             }
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
@@ -423,10 +543,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfFreeSurf
                     assembly.push(ownedIndex, columnIndex, -diffCoeff / DH); // push only diffs to stencil matrix
             }
         }
-    }
-
-    DyfFreeSurfaceSparse = lama::zero<SparseFormat>(dist, dist);
-    DyfFreeSurfaceSparse.fillFromAssembly(assembly);
+    });
 //     DyfFreeSurfaceSparse.writeToFile("model/DyfFreeSurfaceSparse.mtx");
 
     if (useHybridFreeSurface) {
@@ -449,14 +566,8 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybFreeSurf
 {
     SCAI_REGION("Derivatives.calcDybFreeSurface")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-
-    const ValueType ZERO = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybFreeSurfaceSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        const ValueType ZERO = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         const IndexType &layer = modelCoordinates.getLayer(coordinate);
@@ -489,12 +600,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybFreeSurf
                     Y += modelCoordinates.getDHFactor(layer + 1);
             }
 
-            ValueType fdCoeff = stencilFDmap[spatialFDorder].values()[j];
+            ValueType fdCoeff = stencilFDmap.at(spatialFDorder).values()[j];
             ValueType diffCoeff = ZERO;
 
             if (spatialFDorder >= (1 + 2 * coordinate.y / dhFactor + j)) {
                 IndexType ImageIndex = spatialFDorder - 1 - 2 * coordinate.y / dhFactor - j;
-                diffCoeff = stencilFDmap[spatialFDorder].values()[ImageIndex];
+                diffCoeff = stencilFDmap.at(spatialFDorder).values()[ImageIndex];
             }
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
@@ -505,10 +616,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybFreeSurf
                     assembly.push(ownedIndex, columnIndex, -diffCoeff / modelCoordinates.getDH(coordinate)); // push only diffs to stencil matrix
             }
         }
-    }
-
-    DybFreeSurfaceSparse = lama::zero<SparseFormat>(dist, dist);
-    DybFreeSurfaceSparse.fillFromAssembly(assembly);
+    });
 
     if (useHybridFreeSurface) {
         // define the stencil matrix for hybrid matrix
@@ -535,18 +643,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 {
     SCAI_REGION("Derivatives.calcDybStaggeredXFreeSurface")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    // assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    ValueType fdCoeff = 0;
-    IndexType ImageIndex = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybStaggeredXFreeSurface, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        ValueType fdCoeff = 0;
+        IndexType ImageIndex = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         const IndexType &layer = modelCoordinates.getLayer(coordinate);
@@ -592,11 +694,11 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
                     Y += modelCoordinates.getDHFactor(layer + 1);
             }
 
-            fdCoeff = stencilFDmap[spatialFDorder].values()[j];
+            fdCoeff = stencilFDmap.at(spatialFDorder).values()[j];
 
             if (spatialFDorder >= (1 + 2 * coordinate.y / dhFactor + j)) {
                 ImageIndex = spatialFDorder - 1 - 2 * coordinate.y / dhFactor - j;
-                fdCoeff -= stencilFDmap[spatialFDorder].values()[ImageIndex];
+                fdCoeff -= stencilFDmap.at(spatialFDorder).values()[ImageIndex];
             }
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
@@ -604,10 +706,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
                 assembly.push(ownedIndex, columnIndex, fdCoeff / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DybStaggeredXFreeSurface = lama::zero<SparseFormat>(dist, dist);
-    DybStaggeredXFreeSurface.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate DybFreeSurface matrix
@@ -620,18 +719,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 {
     SCAI_REGION("Derivatives.calcDybStaggeredZFreeSurface")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    // assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    ValueType fdCoeff = 0;
-    IndexType ImageIndex = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybStaggeredZFreeSurface, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        ValueType fdCoeff = 0;
+        IndexType ImageIndex = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         const IndexType &layer = modelCoordinates.getLayer(coordinate);
@@ -678,11 +771,11 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
                     Y += modelCoordinates.getDHFactor(layer + 1);
             }
 
-            fdCoeff = stencilFDmap[spatialFDorder].values()[j];
+            fdCoeff = stencilFDmap.at(spatialFDorder).values()[j];
 
             if (spatialFDorder >= (1 + 2 * coordinate.y / dhFactor + j)) {
                 ImageIndex = spatialFDorder - 1 - 2 * coordinate.y / dhFactor - j;
-                fdCoeff -= stencilFDmap[spatialFDorder].values()[ImageIndex];
+                fdCoeff -= stencilFDmap.at(spatialFDorder).values()[ImageIndex];
             }
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
@@ -690,10 +783,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
                 assembly.push(ownedIndex, columnIndex, fdCoeff / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DybStaggeredZFreeSurface = lama::zero<SparseFormat>(dist, dist);
-    DybStaggeredZFreeSurface.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate Dxb sparse matrix
@@ -706,18 +796,12 @@ template <typename ValueType>
 void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDxb(Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::dmemo::DistributionPtr dist)
 {
     SCAI_REGION("Derivatives.calcDxbSparse")
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType X = 0;
-    IndexType Xmin = 0;
-    IndexType Xmax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DxbSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType X = 0;
+        IndexType Xmin = 0;
+        IndexType Xmax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         const IndexType &dhFactor = modelCoordinates.getDHFactor(coordinate);
@@ -752,13 +836,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDxb(Acquisi
                 j--;
             } else if ((Xmin >= 0) && (Xmax < modelCoordinates.getNX())) {
                 columnIndex = modelCoordinates.coordinate2index(X, coordinate.y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DxbSparse = lama::zero<SparseFormat>(dist, dist);
-    DxbSparse.fillFromAssembly(assembly);
+    });
 //     DxbSparse.writeToFile("model/DxbSparse.mtx");
 }
 
@@ -772,18 +853,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyb(Acquisi
 {
     SCAI_REGION("Derivatives.calcDybSparse")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    IndexType Ymin = 0;
-    IndexType Ymax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType Ymin = 0;
+        IndexType Ymax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -832,13 +907,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyb(Acquisi
                 j--;
             } else if ((Ymin >= 0) && (Ymax < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, Y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DybSparse = lama::zero<SparseFormat>(dist, dist);
-    DybSparse.fillFromAssembly(assembly);
+    });
 //     DybSparse.writeToFile("model/DybSparse.mtx");
 }
 
@@ -853,20 +925,13 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfStaggere
 {
     SCAI_REGION("Derivatives.calcDyfStaggeredX")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-
-    IndexType Y = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-    ValueType DH = 0;
-    IndexType dhFactor = 0;
-    IndexType layer = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DyfStaggeredXSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
+        ValueType DH = 0;
+        IndexType dhFactor = 0;
+        IndexType layer = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         layer = modelCoordinates.getLayer(coordinate);
@@ -920,13 +985,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfStaggere
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(X[j], Y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / DH);
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / DH);
             }
         }
-    }
-
-    DyfStaggeredXSparse = lama::zero<SparseFormat>(dist, dist);
-    DyfStaggeredXSparse.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate DybStaggeredX matrix
@@ -939,16 +1001,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 {
     SCAI_REGION("Derivatives.calcDybStaggeredX")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybStaggeredXSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D const coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -994,13 +1050,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(X[j], Y, coordinate.z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DybStaggeredXSparse = lama::zero<SparseFormat>(dist, dist);
-    DybStaggeredXSparse.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate Dyf sparse matrix
@@ -1014,20 +1067,13 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfStaggere
 {
     SCAI_REGION("Derivatives.calcDyfStaggeredZ")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-
-    IndexType Y = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-    ValueType DH = 0;
-    IndexType dhFactor = 0;
-    IndexType layer = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DyfStaggeredZSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
+        ValueType DH = 0;
+        IndexType dhFactor = 0;
+        IndexType layer = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
         layer = modelCoordinates.getLayer(coordinate);
@@ -1082,13 +1128,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDyfStaggere
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, Y, Z[j]);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / DH);
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / DH);
             }
         }
-    }
-
-    DyfStaggeredZSparse = lama::zero<SparseFormat>(dist, dist);
-    DyfStaggeredZSparse.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate DybStaggeredX matrix
@@ -1101,16 +1144,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 {
     SCAI_REGION("Derivatives.calcDybStaggeredZ")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Y = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DybStaggeredZSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Y = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -1158,13 +1195,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDybStaggere
 
             if ((Y >= 0) && (Y < modelCoordinates.getNY())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, Y, Z[j]);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-
-    DybStaggeredZSparse = lama::zero<SparseFormat>(dist, dist);
-    DybStaggeredZSparse.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate Dzb sparse matrix
@@ -1178,18 +1212,12 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDzb(Acquisi
 {
     SCAI_REGION("Derivatives.calcDzbSparse")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 6);
-    IndexType Z = 0;
-    IndexType Zmin = 0;
-    IndexType Zmax = 0;
-    IndexType columnIndex = 0;
-    IndexType j = 0;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+    assembleRows(DzbSparse, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        IndexType Z = 0;
+        IndexType Zmin = 0;
+        IndexType Zmax = 0;
+        IndexType columnIndex = 0;
+        IndexType j = 0;
 
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
@@ -1225,12 +1253,10 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcDzb(Acquisi
                 j--;
             } else if ((Zmin >= 0) && (Zmax < modelCoordinates.getNZ())) {
                 columnIndex = modelCoordinates.coordinate2index(coordinate.x, coordinate.y, Z);
-                assembly.push(ownedIndex, columnIndex, stencilFDmap[spatialFDorder].values()[j] / modelCoordinates.getDH(coordinate));
+                assembly.push(ownedIndex, columnIndex, stencilFDmap.at(spatialFDorder).values()[j] / modelCoordinates.getDH(coordinate));
             }
         }
-    }
-    DzbSparse = lama::zero<SparseFormat>(dist, dist);
-    DzbSparse.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate interpolation Matrix acoustic (2D/3D) variable grid simulations
@@ -1253,21 +1279,14 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
 {
     SCAI_REGION("Derivatives.calcInterpolationFull")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 2);
-
-    ValueType denom = 0;
-    IndexType dhFactorFineGrid = 0;
-    IndexType modx = 0;
-    IndexType modz = 0;
-    ValueType value;
-    IndexType index;
+    assembleRows(InterpolationFull, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        ValueType denom = 0;
+        IndexType dhFactorFineGrid = 0;
+        IndexType modx = 0;
+        IndexType modz = 0;
+        ValueType value;
+        IndexType index;
 
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
         const IndexType &x = coordinate.x;
@@ -1330,11 +1349,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
                 assembly.push(ownedIndex, index, value);
             }
         }
-    }
-    // auto colDist = std::make_shared<dmemo::NoDistribution( dist.getGlobalSize() );
-    InterpolationFull = lama::zero<SparseFormat>(dist, dist);
-
-    InterpolationFull.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate interpolation Matrix acoustic (2D/3D) variable grid simulations
@@ -1357,21 +1372,14 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
 {
     SCAI_REGION("Derivatives.calcInterpolationStaggeredX")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    // assembly.reserve(ownedIndexes.size() * 2);
-
-    ValueType denom = 0;
-    IndexType dhFactorFineGrid = 0;
-    IndexType modx = 0;
-    IndexType modz = 0;
-    ValueType value;
-    IndexType index;
+    assembleRows(InterpolationStaggeredX, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        ValueType denom = 0;
+        IndexType dhFactorFineGrid = 0;
+        IndexType modx = 0;
+        IndexType modz = 0;
+        ValueType value;
+        IndexType index;
 
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
         const IndexType &x = coordinate.x;
@@ -1436,11 +1444,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
                 assembly.push(ownedIndex, index, value);
             }
         }
-    }
-    // auto colDist = std::make_shared<dmemo::NoDistribution( dist.getGlobalSize() );
-    InterpolationStaggeredX = lama::zero<SparseFormat>(dist, dist);
-
-    InterpolationStaggeredX.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate interpolation Matrix acoustic (2D/3D) variable grid simulations
@@ -1463,21 +1467,14 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
 {
     SCAI_REGION("Derivatives.calcInterpolationStaggeredZ")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
+    assembleRows(InterpolationStaggeredZ, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        ValueType denom = 0;
+        IndexType dhFactorFineGrid = 0;
+        IndexType modx = 0;
+        IndexType modz = 0;
+        ValueType value;
+        IndexType index;
 
-    dist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 2);
-
-    ValueType denom = 0;
-    IndexType dhFactorFineGrid = 0;
-    IndexType modx = 0;
-    IndexType modz = 0;
-    ValueType value;
-    IndexType index;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
         const IndexType &x = coordinate.x;
@@ -1542,11 +1539,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
                 assembly.push(ownedIndex, index, value);
             }
         }
-    }
-    // auto colDist = std::make_shared<dmemo::NoDistribution( dist.getGlobalSize() );
-    InterpolationStaggeredZ = lama::zero<SparseFormat>(dist, dist);
-
-    InterpolationStaggeredZ.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief Calculate interpolation Matrix acoustic (2D/3D) variable grid simulations
@@ -1569,21 +1562,14 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
 {
     SCAI_REGION("Derivatives.calcInterpolationStaggeredXZ")
 
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-
-    dist->getOwnedIndexes(ownedIndexes);
+    assembleRows(InterpolationStaggeredXZ, dist, [&](IndexType ownedIndex, RowAssembly &assembly) {
+        ValueType denom = 0;
+        IndexType dhFactorFineGrid = 0;
+        IndexType modx = 0;
+        IndexType modz = 0;
+        ValueType value;
+        IndexType index;
 
-    lama::MatrixAssembly<ValueType> assembly;
-    //assembly.reserve(ownedIndexes.size() * 2);
-
-    ValueType denom = 0;
-    IndexType dhFactorFineGrid = 0;
-    IndexType modx = 0;
-    IndexType modz = 0;
-    ValueType value;
-    IndexType index;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
         Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(ownedIndex);
 
         const IndexType &x = coordinate.x;
@@ -1648,11 +1634,7 @@ void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::calcInterpolati
                 assembly.push(ownedIndex, index, value);
             }
         }
-    }
-    // auto colDist = std::make_shared<dmemo::NoDistribution( dist.getGlobalSize() );
-    InterpolationStaggeredXZ = lama::zero<SparseFormat>(dist, dist);
-
-    InterpolationStaggeredXZ.fillFromAssembly(assembly);
+    });
 }
 
 //! \brief set variable FDorder
@@ -1772,7 +1754,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDybFreeSurface() const
 {
     if (!useHybridFreeSurface)
-        return DybFreeSurfaceSparse;
+        return (select(DybFreeSurfaceSparse));
     else
         return DybFreeSurfaceHybrid;
 }
@@ -1791,9 +1773,9 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDybStaggeredXFreeSurface() const
 {
     if ((isElastic) && (useVarGrid)) {
-        return (DybStaggeredXFreeSurface);
+        return (select(DybStaggeredXFreeSurface));
     } else if (!useHybridFreeSurface) {
-        return DybFreeSurfaceSparse;
+        return (select(DybFreeSurfaceSparse));
     } else {
         return DybFreeSurfaceHybrid;
     }
@@ -1804,9 +1786,9 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDybStaggeredZFreeSurface() const
 {
     if ((isElastic) && (useVarGrid)) {
-        return (DybStaggeredZFreeSurface);
+        return (select(DybStaggeredZFreeSurface));
     } else if (!useHybridFreeSurface) {
-        return DybFreeSurfaceSparse;
+        return (select(DybFreeSurfaceSparse));
     } else {
         return DybFreeSurfaceHybrid;
     }
@@ -1817,7 +1799,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDyfFreeSurface() const
 {
     if (!useHybridFreeSurface)
-        return DyfFreeSurfaceSparse;
+        return (select(DyfFreeSurfaceSparse));
     else
         return DyfFreeSurfaceHybrid;
 }
@@ -1839,7 +1821,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dxf);
     else
-        return (DxfSparse);
+        return (select(DxfSparse));
 }
 
 //! \brief Getter method for derivative matrix Dyf
@@ -1849,7 +1831,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dyf);
     else
-        return (DyfSparse);
+        return (select(DyfSparse));
 }
 
 //! \brief Getter method for derivative matrix Dyf
@@ -1867,11 +1849,11 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDyfStaggeredX() const
 {
     if ((isElastic) && (useVarGrid))
-        return (DyfStaggeredXSparse);
+        return (select(DyfStaggeredXSparse));
     else if (useStencilMatrix)
         return (Dyf);
     else
-        return (DyfSparse);
+        return (select(DyfSparse));
 }
 
 //! \brief Getter method for derivative matrix DybStaggeredX
@@ -1879,22 +1861,22 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDybStaggeredX() const
 {
     if ((isElastic) && (useVarGrid))
-        return (DybStaggeredXSparse);
+        return (select(DybStaggeredXSparse));
     else if (useStencilMatrix)
         return (Dyb);
     else
-        return (DybSparse);
+        return (select(DybSparse));
 }
 //! \brief Getter method for derivative matrix DyfStaggeredZ
 template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDyfStaggeredZ() const
 {
     if ((isElastic) && (useVarGrid))
-        return (DyfStaggeredZSparse);
+        return (select(DyfStaggeredZSparse));
     else if (useStencilMatrix)
         return (Dyf);
     else
-        return (DyfSparse);
+        return (select(DyfSparse));
 }
 
 //! \brief Getter method for derivative matrix DybStaggeredX
@@ -1902,11 +1884,11 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getDybStaggeredZ() const
 {
     if ((isElastic) && (useVarGrid))
-        return (DybStaggeredZSparse);
+        return (select(DybStaggeredZSparse));
     else if (useStencilMatrix)
         return (Dyb);
     else
-        return (DybSparse);
+        return (select(DybSparse));
 }
 
 //! \brief Getter method for derivative matrix Dzf
@@ -1916,7 +1898,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dzf);
     else
-        return (DzfSparse);
+        return (select(DzfSparse));
 }
 
 //! \brief Getter method for derivative matrix Dxb
@@ -1926,7 +1908,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dxb);
     else
-        return (DxbSparse);
+        return (select(DxbSparse));
 }
 
 //! \brief Getter method for derivative matrix Dyb
@@ -1936,7 +1918,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dyb);
     else
-        return (DybSparse);
+        return (select(DybSparse));
 }
 
 //! \brief Getter method for derivative matrix Dzb
@@ -1946,7 +1928,7 @@ scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivat
     if (useStencilMatrix)
         return (Dzb);
     else
-        return (DzbSparse);
+        return (select(DzbSparse));
 }
 
 //! \brief Getter method for derivative interpolation matrix of P
@@ -1954,7 +1936,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const *KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getInterFull() const
 {
     if (InterpolationFull.getNumRows() > 0) {
-        return &InterpolationFull;
+        return &select(InterpolationFull);
     } else {
         return NULL;
     }
@@ -1965,7 +1947,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const *KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getInterStaggeredX() const
 {
     if (InterpolationStaggeredX.getNumRows() > 0) {
-        return &InterpolationStaggeredX;
+        return &select(InterpolationStaggeredX);
     } else {
         return NULL;
     }
@@ -1976,7 +1958,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const *KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getInterStaggeredZ() const
 {
     if (InterpolationStaggeredZ.getNumRows() > 0) {
-        return &InterpolationStaggeredZ;
+        return &select(InterpolationStaggeredZ);
     } else {
         return NULL;
     }
@@ -1987,7 +1969,7 @@ template <typename ValueType>
 scai::lama::Matrix<ValueType> const *KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::getInterStaggeredXZ() const
 {
     if (InterpolationStaggeredXZ.getNumRows() > 0) {
-        return &InterpolationStaggeredXZ;
+        return &select(InterpolationStaggeredXZ);
     } else {
         return NULL;
     }
@@ -2051,12 +2033,93 @@ KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType> &KITGPI::ForwardSolve
     Dxf = rhs.Dxf;
     Dyf = rhs.Dyf;
     Dzf = rhs.Dzf;
-    DxfSparse = rhs.DxfSparse;
-    DyfSparse = rhs.DyfSparse;
-    DzfSparse = rhs.DzfSparse;
+    // converted matrices are copied back to CSR
+    DxfSparse.assign(rhs.select(rhs.DxfSparse));
+    DyfSparse.assign(rhs.select(rhs.DyfSparse));
+    DzfSparse.assign(rhs.select(rhs.DzfSparse));
+    convertedMatrices.clear();
     
     return *this;
 }
 
+/*! \brief Convert the sparse matrices to the storage format sparseFormat
+ *
+ * CSR stores a row offset per row and runs a loop of variable length per row. The derivative matrices have nearly the same number of entries in every row,
+ * which suits the ELL format (fixed row length, column-major, vectorised SpMV) or the JDS format (rows sorted by length, no padding).
+ * With sparseFormat = auto ELL is chosen per matrix if the padding (maximum row length times number of rows relative to the number of non-zero values) is at most sparseFormatMaxPadding, otherwise CSR is kept.
+ * The CSR matrix is replaced by an empty matrix of the same size after the conversion, the getters return the converted matrix.
+ \param ctx Context
+ \param comm Communicator
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::convertSparseMatrices(scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr comm)
+{
+    SCAI_REGION("Derivatives.convertSparseMatrices")
+
+    convertedMatrices.clear();
+    if (sparseFormat == "CSR" || useStencilMatrix) {
+        return;
+    }
+
+    std::vector<std::pair<std::string, SparseFormat *>> matrices = {{"Dxf", &DxfSparse}, {"Dyf", &DyfSparse}, {"Dzf", &DzfSparse}, {"Dxb", &DxbSparse}, {"Dyb", &DybSparse}, {"Dzb", &DzbSparse}, {"DyfStaggeredX", &DyfStaggeredXSparse}, {"DybStaggeredX", &DybStaggeredXSparse}, {"DyfStaggeredZ", &DyfStaggeredZSparse}, {"DybStaggeredZ", &DybStaggeredZSparse}, {"DyfFreeSurface", &DyfFreeSurfaceSparse}, {"DybFreeSurface", &DybFreeSurfaceSparse}, {"DybStaggeredXFreeSurface", &DybStaggeredXFreeSurface}, {"DybStaggeredZFreeSurface", &DybStaggeredZFreeSurface}, {"InterpolationFull", &InterpolationFull}, {"InterpolationStaggeredX", &InterpolationStaggeredX}, {"InterpolationStaggeredZ", &InterpolationStaggeredZ}, {"InterpolationStaggeredXZ", &InterpolationStaggeredXZ}};
+
+    for (auto const &entry : matrices) {
+        SparseFormat &matrix = *entry.second;
+        if (matrix.getNumRows() == 0) {
+            continue;
+        }
+
+        // row length statistics of the local part
+        IndexType maxRowLength = 0;
+        {
+            auto read_ia = hmemo::hostReadAccess(matrix.getLocalStorage().getIA());
+            for (IndexType i = 0; i < matrix.getLocalStorage().getNumRows(); i++) {
+                maxRowLength = std::max(maxRowLength, read_ia[i + 1] - read_ia[i]);
+            }
+        }
+        maxRowLength = comm->max(maxRowLength);
+        IndexType numValues = comm->sum(matrix.getLocalStorage().getNumValues());
+        ValueType padding = (numValues > 0) ? ValueType(maxRowLength) * matrix.getNumRows() / numValues : 1;
+
+        std::string format = sparseFormat;
+        if (format == "auto") {
+            format = (padding <= maxPaddingELL) ? "ELL" : "CSR";
+        }
+
+        std::shared_ptr<lama::Matrix<ValueType>> converted;
+        if (format == "ELL") {
+            converted.reset(new lama::ELLSparseMatrix<ValueType>());
+        } else if (format == "JDS") {
+            converted.reset(new lama::JDSSparseMatrix<ValueType>());
+        } else {
+            HOST_PRINT(comm, "", "Matrix " << entry.first << ": CSR (padding " << padding << ")\n");
+            continue;
+        }
+        converted->setContextPtr(ctx);
+        converted->assign(matrix);
+        HOST_PRINT(comm, "", "Matrix " << entry.first << ": " << format << " (padding " << padding << ")\n");
+
+        auto rowDist = matrix.getRowDistributionPtr();
+        auto colDist = matrix.getColDistributionPtr();
+        matrix = lama::zero<SparseFormat>(rowDist, colDist);
+        convertedMatrices[&matrix] = converted;
+    }
+}
+
+/*! \brief Return the converted matrix of a sparse matrix
+ *
+ \param matrix CSR matrix
+ \return converted matrix, the CSR matrix itself if it was not converted
+ */
+template <typename ValueType>
+scai::lama::Matrix<ValueType> const &KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType>::select(scai::lama::CSRSparseMatrix<ValueType> const &matrix) const
+{
+    auto converted = convertedMatrices.find(&matrix);
+    if (converted != convertedMatrices.end()) {
+        return (*converted->second);
+    }
+    return (matrix);
+}
+
 template class KITGPI::ForwardSolver::Derivatives::Derivatives<float>;
 template class KITGPI::ForwardSolver::Derivatives::Derivatives<double>;
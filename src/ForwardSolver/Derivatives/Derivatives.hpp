@@ -3,9 +3,12 @@
 #include "../../Common/HostPrint.hpp"
 #include "../../Configuration/Configuration.hpp"
 #include <map>
+#include <memory>
 #include <scai/common/Stencil.hpp>
 #include <scai/lama.hpp>
+#include <scai/lama/matrix/ELLSparseMatrix.hpp>
 #include <scai/lama/matrix/HybridMatrix.hpp>
+#include <scai/lama/matrix/JDSSparseMatrix.hpp>
 #include <scai/lama/matrix/MatrixAssembly.hpp>
 #include <scai/lama/matrix/StencilMatrix.hpp>
 #include <scai/tracing.hpp>
@@ -217,6 +220,30 @@ namespace KITGPI
 
                 void setFDOrder(scai::IndexType FDorder);
 
+                //! \brief Entries of the rows which are assembled by one thread (see assembleRows)
+                class RowAssembly
+                {
+                  public:
+                    //! \brief Push an entry of the current row (same interface as lama::MatrixAssembly)
+                    void push(scai::IndexType /*row*/, scai::IndexType column, ValueType value)
+                    {
+                        columns.push_back(column);
+                        values.push_back(value);
+                    }
+
+                    void finishRow(scai::IndexType rowStart);
+
+                    std::vector<scai::IndexType> rowLengths; //!< number of entries of every row
+                    std::vector<scai::IndexType> columns;    //!< global column indices of the entries
+                    std::vector<ValueType> values;           //!< values of the entries
+                };
+
+                template <typename RowFunction>
+                void assembleRows(scai::lama::CSRSparseMatrix<ValueType> &matrix, scai::dmemo::DistributionPtr dist, RowFunction const &rowFunction) const;
+
+                void convertSparseMatrices(scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr comm);
+                scai::lama::Matrix<ValueType> const &select(scai::lama::CSRSparseMatrix<ValueType> const &matrix) const;
+
                 ValueType getMemoryStencilMatrix(scai::dmemo::DistributionPtr dist);
                 ValueType getMemorySparseMatrix(scai::dmemo::DistributionPtr dist);
                 ValueType getMemorySparseMatrix(scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates);
@@ -271,6 +298,14 @@ namespace KITGPI
                 bool isElastic = false;     //!< Switch to use variable Grid
                 bool isSetup = false;
 
+                scai::IndexType numAssemblyThreads = 0;                //!< number of threads of the matrix assembly (0 = cores of the node / processes of the node)
+                static constexpr scai::IndexType minAssemblyRows = 10000; //!< minimum number of rows per assembly thread
+
+                std::string sparseFormat = "CSR"; //!< storage format of the sparse matrices (CSR, ELL, JDS or auto)
+                ValueType maxPaddingELL = 1.3;    //!< maximum ratio of stored to non-zero values for ELL in the automatic format selection
+
+                std::map<scai::lama::CSRSparseMatrix<ValueType> const *, std::shared_ptr<scai::lama::Matrix<ValueType>>> convertedMatrices; //!< sparse matrices converted to sparseFormat
+
               private:
                 std::map<scai::IndexType, scai::common::Stencil1D<ValueType>> stencilFDmap; // FD-stencil
                                                                                             //     scai::IndexType spatialFDorder = 0;                                         //!< FD-Order of spatial derivative stencils
@@ -56,6 +56,8 @@ void KITGPI::ForwardSolver::Derivatives::FDTD2D<ValueType>::init(scai::dmemo::Di
 
     if (useFreeSurface == 1)
         initializeFreeSurfaceMatrices(dist, ctx, modelCoordinates, comm);
+
+    this->convertSparseMatrices(ctx, comm);
 }
 
 //! \brief redistribution of all matrices
@@ -102,6 +104,11 @@ void KITGPI::ForwardSolver::Derivatives::FDTD2D<ValueType>::redistributeMatrices
             }
         }
     }
+
+    // matrices in another storage format than CSR (see convertSparseMatrices)
+    for (auto &converted : this->convertedMatrices) {
+        converted.second->redistribute(dist, dist);
+    }
 }
 
 template <typename ValueType>
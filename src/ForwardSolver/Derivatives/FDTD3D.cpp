@@ -58,6 +58,8 @@ void KITGPI::ForwardSolver::Derivatives::FDTD3D<ValueType>::init(scai::dmemo::Di
     }
     if (useFreeSurface == 1)
         initializeFreeSurfaceMatrices(dist, ctx, modelCoordinates, comm);
+
+    this->convertSparseMatrices(ctx, comm);
 }
 
 //! \brief redistribution of all matrices
@@ -113,6 +115,11 @@ void KITGPI::ForwardSolver::Derivatives::FDTD3D<ValueType>::redistributeMatrices
             }
         }
     }
+
+    // matrices in another storage format than CSR (see convertSparseMatrices)
+    for (auto &converted : this->convertedMatrices) {
+        converted.second->redistribute(dist, dist);
+    }
     HOST_PRINT(dist->getCommunicatorPtr(), "", "finished redistribution of the derivative matrices.\n");
 }
 
@@ -53,5 +53,48 @@ void KITGPI::ForwardSolver::ForwardSolver<ValueType>::prepareBoundaries(Configur
     }
 }
 
+/*! \brief Initialization of the batched modelling of several shots at once
+ *
+ * The batched modelling is only available for selected forward solvers, all other solvers throw an exception.
+ \param derivatives Derivatives matrices
+ \param model Model parameter
+ \param modelCoordinates Coordinate class, which eg. maps 3D coordinates to 1D model indices
+ \param numShotsPerBatch Number of shots which are modelled at once
+ \param nodeSharedMemory Node shared memory for the read-only data of the batch (only used if initialized)
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ForwardSolver<ValueType>::initBatch(Derivatives::Derivatives<ValueType> const & /*derivatives*/, Modelparameter::Modelparameter<ValueType> const & /*model*/, Acquisition::Coordinates<ValueType> const & /*modelCoordinates*/, scai::IndexType /*numShotsPerBatch*/, Common::NodeSharedMemory & /*nodeSharedMemory*/)
+{
+    COMMON_THROWEXCEPTION("Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) is only available for 2D acoustic modelling")
+}
+
+/*! \brief Set the sources and receivers of the shots of the next batch and reset the wavefields
+ *
+ \param receivers Receivers of every shot of the batch
+ \param sources Sources of every shot of the batch
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ForwardSolver<ValueType>::setBatchAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const & /*receivers*/, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const & /*sources*/)
+{
+    COMMON_THROWEXCEPTION("Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) is only available for 2D acoustic modelling")
+}
+
+/*! \brief Run one time step of all shots of the batch
+ *
+ \param t current time sample
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ForwardSolver<ValueType>::runBatch(scai::IndexType /*t*/)
+{
+    COMMON_THROWEXCEPTION("Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) is only available for 2D acoustic modelling")
+}
+
+//! \brief Return the profiler of the sub-steps of the time step
+template <typename ValueType>
+KITGPI::ForwardSolver::KernelProfiler<ValueType> &KITGPI::ForwardSolver::ForwardSolver<ValueType>::getKernelProfiler()
+{
+    return (kernelProfiler);
+}
+
 template class KITGPI::ForwardSolver::ForwardSolver<double>;
 template class KITGPI::ForwardSolver::ForwardSolver<float>;
@@ -5,9 +5,11 @@
 #include "../Acquisition/AcquisitionGeometry.hpp"
 
 #include "../Common/HostPrint.hpp"
+#include "../Common/NodeSharedMemory.hpp"
 #include "../Modelparameter/Modelparameter.hpp"
 #include "../Wavefields/Wavefields.hpp"
 #include "Derivatives/Derivatives.hpp"
+#include "KernelProfiler.hpp"
 #include "SourceReceiverImpl/SourceReceiverImplFactory.hpp"
 
 #include "BoundaryCondition/ABS.hpp"
@@ -51,11 +53,21 @@ namespace KITGPI
 
             virtual void initForwardSolver(Configuration::Configuration const &config, Derivatives::Derivatives<ValueType> &derivatives, Wavefields::Wavefields<ValueType> &wavefield, Modelparameter::Modelparameter<ValueType> const &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::hmemo::ContextPtr ctx, ValueType DT) = 0;
 
+            virtual void initBatch(Derivatives::Derivatives<ValueType> const &derivatives, Modelparameter::Modelparameter<ValueType> const &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::IndexType numShotsPerBatch, Common::NodeSharedMemory &nodeSharedMemory);
+
+            virtual void setBatchAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const &receivers, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const &sources);
+
+            virtual void runBatch(scai::IndexType t);
+
+            KernelProfiler<ValueType> &getKernelProfiler();
+
           protected:
             /* Common */
             scai::IndexType useFreeSurface; //!< Indicator which free surface is in use
             bool useDampingBoundary;        //!< Bool if damping boundary is in use
             bool useConvPML;                //!< Bool if CPML is in use
+
+            KernelProfiler<ValueType> kernelProfiler; //!< timing of the sub-steps of the time step
             
             /* Auxiliary Vectors */
             scai::lama::DenseVector<ValueType> update;
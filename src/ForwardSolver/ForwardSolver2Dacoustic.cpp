@@ -1,4 +1,7 @@
 #include "ForwardSolver2Dacoustic.hpp"
+
+#include <algorithm>
+
 using namespace scai;
 
 template <typename ValueType>
@@ -113,14 +116,18 @@ void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::run(Acquisition::Acquisitio
     auto const *DinterpolateFull = derivatives.getInterFull();
     auto const *DinterpolateStaggeredX = derivatives.getInterStaggeredX();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Dacoustic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
 
     /* ----------------*/
     /* update velocity */
     /* ----------------*/    
     update = Dxf * p;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_p_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseDensityAverageX;
     vX += update;
@@ -142,7 +149,9 @@ void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::run(Acquisition::Acquisitio
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_p_y(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseDensityAverageY;
     vY += update;
@@ -159,14 +168,19 @@ void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::run(Acquisition::Acquisitio
     /* --------------- */
     /* update pressure */
     /* --------------- */
+    kernelProfiler.start(Kernel::StressUpdate);
     update = Dxb * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dyb * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -175,7 +189,9 @@ void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::run(Acquisition::Acquisitio
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(p, vX, vY);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     if (DinterpolateFull) {
@@ -185,12 +201,176 @@ void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::run(Acquisition::Acquisitio
     }
 
     if (useFreeSurface == 1) {
+        kernelProfiler.start(Kernel::FreeSurface);
         FreeSurface.setSurfaceZero(p);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
+}
+
+/*! \brief Initialization of the batched modelling of several shots at once
+ *
+ * The derivative matrices, the material parameters and the boundary coefficients are copied once into host memory.
+ * Has to be called after initForwardSolver and after the model has been prepared for modelling.
+ * Variable grids and distributed shot domains are not supported.
+ \param derivatives Derivatives matrices
+ \param model Model parameter
+ \param modelCoordinates Coordinate class, which eg. maps 3D coordinates to 1D model indices
+ \param numShotsPerBatch Number of shots which are modelled at once
+ \param nodeSharedMemory Node shared memory for the read-only data of the batch (only used if initialized)
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::initBatch(Derivatives::Derivatives<ValueType> const &derivatives, Modelparameter::Modelparameter<ValueType> const &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, IndexType numShotsPerBatch, Common::NodeSharedMemory &nodeSharedMemory)
+{
+    SCAI_REGION("ForwardSolver.initBatch2Dacoustic");
+
+    batch.init(modelCoordinates.getNGridpoints(), numShotsPerBatch, nodeSharedMemory.isActive() ? &nodeSharedMemory : nullptr);
+
+    batch.setMatrix(batchDxf, derivatives.getDxf());
+    batch.setMatrix(batchDxb, derivatives.getDxb());
+    batch.setMatrix(batchDyb, derivatives.getDyb());
+    batchVariableGrid = (derivatives.getInterFull() != NULL);
+    if (batchVariableGrid) {
+        batch.setMatrix(batchInterFull, *derivatives.getInterFull());
+        batch.setMatrix(batchInterStaggeredX, *derivatives.getInterStaggeredX());
+    }
+    if (useFreeSurface == 1) {
+        batch.setMatrix(batchDyf, derivatives.getDyfFreeSurface());
+        std::vector<IndexType> surface;
+        for (IndexType i = 0; i < modelCoordinates.getNGridpoints(); i++) {
+            if (modelCoordinates.locatedOnSurface(i)) {
+                surface.push_back(i);
+            }
+        }
+        batch.setIndex(batchSurface, surface);
+    } else {
+        batch.setMatrix(batchDyf, derivatives.getDyf());
+    }
+
+    batch.setVector(batchPWaveModulus, model.getPWaveModulus());
+    batch.setVector(batchInverseDensityX, model.getInverseDensityAverageX());
+    batch.setVector(batchInverseDensityY, model.getInverseDensityAverageY());
+
+    if (useDampingBoundary) {
+        batch.setVector(batchDamping, DampingBoundary.getDamping());
+    }
+    if (useConvPML) {
+        batch.setCPML(batchCPML_vxx, ConvPML.getA_x(), ConvPML.getB_x());
+        batch.setCPML(batchCPML_vyy, ConvPML.getA_y(), ConvPML.getB_y());
+        batch.setCPML(batchCPML_p_x, ConvPML.getA_x_half(), ConvPML.getB_x_half());
+        batch.setCPML(batchCPML_p_y, ConvPML.getA_y_half(), ConvPML.getB_y_half());
+    }
+
+    batch.allocateField(batchVX);
+    batch.allocateField(batchVY);
+    batch.allocateField(batchP);
+    batch.allocateField(batchUpdate);
+    batch.allocateField(batchUpdateTemp);
+
+    batchFields.assign(Acquisition::SeismogramType::VZ + 1, nullptr);
+    batchFields[Acquisition::SeismogramType::P] = &batchP;
+    batchFields[Acquisition::SeismogramType::VX] = &batchVX;
+    batchFields[Acquisition::SeismogramType::VY] = &batchVY;
+}
+
+/*! \brief Set the sources and receivers of the shots of the next batch and reset the wavefields
+ *
+ \param receivers Receivers of every shot of the batch
+ \param sources Sources of every shot of the batch
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::setBatchAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const &receivers, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const &sources)
+{
+    batch.setAcquisition(receivers, sources);
+
+    std::fill(batchVX.begin(), batchVX.end(), 0.0);
+    std::fill(batchVY.begin(), batchVY.end(), 0.0);
+    std::fill(batchP.begin(), batchP.end(), 0.0);
+    if (useConvPML) {
+        batch.resetCPML(batchCPML_vxx);
+        batch.resetCPML(batchCPML_vyy);
+        batch.resetCPML(batchCPML_p_x);
+        batch.resetCPML(batchCPML_p_y);
+    }
+}
+
+/*! \brief Running one time step of the 2-D acoustic forward solver for all shots of the batch
+ *
+ * The update equations are the same as in run(), but every operator is applied to the interleaved wavefields of all shots at once.
+ \param t current time sample
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::FD2Dacoustic<ValueType>::runBatch(IndexType t)
+{
+    SCAI_REGION("ForwardSolver.timestepBatch2Dacoustic");
+
+    /* ----------------*/
+    /* update velocity */
+    /* ----------------*/
+    batch.multiply(batchUpdate, batchDxf, batchP);
+    if (useConvPML) {
+        batch.applyCPML(batchUpdate, batchCPML_p_x);
+    }
+    batch.addScaled(batchVX, batchInverseDensityX, batchUpdate);
+
+    if (batchVariableGrid) {
+        /* interpolation for vx ghost points at the variable grid interfaces (see run()) */
+        batch.multiply(batchUpdateTemp, batchInterStaggeredX, batchVX);
+        batchVX.swap(batchUpdateTemp);
+    }
+
+    /* Dyf contains the image method if the free surface is used */
+    batch.multiply(batchUpdate, batchDyf, batchP);
+    if (useConvPML) {
+        batch.applyCPML(batchUpdate, batchCPML_p_y);
+    }
+    batch.addScaled(batchVY, batchInverseDensityY, batchUpdate);
+
+    if (batchVariableGrid) {
+        /* interpolation for vy ghost points at the variable grid interfaces (see run()) */
+        batch.multiply(batchUpdateTemp, batchInterFull, batchVY);
+        batchVY.swap(batchUpdateTemp);
+    }
+
+    /* --------------- */
+    /* update pressure */
+    /* --------------- */
+    batch.multiply(batchUpdate, batchDxb, batchVX);
+    if (useConvPML) {
+        batch.applyCPML(batchUpdate, batchCPML_vxx);
+    }
+    batch.multiply(batchUpdateTemp, batchDyb, batchVY);
+    if (useConvPML) {
+        batch.applyCPML(batchUpdateTemp, batchCPML_vyy);
+    }
+    batch.add(batchUpdate, batchUpdateTemp);
+    batch.addScaled(batchP, batchPWaveModulus, batchUpdate);
+
+    /* Apply the damping boundary */
+    if (useDampingBoundary) {
+        batch.scale(batchP, batchDamping);
+        batch.scale(batchVX, batchDamping);
+        batch.scale(batchVY, batchDamping);
+    }
+
+    if (batchVariableGrid) {
+        /* interpolation for missing pressure points */
+        batch.multiply(batchUpdateTemp, batchInterFull, batchP);
+        batchP.swap(batchUpdateTemp);
+    }
+
+    if (useFreeSurface == 1) {
+        batch.setZero(batchP, batchSurface);
+    }
+
+    /* Apply source and save seismogram */
+    batch.applySources(batchFields, t);
+    batch.gatherSeismograms(batchFields, t);
 }
 
 template class KITGPI::ForwardSolver::FD2Dacoustic<float>;
@@ -13,6 +13,7 @@
 #include "BoundaryCondition/CPML2DAcoustic.hpp"
 #include "BoundaryCondition/FreeSurface2Dacoustic.hpp"
 #include "SourceReceiverImpl/FDTD2Dacoustic.hpp"
+#include "ShotBatch.hpp"
 
 namespace KITGPI
 {
@@ -44,6 +45,12 @@ namespace KITGPI
 
             void prepareForModelling(Modelparameter::Modelparameter<ValueType> const & /*model*/, ValueType /*DT*/) override{/*Nothing todo in acoustic modelling*/};
 
+            void initBatch(Derivatives::Derivatives<ValueType> const &derivatives, Modelparameter::Modelparameter<ValueType> const &model, Acquisition::Coordinates<ValueType> const &modelCoordinates, scai::IndexType numShotsPerBatch, Common::NodeSharedMemory &nodeSharedMemory) override;
+
+            void setBatchAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const &receivers, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const &sources) override;
+
+            void runBatch(scai::IndexType t) override;
+
           private:
             /* Boundary Conditions */
             BoundaryCondition::FreeSurface2Dacoustic<ValueType> FreeSurface; //!< Free Surface boundary condition class
@@ -58,6 +65,32 @@ namespace KITGPI
             /* Auxiliary Vectors */
             using ForwardSolver<ValueType>::update;
             using ForwardSolver<ValueType>::update_temp;
+            using ForwardSolver<ValueType>::kernelProfiler;
+
+            /* Batched modelling */
+            ShotBatch<ValueType> batch;                      //!< Interleaved storage and kernels of the batched modelling
+            BatchMatrix<ValueType> batchDxf;                 //!< Derivative matrix Dxf (batched modelling)
+            BatchMatrix<ValueType> batchDxb;                 //!< Derivative matrix Dxb (batched modelling)
+            BatchMatrix<ValueType> batchDyf;                 //!< Derivative matrix Dyf or DyfFreeSurface (batched modelling)
+            BatchMatrix<ValueType> batchDyb;                 //!< Derivative matrix Dyb (batched modelling)
+            BatchMatrix<ValueType> batchInterFull;           //!< Interpolation matrix of the variable grid (batched modelling)
+            BatchMatrix<ValueType> batchInterStaggeredX;     //!< Interpolation matrix of the variable grid for points staggered in x direction (batched modelling)
+            bool batchVariableGrid = false;                  //!< Use the interpolation of the variable grid (batched modelling)
+            Common::NodeSharedArray<ValueType> batchPWaveModulus;    //!< P-wave modulus (batched modelling)
+            Common::NodeSharedArray<ValueType> batchInverseDensityX; //!< averaged inverse density in x direction (batched modelling)
+            Common::NodeSharedArray<ValueType> batchInverseDensityY; //!< averaged inverse density in y direction (batched modelling)
+            Common::NodeSharedArray<ValueType> batchDamping;         //!< damping boundary (batched modelling)
+            Common::NodeSharedArray<scai::IndexType> batchSurface;   //!< gridpoints of the free surface (batched modelling)
+            BatchCPML<ValueType> batchCPML_vxx;              //!< CPML of vxx (batched modelling)
+            BatchCPML<ValueType> batchCPML_vyy;              //!< CPML of vyy (batched modelling)
+            BatchCPML<ValueType> batchCPML_p_x;              //!< CPML of p_x (batched modelling)
+            BatchCPML<ValueType> batchCPML_p_y;              //!< CPML of p_y (batched modelling)
+            std::vector<ValueType> batchVX;                  //!< interleaved wavefield vx
+            std::vector<ValueType> batchVY;                  //!< interleaved wavefield vy
+            std::vector<ValueType> batchP;                   //!< interleaved wavefield p
+            std::vector<ValueType> batchUpdate;              //!< interleaved auxiliary wavefield
+            std::vector<ValueType> batchUpdateTemp;          //!< interleaved auxiliary wavefield
+            std::vector<std::vector<ValueType> *> batchFields; //!< interleaved wavefields indexed by Acquisition::SeismogramType
         };
     } /* end namespace ForwardSolver */
 } /* end namespace KITGPI */
@@ -151,7 +151,9 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     lama::Matrix<ValueType> const *DinterpolateFull = derivatives.getInterFull();
     lama::Matrix<ValueType> const *DinterpolateStaggeredX = derivatives.getInterStaggeredX();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Delastic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* update velocity */
@@ -162,7 +164,9 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------- */
     update = Dxf * Sxx;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxx_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -173,7 +177,9 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -191,7 +197,9 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------- */
     update = Dxb * Sxy;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -202,7 +210,9 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -221,11 +231,14 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------------------- */
     /* update normal stress */
     /* -------------------- */
+    kernelProfiler.start(Kernel::StressUpdate);
     vxx = Dxb * vX;
     vyy = Dyb * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(vxx);
         ConvPML.apply_vyy(vyy);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update = vxx;
@@ -256,12 +269,16 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
     /* ------------------- */
     update = DyfStaggeredX * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dxf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -279,18 +296,24 @@ void KITGPI::ForwardSolver::FD2Delastic<ValueType>::run(Acquisition::Acquisition
 
     /* Apply free surface to horizontal stress update */
     if (useFreeSurface == 1) {
+        kernelProfiler.start(Kernel::FreeSurface);
         FreeSurface.exchangeHorizontalUpdate(vxx, vyy, Sxx);
         FreeSurface.setSurfaceZero(Syy);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxx, Syy, Sxy, vX, vY);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Delastic<float>;
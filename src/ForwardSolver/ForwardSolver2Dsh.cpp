@@ -127,7 +127,9 @@ void KITGPI::ForwardSolver::FD2Dsh<ValueType>::run(Acquisition::AcquisitionGeome
     
     auto const &DybFreeSurface = derivatives.getDybFreeSurface();
         
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Dsh<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
 //     if (useFreeSurface) {
 //         SCAI_ASSERT(useFreeSurface != true, " Stress-image method is not implemented for Love-Waves ");
 //         //         FreeSurface.setModelparameter(model);
@@ -147,8 +149,10 @@ void KITGPI::ForwardSolver::FD2Dsh<ValueType>::run(Acquisition::AcquisitionGeome
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_x(update);
         ConvPML.apply_syz_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -158,10 +162,13 @@ void KITGPI::ForwardSolver::FD2Dsh<ValueType>::run(Acquisition::AcquisitionGeome
     /* ----------------*/
     /*  update stress  */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
 
     update = Dxf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzx(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update *= sWaveModulusAverageXZ;
@@ -170,7 +177,9 @@ void KITGPI::ForwardSolver::FD2Dsh<ValueType>::run(Acquisition::AcquisitionGeome
 
     update = Dyf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update *= sWaveModulusAverageYZ;
 
@@ -184,12 +193,16 @@ void KITGPI::ForwardSolver::FD2Dsh<ValueType>::run(Acquisition::AcquisitionGeome
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxz, Syz, vZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dsh<float>;
@@ -164,14 +164,18 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
     auto const &tauS = model.getTauS();
     auto const &tauP = model.getTauP();
     
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Delastic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* update velocity */
     /* ----------------*/
     update = Dxf * Sxx;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxx_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -181,7 +185,9 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
         update_temp = Dyb * Sxy;
     }
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
     update *= inverseDensityAverageX;
@@ -189,7 +195,9 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
 
     update = Dxb * Sxy;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -199,7 +207,9 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
         update_temp = Dyf * Syy;
     }
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -209,12 +219,15 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* ----------------*/
     /* pressure update */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
 
     vxx = Dxb * vX;
     vyy = Dyb * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(vxx);
         ConvPML.apply_vyy(vyy);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update = vxx;
@@ -273,12 +286,16 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* Update Sxy and Rxy*/
     update = Dyf * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dxf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -300,21 +317,27 @@ void KITGPI::ForwardSolver::FD2Dviscoelastic<ValueType>::run(Acquisition::Acquis
 
     /* Apply free surface to stress update */
     if (useFreeSurface) {
+        kernelProfiler.start(Kernel::FreeSurface);
         FreeSurface.exchangeHorizontalUpdate(vxx, vyy, Sxx, Rxx, DThalf);
         FreeSurface.setSurfaceZero(Syy);
         for (int l=0; l<numRelaxationMechanisms; l++) {
             FreeSurface.setSurfaceZero(Ryy[l]);
         }
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxx, Syy, Sxy, vX, vY);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dviscoelastic<float>;
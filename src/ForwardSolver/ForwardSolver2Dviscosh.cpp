@@ -151,7 +151,9 @@ void KITGPI::ForwardSolver::FD2Dviscosh<ValueType>::run(Acquisition::Acquisition
     
     auto const &DybFreeSurface = derivatives.getDybFreeSurface();
         
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Dsh<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
 //     if (useFreeSurface) {
 //         SCAI_ASSERT(useFreeSurface != true, " Stress-image method is not implemented for Love-Waves ");
 //         //         FreeSurface.setModelparameter(model);
@@ -171,8 +173,10 @@ void KITGPI::ForwardSolver::FD2Dviscosh<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_x(update);
         ConvPML.apply_syz_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -182,11 +186,14 @@ void KITGPI::ForwardSolver::FD2Dviscosh<ValueType>::run(Acquisition::Acquisition
     /* ----------------*/
     /*  update stress  */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     
     /* Update Sxz and Rxz */
     update = Dxf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzx(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update *= sWaveModulusAverageXZ;
     
@@ -207,7 +214,9 @@ void KITGPI::ForwardSolver::FD2Dviscosh<ValueType>::run(Acquisition::Acquisition
     /* Update Syz and Ryz */
     update = Dyf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update *= sWaveModulusAverageYZ;
     
@@ -232,12 +241,16 @@ void KITGPI::ForwardSolver::FD2Dviscosh<ValueType>::run(Acquisition::Acquisition
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxz, Syz, vZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dviscosh<float>;
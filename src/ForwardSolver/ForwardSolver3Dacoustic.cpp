@@ -119,7 +119,9 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     auto const *DinterpolateStaggeredX = derivatives.getInterStaggeredX();
     auto const *DinterpolateStaggeredZ = derivatives.getInterStaggeredZ();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD3Dacoustic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* update velocity */
@@ -130,7 +132,9 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     /* -------- */
     update = Dxf * p;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_p_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseDensityAverageX;
     vX += update;
@@ -154,7 +158,9 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_p_y(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseDensityAverageY;
     vY += update;
@@ -172,7 +178,9 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     /* -------- */
     update = Dzf * p;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_p_z(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseDensityAverageZ;
     vZ += update;
@@ -189,20 +197,27 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     /* --------------- */
     /* update pressure */
     /* --------------- */
+    kernelProfiler.start(Kernel::StressUpdate);
     update = Dxb * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dyb * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
     update_temp = Dzb * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzz(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -211,7 +226,9 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(p, vX, vY, vZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     if (DinterpolateFull) {
@@ -221,12 +238,16 @@ void KITGPI::ForwardSolver::FD3Dacoustic<ValueType>::run(Acquisition::Acquisitio
     }
 
     if (useFreeSurface == 1) {
+        kernelProfiler.start(Kernel::FreeSurface);
         FreeSurface.setSurfaceZero(p);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD3Dacoustic<float>;
@@ -169,7 +169,9 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     lama::Matrix<ValueType> const &DyfStaggeredZ = derivatives.getDyfStaggeredZ();
     lama::Matrix<ValueType> const &DybStaggeredZ = derivatives.getDybStaggeredZ();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD3Delastic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* update velocity */
@@ -180,7 +182,9 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------- */
     update = Dxf * Sxx;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxx_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -191,13 +195,17 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzb * Sxz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
     update *= inverseDensityAverageX;
@@ -214,7 +222,9 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------- */
     update = Dxb * Sxy;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -225,13 +235,17 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzb * Syz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -252,7 +266,9 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------- */
     update = Dxb * Sxz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -263,13 +279,17 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syz_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzf * Szz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_szz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -285,13 +305,16 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     /* -------------------- */
     /* update normal stress */
     /* -------------------- */
+    kernelProfiler.start(Kernel::StressUpdate);
     vxx = Dxb * vX;
     vyy = Dyb * vY;
     vzz = Dzb * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(vxx);
         ConvPML.apply_vyy(vyy);
         ConvPML.apply_vzz(vzz);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update = vxx;
@@ -330,11 +353,15 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
     /* ------------------- */
     update = DyfStaggeredX * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update_temp = Dxf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update += update_temp;
@@ -352,11 +379,15 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
 
     update = Dzf * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxz(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update_temp = Dxf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update += update_temp;
@@ -371,11 +402,15 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
 
     update = Dzf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyz(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update_temp = DyfStaggeredZ * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
     update *= sWaveModulusAverageYZ;
@@ -398,19 +433,25 @@ void KITGPI::ForwardSolver::FD3Delastic<ValueType>::run(Acquisition::Acquisition
 
     /* Apply free surface to stress update */
     if (useFreeSurface == 1) {
+        kernelProfiler.start(Kernel::FreeSurface);
         update = vxx + vzz;
         FreeSurface.setSurfaceZero(Syy);
         FreeSurface.exchangeHorizontalUpdate(update, vyy, Sxx, Szz);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxx, Syy, Szz, Sxy, Sxz, Syz, vX, vY, vZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD3Delastic<float>;
@@ -58,6 +58,7 @@ namespace KITGPI
             /* Auxiliary Vectors */
             using ForwardSolver<ValueType>::update;
             using ForwardSolver<ValueType>::update_temp;
+            using ForwardSolver<ValueType>::kernelProfiler;
             scai::lama::DenseVector<ValueType> vxx;
             scai::lama::DenseVector<ValueType> vyy;
             scai::lama::DenseVector<ValueType> vzz;
@@ -180,14 +180,18 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     auto const &tauS = model.getTauS();
     auto const &tauP = model.getTauP();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD3Delastic<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* update velocity */
     /* ----------------*/
     update = Dxf * Sxx;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxx_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -198,13 +202,17 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzb * Sxz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -213,7 +221,9 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
 
     update = Dxb * Sxy;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxy_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -224,13 +234,17 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syy_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzb * Syz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -239,7 +253,9 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
 
     update = Dxb * Sxz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_sxz_x(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
 
     if (useFreeSurface == 1) {
@@ -250,13 +266,17 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     }
 
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_syz_y(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
     update_temp = Dzf * Szz;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_szz_z(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update += update_temp;
 
@@ -266,14 +286,17 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* ----------------*/
     /* stress update */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
 
     vxx = Dxb * vX;
     vyy = Dyb * vY;
     vzz = Dzb * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxx(vxx);
         ConvPML.apply_vyy(vyy);
         ConvPML.apply_vzz(vzz);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update = vxx;
@@ -354,11 +377,15 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* Update Sxy and Rxy*/
     update = Dyf * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update_temp = Dxf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -381,12 +408,16 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* Update Sxz and Rxz */
     update = Dzf * vX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vxz(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dxf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
 
@@ -409,12 +440,16 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
     /* Update Syz and Ryz */
     update = Dzf * vY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vyz(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     update_temp = Dyf * vZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_vzy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update += update_temp;
     update *= sWaveModulusAverageYZ;
@@ -435,22 +470,28 @@ void KITGPI::ForwardSolver::FD3Dviscoelastic<ValueType>::run(Acquisition::Acquis
 
     /* Apply free surface to stress update */
     if (useFreeSurface == 1) {
+        kernelProfiler.start(Kernel::FreeSurface);
         update = vxx + vzz;
         FreeSurface.exchangeHorizontalUpdate(update, vyy, Sxx, Szz, Rxx, Rzz, DThalf);
         FreeSurface.setSurfaceZero(Syy);
         for (int l=0; l<numRelaxationMechanisms; l++) {
             FreeSurface.setSurfaceZero(Ryy[l]);
         }
+        kernelProfiler.start(Kernel::StressUpdate);
     }
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(Sxx, Syy, Szz, Sxy, Sxz, Syz, vX, vY, vZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD3Dviscoelastic<float>;
@@ -0,0 +1,304 @@
+#include "KernelProfiler.hpp"
+#include "../Common/HostPrint.hpp"
+#include "../Partitioning/Partitioning.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace scai;
+
+//! \brief Close the perf_event counters
+template <typename ValueType>
+KITGPI::ForwardSolver::KernelProfiler<ValueType>::~KernelProfiler()
+{
+#ifdef __linux__
+    for (auto fd : counterFd) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+/*! \brief Initialization of the kernel profiler
+ *
+ * Computes the modelled bytes and floating point operations per time step of every kernel for the local gridpoints of this process:
+ * a matrix vector product reads spatialFDorder values and column indices per row, the row offset and the input vector and writes the result,
+ * an elementwise vector operation reads two and writes one value per gridpoint, a CPML update reads the coefficients a and b, the memory variable and the derivative
+ * and writes the memory variable and the derivative per gridpoint inside the CPML.
+ * The gridpoints inside the boundaries and on the free surface are estimated from the regular grid.
+ * The work model is also computed if kernelProfiling is not set (see getBytesPerStep()).
+ \param config Configuration
+ \param dist Distribution of the wavefields
+ \param modelCoordinates Coordinate class of the model
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::KernelProfiler<ValueType>::init(Configuration::Configuration const &config, dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+{
+    active = config.getAndCatch("kernelProfiling", false);
+    commShot = dist->getCommunicatorPtr();
+    reset();
+    std::fill_n(bytesPerStep, numKernels, 0.0);
+    std::fill_n(flopsPerStep, numKernels, 0.0);
+
+    Partitioning::OperationCounts counts = Partitioning::getOperationCounts(config);
+    std::string type = config.get<std::string>("equationType");
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+    IndexType N[3] = {modelCoordinates.getNX(), modelCoordinates.getNY(), modelCoordinates.getNZ()};
+    IndexType numDimensions = (N[2] > 1) ? 3 : 2;
+    double numLocal = dist->getLocalSize();
+    double localFraction = numLocal / dist->getGlobalSize();
+    IndexType spatialFDorder = config.get<IndexType>("spatialFDorder");
+    IndexType useFreeSurface = config.get<IndexType>("FreeSurface");
+    IndexType dampingBoundary = config.get<IndexType>("DampingBoundary");
+    IndexType boundaryWidth = config.getAndCatch("BoundaryWidth", IndexType(0));
+    double valueBytes = sizeof(ValueType);
+    double indexBytes = sizeof(IndexType);
+
+    double matrixVectorBytes = spatialFDorder * (valueBytes + indexBytes) + indexBytes + 2 * valueBytes;
+    double matrixVectorFlops = 2 * spatialFDorder;
+    double vectorBytes = 3 * valueBytes;
+
+    IndexType numVectorOperations = counts.NumVectorAssignement + counts.NumVectorPlusVector;
+    // the operation counts include one relaxation mechanism, every further mechanism updates the memory variables again
+    IndexType numRelaxationMechanisms = config.getAndCatch("numRelaxationMechanisms", IndexType(0));
+    if (counts.NumMemoryVariables > 0 && numRelaxationMechanisms > 1) {
+        IndexType operationsPerMemoryVariable = 4;
+        numVectorOperations += (numRelaxationMechanisms - 1) * counts.NumMemoryVariables * operationsPerMemoryVariable;
+    }
+
+    // the derivatives are split evenly, the velocity update scales and adds the update of every velocity component
+    IndexType numVelocities = numDimensions;
+    if (type.compare("sh") == 0 || type.compare("viscosh") == 0 || (numDimensions == 2 && (type.compare("emem") == 0 || type.compare("viscoemem") == 0))) {
+        numVelocities = 1;
+    }
+    IndexType numVelocityOperations = std::min(2 * numVelocities, numVectorOperations);
+    IndexType numVelocityDerivatives = counts.NumMatrixVector / 2;
+
+    auto setWork = [&](Kernel kernel, double bytes, double flops) {
+        bytesPerStep[static_cast<IndexType>(kernel)] = bytes;
+        flopsPerStep[static_cast<IndexType>(kernel)] = flops;
+    };
+    setWork(Kernel::VelocityUpdate, numLocal * (numVelocityDerivatives * matrixVectorBytes + numVelocityOperations * vectorBytes), numLocal * (numVelocityDerivatives * matrixVectorFlops + numVelocityOperations));
+    setWork(Kernel::StressUpdate, numLocal * ((counts.NumMatrixVector - numVelocityDerivatives) * matrixVectorBytes + (numVectorOperations - numVelocityOperations) * vectorBytes), numLocal * ((counts.NumMatrixVector - numVelocityDerivatives) * matrixVectorFlops + numVectorOperations - numVelocityOperations));
+
+    // fraction of the gridpoints within BoundaryWidth of the edges of every dimension (no boundary at the free surface)
+    double boundaryFraction[3] = {0, 0, 0};
+    for (IndexType dim = 0; dim < numDimensions; dim++) {
+        IndexType numEdges = (dim == 1 && useFreeSurface != 0) ? 1 : 2;
+        boundaryFraction[dim] = std::min(1.0, double(numEdges * boundaryWidth) / N[dim]);
+    }
+    if (dampingBoundary == 2) {
+        double numCPMLUpdates = 0;
+        for (IndexType dim = 0; dim < numDimensions; dim++) {
+            numCPMLUpdates += counts.NumPMLPerDim * boundaryFraction[dim] * numLocal;
+        }
+        setWork(Kernel::CPML, numCPMLUpdates * (6 * valueBytes + 2 * indexBytes), numCPMLUpdates * 4);
+    } else if (dampingBoundary == 1) {
+        // the damping coefficient is a dense vector which scales all wavefields
+        setWork(Kernel::CPML, counts.NumInterpolation * numLocal * vectorBytes, counts.NumInterpolation * numLocal);
+    }
+
+    if (useFreeSurface != 0) {
+        double numSurfacePoints = localFraction * N[0] * (numDimensions == 3 ? N[2] : 1);
+        setWork(Kernel::FreeSurface, counts.NumFreeSurface * numSurfacePoints * (2 * valueBytes + indexBytes), counts.NumFreeSurface * numSurfacePoints);
+    }
+
+    if (!active) {
+        return;
+    }
+
+    if (config.getAndCatch("kernelProfilingPerfEvents", false)) {
+#ifdef __linux__
+        IndexType const counterConfig[numCounters] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+        for (IndexType counter = 0; counter < numCounters; counter++) {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = counterConfig[counter];
+            attr.disabled = 1;
+            // counts the calling thread and threads created later, not the threads which already exist
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            if (counterFd[counter] < 0) {
+                counterFd[counter] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+            }
+        }
+#endif
+        bool available = (counterFd[0] >= 0 && counterFd[1] >= 0 && counterFd[2] >= 0);
+        if (!commShot->all(available)) {
+            HOST_PRINT(commShot, "Kernel profiling: perf_event counters are not available (see /proc/sys/kernel/perf_event_paranoid), only the runtime is measured\n");
+        }
+    }
+}
+
+//! \brief Reset the accumulated runtime of all kernels
+template <typename ValueType>
+void KITGPI::ForwardSolver::KernelProfiler<ValueType>::reset()
+{
+    current = Kernel::numKernels;
+    numSteps = 0;
+    std::fill_n(time, numKernels, 0.0);
+}
+
+//! \brief Reset and enable the perf_event counters at the beginning of the time loop
+template <typename ValueType>
+void KITGPI::ForwardSolver::KernelProfiler<ValueType>::startCounters()
+{
+#ifdef __linux__
+    if (counterFd[0] < 0 || counterFd[1] < 0 || counterFd[2] < 0) {
+        return;
+    }
+    for (auto fd : counterFd) {
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    countersRunning = true;
+#endif
+}
+
+/*! \brief Finish a time step
+ *
+ * Assigns the time since the last start() to the active kernel and the time to synchronize the processes of the shot domain to Communication.
+ * Has to be called by all processes of the shot domain at the end of every time step.
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::KernelProfiler<ValueType>::endStep()
+{
+    if (!active) {
+        return;
+    }
+    start(Kernel::Communication);
+    if (commShot->getSize() > 1) {
+        commShot->synchronize();
+    }
+    time[static_cast<IndexType>(Kernel::Communication)] += common::Walltime::get() - startTime;
+    current = Kernel::numKernels;
+    numSteps++;
+}
+
+/*! \brief Print the runtime per time step, bandwidth and flop rate of every kernel of a shot and reset the profiler
+ *
+ * The runtime is the maximum over the processes of the shot domain, the bandwidth and the flop rate are the modelled bytes and floating point operations
+ * of all processes divided by this runtime. Has to be called by all processes of the shot domain after the time stepping of a shot.
+ \param shotNumber Shot number
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::KernelProfiler<ValueType>::printSummary(IndexType shotNumber)
+{
+    if (!active || numSteps == 0) {
+        reset();
+        return;
+    }
+
+    double localTotal = 0;
+    for (IndexType kernel = 0; kernel < numKernels; kernel++) {
+        localTotal += time[kernel];
+    }
+    double totalTime = commShot->max(localTotal);
+    double totalBytes = 0;
+    double totalFlops = 0;
+
+    std::ostringstream summary;
+    summary << std::fixed;
+    summary << "\nKernel profile of shot number " << shotNumber << " (" << numSteps << " time steps, " << commShot->getSize() << " processes):\n";
+    summary << std::setw(16) << "kernel" << std::setw(14) << "ms per step" << std::setw(10) << "share" << std::setw(12) << "GB/s" << std::setw(12) << "GFLOP/s" << "\n";
+    for (IndexType kernel = 0; kernel < numKernels; kernel++) {
+        double maxTime = commShot->max(time[kernel]);
+        double bytes = commShot->sum(bytesPerStep[kernel]) * numSteps;
+        double flops = commShot->sum(flopsPerStep[kernel]) * numSteps;
+        totalBytes += bytes;
+        totalFlops += flops;
+        summary << std::setw(16) << getKernelName(static_cast<Kernel>(kernel)) << std::setw(14) << std::setprecision(4) << 1000 * maxTime / numSteps << std::setw(9) << std::setprecision(1) << (totalTime > 0 ? 100 * maxTime / totalTime : 0.0) << "%";
+        if (bytes > 0 && maxTime > 0) {
+            summary << std::setw(12) << std::setprecision(2) << bytes / maxTime * 1e-9 << std::setw(12) << flops / maxTime * 1e-9;
+        } else {
+            summary << std::setw(12) << "-" << std::setw(12) << "-";
+        }
+        summary << "\n";
+    }
+    if (totalTime > 0) {
+        summary << std::setw(16) << "total" << std::setw(14) << std::setprecision(4) << 1000 * totalTime / numSteps << std::setw(10) << "" << std::setw(12) << std::setprecision(2) << totalBytes / totalTime * 1e-9 << std::setw(12) << totalFlops / totalTime * 1e-9 << "\n";
+        summary << "Arithmetic intensity " << std::setprecision(3) << totalFlops / totalBytes << " flop/byte\n";
+    }
+
+    bool available = countersRunning;
+    if (commShot->all(available)) {
+        double counts[numCounters] = {};
+#ifdef __linux__
+        for (IndexType counter = 0; counter < numCounters; counter++) {
+            ::ioctl(counterFd[counter], PERF_EVENT_IOC_DISABLE, 0);
+            long long value = 0;
+            if (::read(counterFd[counter], &value, sizeof(value)) == ssize_t(sizeof(value))) {
+                counts[counter] = double(value);
+            }
+        }
+#endif
+        double cycles = commShot->sum(counts[0]);
+        double instructions = commShot->sum(counts[1]);
+        double cacheMisses = commShot->sum(counts[2]);
+        // the counters only see the threads which opened them, threads of an existing pool (e.g. OpenMP in LAMA) are missing, so no bandwidth is derived from the cache misses
+        summary << "perf_event (master threads only): " << std::setprecision(3) << cycles / numSteps << " cycles and " << instructions / numSteps << " instructions per step, IPC " << (cycles > 0 ? instructions / cycles : 0.0);
+        summary << ", " << cacheMisses / numSteps << " cache misses per step\n";
+    }
+    countersRunning = false;
+    summary << std::defaultfloat;
+
+    HOST_PRINT(commShot, summary.str());
+    reset();
+}
+
+//! \brief Return the modelled bytes per time step of all kernels of this process
+template <typename ValueType>
+double KITGPI::ForwardSolver::KernelProfiler<ValueType>::getBytesPerStep() const
+{
+    return (std::accumulate(bytesPerStep, bytesPerStep + numKernels, 0.0));
+}
+
+//! \brief Return the modelled floating point operations per time step of all kernels of this process
+template <typename ValueType>
+double KITGPI::ForwardSolver::KernelProfiler<ValueType>::getFlopsPerStep() const
+{
+    return (std::accumulate(flopsPerStep, flopsPerStep + numKernels, 0.0));
+}
+
+/*! \brief Name of a kernel in the summary
+ *
+ \param kernel Kernel
+ */
+template <typename ValueType>
+char const *KITGPI::ForwardSolver::KernelProfiler<ValueType>::getKernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::VelocityUpdate:
+        return ("velocityUpdate");
+    case Kernel::StressUpdate:
+        return ("stressUpdate");
+    case Kernel::CPML:
+        return ("boundary");
+    case Kernel::FreeSurface:
+        return ("freeSurface");
+    case Kernel::SourceReceiver:
+        return ("sourceReceiver");
+    case Kernel::Communication:
+        return ("communication");
+    default:
+        COMMON_THROWEXCEPTION("Unknown kernel")
+    }
+}
+
+template class KITGPI::ForwardSolver::KernelProfiler<float>;
+template class KITGPI::ForwardSolver::KernelProfiler<double>;
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <scai/common/Walltime.hpp>
+#include <scai/dmemo.hpp>
+
+#include "../Acquisition/Coordinates.hpp"
+#include "../Configuration/Configuration.hpp"
+
+namespace KITGPI
+{
+
+    namespace ForwardSolver
+    {
+
+        //! \brief Sub-steps of a time step which are timed by the KernelProfiler
+        enum class Kernel {
+            VelocityUpdate, //!< update of the velocities (EM: magnetic field) without boundary conditions
+            StressUpdate,   //!< update of the stresses or the pressure (EM: electric field) without boundary conditions
+            CPML,           //!< CPML or damping boundary
+            FreeSurface,    //!< free surface
+            SourceReceiver, //!< source injection and seismogram recording
+            Communication,  //!< wait for the slowest process of the shot domain at the end of the time step
+            numKernels
+        };
+
+        /*! \brief Runtime, bandwidth and flop rate of the sub-steps of the time stepping
+         *
+         * If kernelProfiling is set, the forward solvers switch the active kernel with start() before every sub-step,
+         * so every interval of the time step is assigned to exactly one kernel. The halo exchange of LAMA is part of the
+         * matrix vector products and therefore of the velocity and stress updates. At the end of every time step the processes
+         * of the shot domain are synchronized and the waiting time is assigned to Communication, i.e. the time which the processes
+         * lose due to load imbalance and the latency of the halo exchange.
+         * The bytes and floating point operations per time step are modelled from the operation counts of the equation
+         * (see Partitioning::getOperationCounts()), the FD order and the number of gridpoints in the boundaries.
+         * With kernelProfilingPerfEvents the cycles, instructions and last level cache misses of the time loop are read from the Linux perf_event interface.
+         * The counters cover the master thread of every process (and threads started after the initialization), not the threads of an existing thread pool.
+         */
+        template <typename ValueType>
+        class KernelProfiler
+        {
+          public:
+            //! Default constructor
+            KernelProfiler(){};
+
+            ~KernelProfiler();
+
+            KernelProfiler(KernelProfiler const &) = delete;
+            KernelProfiler &operator=(KernelProfiler const &) = delete;
+
+            void init(Configuration::Configuration const &config, scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates);
+
+            //! \brief Return true if the kernels are timed
+            bool isActive() const { return (active); }
+
+            /*! \brief Assign the time since the last call to the active kernel and activate kernel
+             *
+             \param kernel Kernel which is executed next
+             */
+            void start(Kernel kernel)
+            {
+                if (!active) {
+                    return;
+                }
+                if (numSteps == 0 && current == Kernel::numKernels) {
+                    startCounters();
+                }
+                double now = scai::common::Walltime::get();
+                if (current != Kernel::numKernels) {
+                    time[static_cast<scai::IndexType>(current)] += now - startTime;
+                }
+                current = kernel;
+                startTime = now;
+            }
+
+            void endStep();
+
+            void printSummary(scai::IndexType shotNumber);
+
+            double getBytesPerStep() const;
+            double getFlopsPerStep() const;
+
+            static char const *getKernelName(Kernel kernel);
+
+          private:
+            static constexpr scai::IndexType numKernels = static_cast<scai::IndexType>(Kernel::numKernels);
+            static constexpr scai::IndexType numCounters = 3;
+
+            void reset();
+            void startCounters();
+
+            bool active = false;                     //!< true if kernelProfiling is set
+            scai::dmemo::CommunicatorPtr commShot;   //!< communicator of the shot domain
+            Kernel current = Kernel::numKernels;     //!< active kernel, numKernels between the time steps
+            double startTime = 0;                    //!< start time of the active kernel
+            scai::IndexType numSteps = 0;            //!< number of time steps since the last summary
+            double time[numKernels] = {};            //!< accumulated runtime per kernel in seconds
+            double bytesPerStep[numKernels] = {};    //!< modelled bytes per time step of this process
+            double flopsPerStep[numKernels] = {};    //!< modelled floating point operations per time step of this process
+
+            int counterFd[numCounters] = {-1, -1, -1}; //!< perf_event file descriptors of cycles, instructions and cache misses (-1 = not available)
+            bool countersRunning = false;              //!< true while the perf_event counters are enabled
+        };
+    } /* end namespace ForwardSolver */
+} /* end namespace KITGPI */
@@ -0,0 +1,487 @@
+#include "ShotBatch.hpp"
+#include <scai/tracing.hpp>
+
+#include <algorithm>
+
+using namespace scai;
+
+/*! \brief Initialization of the batch
+ *
+ \param numGridpointsIn Number of gridpoints of the model
+ \param numShotsIn Number of shots which are modelled at once
+ \param nodeSharedMemoryIn Node shared memory for the read-only copies (nullptr = local copies)
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::init(IndexType numGridpointsIn, IndexType numShotsIn, Common::NodeSharedMemory *nodeSharedMemoryIn)
+{
+    SCAI_ASSERT_ERROR(numShotsIn > 0, "number of shots per batch has to be positive");
+    numGridpoints = numGridpointsIn;
+    numShots = numShotsIn;
+    nodeSharedMemory = nodeSharedMemoryIn;
+    sourceTraces.clear();
+    receiverTraces.clear();
+}
+
+//! \brief Getter method for the number of shots of the batch
+template <typename ValueType>
+IndexType KITGPI::ForwardSolver::ShotBatch<ValueType>::getNumShots() const
+{
+    return (numShots);
+}
+
+/*! \brief Allocate an interleaved wavefield and set it to zero
+ *
+ \param field Interleaved wavefield [gridpoint][shot]
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::allocateField(std::vector<ValueType> &field) const
+{
+    field.assign(numGridpoints * numShots, 0.0);
+}
+
+/*! \brief Copy the local storage of a matrix into stencil blocks and coupling rows
+ *
+ * Runs of at least minBlockRows consecutive rows with the same stencil become a stencil block, all other rows are coupling rows.
+ \param batchMatrix Block-structured copy of the matrix
+ \param matrix Matrix (e.g. derivative matrix), has to be owned by a single process
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setMatrix(BatchMatrix<ValueType> &batchMatrix, lama::Matrix<ValueType> const &matrix) const
+{
+    SCAI_REGION("ShotBatch.setMatrix")
+    SCAI_ASSERT_ERROR(matrix.getRowDistribution().getNumPartitions() == 1, "Batched modelling requires a shot domain with a single process");
+    SCAI_ASSERT_ERROR(matrix.getNumRows() == numGridpoints, "Size of the matrix does not match the batch");
+
+    lama::CSRSparseMatrix<ValueType> csrMatrix;
+    csrMatrix.assign(matrix);
+    auto const &storage = csrMatrix.getLocalStorage();
+
+    auto read_ia = hmemo::hostReadAccess(storage.getIA());
+    auto read_ja = hmemo::hostReadAccess(storage.getJA());
+    auto read_values = hmemo::hostReadAccess(storage.getValues());
+
+    // stencil of a row as sorted (column offset, weight) pairs
+    typedef std::vector<std::pair<IndexType, ValueType>> Stencil;
+    auto getStencil = [&](IndexType row, Stencil &stencil) {
+        stencil.clear();
+        for (IndexType jj = read_ia[row]; jj < read_ia[row + 1]; jj++) {
+            stencil.emplace_back(read_ja[jj] - row, read_values[jj]);
+        }
+        std::sort(stencil.begin(), stencil.end());
+    };
+
+    std::vector<IndexType> blockRows;
+    std::vector<IndexType> blockStencil(1, 0);
+    std::vector<IndexType> stencilOffsets;
+    std::vector<ValueType> stencilWeights;
+    std::vector<IndexType> rows;
+    std::vector<IndexType> ia(1, 0);
+    std::vector<IndexType> ja;
+    std::vector<ValueType> values;
+
+    Stencil stencil;
+    Stencil nextStencil;
+    IndexType first = 0;
+    while (first < numGridpoints) {
+        getStencil(first, stencil);
+        IndexType end = first + 1;
+        while (end < numGridpoints) {
+            getStencil(end, nextStencil);
+            if (nextStencil != stencil) {
+                break;
+            }
+            end++;
+        }
+
+        if (end - first >= minBlockRows) {
+            blockRows.push_back(first);
+            blockRows.push_back(end);
+            for (auto const &point : stencil) {
+                stencilOffsets.push_back(point.first);
+                stencilWeights.push_back(point.second);
+            }
+            blockStencil.push_back(stencilOffsets.size());
+        } else {
+            for (IndexType row = first; row < end; row++) {
+                rows.push_back(row);
+                for (auto const &point : stencil) {
+                    ja.push_back(row + point.first);
+                    values.push_back(point.second);
+                }
+                ia.push_back(ja.size());
+            }
+        }
+        first = end;
+    }
+
+    batchMatrix.blockRows.assign(blockRows.begin(), blockRows.end());
+    batchMatrix.blockStencil.assign(blockStencil.begin(), blockStencil.end());
+    batchMatrix.stencilOffsets.assign(stencilOffsets.begin(), stencilOffsets.end());
+    batchMatrix.stencilWeights.assign(stencilWeights.begin(), stencilWeights.end());
+    batchMatrix.rows.assign(rows.begin(), rows.end());
+    batchMatrix.ia.assign(ia.begin(), ia.end());
+    batchMatrix.ja.assign(ja.begin(), ja.end());
+    batchMatrix.values.assign(values.begin(), values.end());
+
+    if (nodeSharedMemory) {
+        batchMatrix.blockRows.share(*nodeSharedMemory);
+        batchMatrix.blockStencil.share(*nodeSharedMemory);
+        batchMatrix.stencilOffsets.share(*nodeSharedMemory);
+        batchMatrix.stencilWeights.share(*nodeSharedMemory);
+        batchMatrix.rows.share(*nodeSharedMemory);
+        batchMatrix.ia.share(*nodeSharedMemory);
+        batchMatrix.ja.share(*nodeSharedMemory);
+        batchMatrix.values.share(*nodeSharedMemory);
+    }
+}
+
+/*! \brief Copy the local values of a vector (e.g. a material parameter)
+ *
+ \param batchVector Dense copy of the vector
+ \param vector Dense or sparse vector
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setVector(Common::NodeSharedArray<ValueType> &batchVector, lama::Vector<ValueType> const &vector) const
+{
+    SCAI_ASSERT_ERROR(vector.getDistribution().getNumPartitions() == 1, "Batched modelling requires a shot domain with a single process");
+
+    hmemo::HArray<ValueType> localValues;
+    vector.buildLocalValues(localValues);
+    auto read_localValues = hmemo::hostReadAccess(localValues);
+    batchVector.assign(read_localValues.begin(), read_localValues.end());
+
+    if (nodeSharedMemory) {
+        batchVector.share(*nodeSharedMemory);
+    }
+}
+
+/*! \brief Copy a list of gridpoints (e.g. the free surface)
+ *
+ \param batchIndex Copy of the gridpoints
+ \param index Gridpoints
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setIndex(Common::NodeSharedArray<IndexType> &batchIndex, std::vector<IndexType> const &index) const
+{
+    batchIndex.assign(index.begin(), index.end());
+
+    if (nodeSharedMemory) {
+        batchIndex.share(*nodeSharedMemory);
+    }
+}
+
+/*! \brief Copy the CPML coefficients of one derivative
+ *
+ * Only the gridpoints inside the CPML are stored, the memory variables are allocated for every shot of the batch.
+ \param batchCPML CPML coefficients and memory variables
+ \param a CPML coefficient a
+ \param b CPML coefficient b
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setCPML(BatchCPML<ValueType> &batchCPML, lama::SparseVector<ValueType> const &a, lama::SparseVector<ValueType> const &b) const
+{
+    SCAI_ASSERT_ERROR(b.getDistribution().getNumPartitions() == 1, "Batched modelling requires a shot domain with a single process");
+
+    hmemo::HArray<ValueType> aDense;
+    hmemo::HArray<ValueType> bDense;
+    a.buildLocalValues(aDense);
+    b.buildLocalValues(bDense);
+    auto read_aDense = hmemo::hostReadAccess(aDense);
+    auto read_bDense = hmemo::hostReadAccess(bDense);
+
+    // b = exp(-(d+alpha)DT) is non-zero for every gridpoint inside the CPML
+    auto read_index = hmemo::hostReadAccess(b.getNonZeroIndexes());
+    std::vector<ValueType> aCPML(read_index.size());
+    std::vector<ValueType> bCPML(read_index.size());
+    for (unsigned i = 0; i < aCPML.size(); i++) {
+        aCPML[i] = read_aDense[read_index[i]];
+        bCPML[i] = read_bDense[read_index[i]];
+    }
+    batchCPML.index.assign(read_index.begin(), read_index.end());
+    batchCPML.a.assign(aCPML.begin(), aCPML.end());
+    batchCPML.b.assign(bCPML.begin(), bCPML.end());
+    batchCPML.psi.assign(batchCPML.index.size() * numShots, 0.0);
+
+    if (nodeSharedMemory) {
+        batchCPML.index.share(*nodeSharedMemory);
+        batchCPML.a.share(*nodeSharedMemory);
+        batchCPML.b.share(*nodeSharedMemory);
+    }
+}
+
+/*! \brief Set sources and receivers of all shots of the batch
+ *
+ * The source signals are copied once, the receiver traces are written directly into the seismograms of the receivers.
+ \param receivers Receivers of every shot of the batch
+ \param sources Sources of every shot of the batch
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const &receivers, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const &sources)
+{
+    SCAI_ASSERT_ERROR(receivers.size() == sources.size(), "Number of receivers and sources of the batch differ");
+    SCAI_ASSERT_ERROR(IndexType(sources.size()) <= numShots, "More shots than the batch size");
+
+    sourceTraces.clear();
+    receiverTraces.clear();
+    for (unsigned shot = 0; shot < sources.size(); shot++) {
+        /* Set source coordinate to receiver seismogram handler (see SourceReceiverImplSeismic) */
+        if (sources[shot]->getSeismogramHandler().getNumTracesTotal() == 1) {
+            receivers[shot]->getSeismogramHandler().setSourceCoordinate(sources[shot]->get1DCoordinates().getValue(0));
+        } else {
+            receivers[shot]->getSeismogramHandler().setSourceCoordinate(0);
+        }
+        setTraces(sourceTraces, *sources[shot], shot, true);
+        setTraces(receiverTraces, *receivers[shot], shot, false);
+        for (auto &traces : receiverTraces) {
+            if (traces.shot == IndexType(shot)) {
+                traces.seismogram = &receivers[shot]->getSeismogramHandler().getSeismogram(Acquisition::SeismogramType(traces.component));
+            }
+        }
+    }
+}
+
+/*! \brief Collect the traces of one shot
+ *
+ \param traces Traces of all shots
+ \param geometry Sources or receivers of the shot
+ \param shot Shot of the batch
+ \param copySignals Copy the source signals
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setTraces(std::vector<BatchTraces<ValueType>> &traces, Acquisition::AcquisitionGeometry<ValueType> const &geometry, IndexType shot, bool copySignals) const
+{
+    for (IndexType component = Acquisition::SeismogramType::P; component <= Acquisition::SeismogramType::VY; component++) {
+        auto type = Acquisition::SeismogramType(component);
+        if (geometry.getSeismogramHandler().getNumTracesGlobal(type) == 0) {
+            continue;
+        }
+        auto const &seismogram = geometry.getSeismogramHandler().getSeismogram(type);
+        BatchTraces<ValueType> componentTraces;
+        componentTraces.shot = shot;
+        componentTraces.component = component;
+        componentTraces.numSamples = seismogram.getData().getNumColumns();
+
+        auto read_index = hmemo::hostReadAccess(seismogram.get1DCoordinates().getLocalValues());
+        componentTraces.index.assign(read_index.begin(), read_index.end());
+        if (copySignals) {
+            auto read_signal = hmemo::hostReadAccess(seismogram.getData().getLocalStorage().getData());
+            componentTraces.signal.assign(read_signal.begin(), read_signal.end());
+        }
+        traces.push_back(componentTraces);
+    }
+}
+
+/*! \brief Block-structured matrix times interleaved wavefield
+ *
+ * THIS METHOD IS CALLED DURING TIME STEPPING
+ * DO NOT WASTE RUNTIME HERE
+ *
+ * Within a stencil block the rows of all shots are contiguous, so the threads split the (row, shot) pairs of the block and apply the stencil to each pair.
+ * The coupling rows are split between the threads row by row.
+ \param result Interleaved result
+ \param batchMatrix Block-structured matrix
+ \param field Interleaved wavefield
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::multiply(std::vector<ValueType> &result, BatchMatrix<ValueType> const &batchMatrix, std::vector<ValueType> const &field) const
+{
+    SCAI_REGION("ShotBatch.multiply")
+    IndexType const K = numShots;
+    ValueType *out = result.data();
+    ValueType const *in = field.data();
+
+    /* stencil blocks */
+    IndexType const numBlocks = batchMatrix.blockStencil.size() - 1;
+    for (IndexType block = 0; block < numBlocks; block++) {
+        IndexType const first = batchMatrix.blockRows[2 * block] * K;
+        IndexType const end = batchMatrix.blockRows[2 * block + 1] * K;
+        IndexType const stencilStart = batchMatrix.blockStencil[block];
+        IndexType const stencilEnd = batchMatrix.blockStencil[block + 1];
+        ValueType const *weights = batchMatrix.stencilWeights.data();
+        IndexType const *offsets = batchMatrix.stencilOffsets.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (IndexType i = first; i < end; i++) {
+            ValueType sum = 0.0;
+            for (IndexType s = stencilStart; s < stencilEnd; s++) {
+                sum += weights[s] * in[i + offsets[s] * K];
+            }
+            out[i] = sum;
+        }
+    }
+
+    /* coupling rows */
+    IndexType const numRows = batchMatrix.rows.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType r = 0; r < numRows; r++) {
+        ValueType *outRow = out + batchMatrix.rows[r] * K;
+        for (IndexType k = 0; k < K; k++) {
+            outRow[k] = 0.0;
+        }
+        for (IndexType jj = batchMatrix.ia[r]; jj < batchMatrix.ia[r + 1]; jj++) {
+            ValueType const value = batchMatrix.values[jj];
+            ValueType const *inRow = in + batchMatrix.ja[jj] * K;
+            for (IndexType k = 0; k < K; k++) {
+                outRow[k] += value * inRow[k];
+            }
+        }
+    }
+}
+
+/*! \brief Application of the CPML to an interleaved derivative (see CPML::applyCPML)
+ *
+ * THIS METHOD IS CALLED DURING TIME STEPPING
+ * DO NOT WASTE RUNTIME HERE
+ *
+ \param update Interleaved derivative
+ \param batchCPML CPML coefficients and memory variables
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::applyCPML(std::vector<ValueType> &update, BatchCPML<ValueType> &batchCPML) const
+{
+    IndexType const K = numShots;
+    IndexType const numPoints = batchCPML.index.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType j = 0; j < numPoints; j++) {
+        ValueType *updateRow = update.data() + batchCPML.index[j] * K;
+        ValueType *psiRow = batchCPML.psi.data() + j * K;
+        ValueType const a = batchCPML.a[j];
+        ValueType const b = batchCPML.b[j];
+        for (IndexType k = 0; k < K; k++) {
+            psiRow[k] = b * psiRow[k] + a * updateRow[k];
+            updateRow[k] += psiRow[k];
+        }
+    }
+}
+
+/*! \brief Reset the CPML memory variables
+ *
+ \param batchCPML CPML coefficients and memory variables
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::resetCPML(BatchCPML<ValueType> &batchCPML) const
+{
+    std::fill(batchCPML.psi.begin(), batchCPML.psi.end(), 0.0);
+}
+
+/*! \brief field += update
+ *
+ \param field Interleaved wavefield
+ \param update Interleaved update
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::add(std::vector<ValueType> &field, std::vector<ValueType> const &update) const
+{
+    IndexType const size = field.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType i = 0; i < size; i++) {
+        field[i] += update[i];
+    }
+}
+
+/*! \brief field += diag(coefficient) * update
+ *
+ \param field Interleaved wavefield
+ \param coefficient Coefficient per gridpoint (e.g. material parameter)
+ \param update Interleaved update
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::addScaled(std::vector<ValueType> &field, Common::NodeSharedArray<ValueType> const &coefficient, std::vector<ValueType> const &update) const
+{
+    IndexType const K = numShots;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType i = 0; i < numGridpoints; i++) {
+        ValueType const c = coefficient[i];
+        for (IndexType k = 0; k < K; k++) {
+            field[i * K + k] += c * update[i * K + k];
+        }
+    }
+}
+
+/*! \brief field = diag(coefficient) * field
+ *
+ \param field Interleaved wavefield
+ \param coefficient Coefficient per gridpoint (e.g. damping)
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::scale(std::vector<ValueType> &field, Common::NodeSharedArray<ValueType> const &coefficient) const
+{
+    IndexType const K = numShots;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType i = 0; i < numGridpoints; i++) {
+        ValueType const c = coefficient[i];
+        for (IndexType k = 0; k < K; k++) {
+            field[i * K + k] *= c;
+        }
+    }
+}
+
+/*! \brief Set the wavefield of all shots to zero at the given gridpoints
+ *
+ \param field Interleaved wavefield
+ \param index Gridpoints (e.g. free surface)
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::setZero(std::vector<ValueType> &field, Common::NodeSharedArray<IndexType> const &index) const
+{
+    IndexType const K = numShots;
+    IndexType const numPoints = index.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType j = 0; j < numPoints; j++) {
+        IndexType const i = index[j];
+        for (IndexType k = 0; k < K; k++) {
+            field[i * K + k] = 0.0;
+        }
+    }
+}
+
+/*! \brief Add the source signals of time step t to the wavefields
+ *
+ \param fields Interleaved wavefields indexed by Acquisition::SeismogramType (NULL for missing components)
+ \param t Time step
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::applySources(std::vector<std::vector<ValueType> *> const &fields, IndexType t) const
+{
+    for (auto const &traces : sourceTraces) {
+        std::vector<ValueType> *field = fields[traces.component];
+        SCAI_ASSERT_ERROR(field != NULL, "Source type " << traces.component << " is not supported by the batched modelling");
+        for (unsigned i = 0; i < traces.index.size(); i++) {
+            (*field)[traces.index[i] * numShots + traces.shot] += traces.signal[i * traces.numSamples + t];
+        }
+    }
+}
+
+/*! \brief Write the wavefields of time step t at the receivers into the seismograms
+ *
+ \param fields Interleaved wavefields indexed by Acquisition::SeismogramType (NULL for missing components)
+ \param t Time step
+ */
+template <typename ValueType>
+void KITGPI::ForwardSolver::ShotBatch<ValueType>::gatherSeismograms(std::vector<std::vector<ValueType> *> const &fields, IndexType t) const
+{
+    for (auto const &traces : receiverTraces) {
+        std::vector<ValueType> const *field = fields[traces.component];
+        SCAI_ASSERT_ERROR(field != NULL, "Receiver type " << traces.component << " is not supported by the batched modelling");
+        auto write_data = hmemo::hostWriteAccess(traces.seismogram->getData().getLocalStorage().getData());
+        for (unsigned i = 0; i < traces.index.size(); i++) {
+            write_data[i * traces.numSamples + t] = (*field)[traces.index[i] * numShots + traces.shot];
+        }
+    }
+}
+
+template class KITGPI::ForwardSolver::ShotBatch<float>;
+template class KITGPI::ForwardSolver::ShotBatch<double>;
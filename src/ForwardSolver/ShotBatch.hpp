@@ -0,0 +1,115 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+#include <scai/hmemo.hpp>
+#include <scai/lama.hpp>
+
+#include "../Acquisition/AcquisitionGeometry.hpp"
+#include "../Common/NodeSharedMemory.hpp"
+
+#include <vector>
+
+namespace KITGPI
+{
+
+    namespace ForwardSolver
+    {
+
+        //! \brief Block-structured sparse matrix for the batched modelling
+        /*!
+         * Consecutive rows with the same stencil (column offsets relative to the row and weights) are stored once as a stencil block.
+         * On the variable grid these are the interior rows of every layer, which is a regular grid with its own grid spacing.
+         * All other rows (variable grid interfaces, model edges) are stored in CSR format as a small coupling operator.
+         */
+        template <typename ValueType>
+        struct BatchMatrix {
+            Common::NodeSharedArray<scai::IndexType> blockRows;      //!< first row and end row of every stencil block
+            Common::NodeSharedArray<scai::IndexType> blockStencil;   //!< start of the stencil of every block in stencilOffsets and stencilWeights (number of blocks + 1)
+            Common::NodeSharedArray<scai::IndexType> stencilOffsets; //!< column offsets of the stencils relative to the row
+            Common::NodeSharedArray<ValueType> stencilWeights;       //!< weights of the stencils
+
+            Common::NodeSharedArray<scai::IndexType> rows; //!< coupling rows
+            Common::NodeSharedArray<scai::IndexType> ia;   //!< row offsets of the coupling rows
+            Common::NodeSharedArray<scai::IndexType> ja;   //!< column indices of the coupling rows
+            Common::NodeSharedArray<ValueType> values;     //!< non-zero values of the coupling rows
+        };
+
+        //! \brief CPML coefficients and memory variables of one derivative for the batched modelling
+        template <typename ValueType>
+        struct BatchCPML {
+            Common::NodeSharedArray<scai::IndexType> index; //!< gridpoints inside the CPML
+            Common::NodeSharedArray<ValueType> a;           //!< CPML coefficient a per gridpoint inside the CPML
+            Common::NodeSharedArray<ValueType> b;           //!< CPML coefficient b per gridpoint inside the CPML
+            std::vector<ValueType> psi;                     //!< CPML memory variable per gridpoint inside the CPML and shot
+        };
+
+        //! \brief Source signals or receiver traces of one shot and one component for the batched modelling
+        template <typename ValueType>
+        struct BatchTraces {
+            scai::IndexType shot = 0;                              //!< shot of the batch
+            scai::IndexType component = 0;                         //!< wavefield component (Acquisition::SeismogramType)
+            std::vector<scai::IndexType> index;                    //!< gridpoint of every trace
+            std::vector<ValueType> signal;                         //!< source signals (trace major), empty for receivers
+            scai::IndexType numSamples = 0;                        //!< number of samples per trace
+            Acquisition::Seismogram<ValueType> *seismogram = NULL; //!< receiver seismogram which is filled during the modelling
+        };
+
+        //! \brief Interleaved storage and kernels to model several independent shots at once
+        /*!
+         * The wavefields of all shots of a batch are stored interleaved as [gridpoint][shot] in host memory,
+         * so every stencil weight and material coefficient is loaded once and applied to all shots of the batch.
+         * In contrast to source encoding the shots are not summed, every shot keeps its own wavefield and seismograms.
+         * The kernels work on the local storage of the LAMA matrices and vectors and therefore require a shot domain with a single process,
+         * which uses the cores of its node by the OpenMP threads of the kernels (rows times shots of the batch).
+         * The matrices are stored block-structured (see BatchMatrix), so the layers of the variable grid are computed with stencil kernels.
+         * With node shared memory the copies of the matrices, material parameters and boundary coefficients are stored once per node for all shot domains of the node.
+         */
+        template <typename ValueType>
+        class ShotBatch
+        {
+          public:
+            //! Default constructor
+            ShotBatch(){};
+
+            //! Default destructor
+            ~ShotBatch(){};
+
+            void init(scai::IndexType numGridpoints, scai::IndexType numShots, Common::NodeSharedMemory *nodeSharedMemory = nullptr);
+
+            scai::IndexType getNumShots() const;
+
+            void allocateField(std::vector<ValueType> &field) const;
+
+            void setMatrix(BatchMatrix<ValueType> &batchMatrix, scai::lama::Matrix<ValueType> const &matrix) const;
+            void setVector(Common::NodeSharedArray<ValueType> &batchVector, scai::lama::Vector<ValueType> const &vector) const;
+            void setIndex(Common::NodeSharedArray<scai::IndexType> &batchIndex, std::vector<scai::IndexType> const &index) const;
+            void setCPML(BatchCPML<ValueType> &batchCPML, scai::lama::SparseVector<ValueType> const &a, scai::lama::SparseVector<ValueType> const &b) const;
+
+            void setAcquisition(std::vector<Acquisition::AcquisitionGeometry<ValueType> *> const &receivers, std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> const &sources);
+
+            void multiply(std::vector<ValueType> &result, BatchMatrix<ValueType> const &batchMatrix, std::vector<ValueType> const &field) const;
+            void applyCPML(std::vector<ValueType> &update, BatchCPML<ValueType> &batchCPML) const;
+            void resetCPML(BatchCPML<ValueType> &batchCPML) const;
+            void add(std::vector<ValueType> &field, std::vector<ValueType> const &update) const;
+            void addScaled(std::vector<ValueType> &field, Common::NodeSharedArray<ValueType> const &coefficient, std::vector<ValueType> const &update) const;
+            void scale(std::vector<ValueType> &field, Common::NodeSharedArray<ValueType> const &coefficient) const;
+            void setZero(std::vector<ValueType> &field, Common::NodeSharedArray<scai::IndexType> const &index) const;
+
+            void applySources(std::vector<std::vector<ValueType> *> const &fields, scai::IndexType t) const;
+            void gatherSeismograms(std::vector<std::vector<ValueType> *> const &fields, scai::IndexType t) const;
+
+          private:
+            void setTraces(std::vector<BatchTraces<ValueType>> &traces, Acquisition::AcquisitionGeometry<ValueType> const &geometry, scai::IndexType shot, bool copySignals) const;
+
+            scai::IndexType numGridpoints = 0; //!< number of gridpoints
+            scai::IndexType numShots = 0;      //!< number of shots of the batch (interleave stride)
+
+            static constexpr scai::IndexType minBlockRows = 8; //!< minimum number of rows of a stencil block
+
+            Common::NodeSharedMemory *nodeSharedMemory = nullptr; //!< node shared memory of the read-only copies (nullptr = local copies)
+
+            std::vector<BatchTraces<ValueType>> sourceTraces;   //!< source signals of all shots of the batch
+            std::vector<BatchTraces<ValueType>> receiverTraces; //!< receivers of all shots of the batch
+        };
+    } /* end namespace ForwardSolver */
+} /* end namespace KITGPI */
@@ -128,7 +128,9 @@ void KITGPI::ForwardSolver::FD2Demem<ValueType>::run(Acquisition::AcquisitionGeo
     
     lama::Matrix<ValueType> const &DybStaggeredX = derivatives.getDybStaggeredX();  
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Demem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* hz */
@@ -136,8 +138,10 @@ void KITGPI::ForwardSolver::FD2Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = Dxf * eY;
     update_temp = Dyf * eX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_eyx(update);
         ConvPML.apply_exy(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXY;
@@ -146,9 +150,12 @@ void KITGPI::ForwardSolver::FD2Demem<ValueType>::run(Acquisition::AcquisitionGeo
     /* ----------------*/
     /*  ex */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     update = DybStaggeredX * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update *= CbAverageX;    
     update_temp = CaAverageX * eX;
@@ -159,7 +166,9 @@ void KITGPI::ForwardSolver::FD2Demem<ValueType>::run(Acquisition::AcquisitionGeo
     /* ----------------*/
     update = Dxb * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzx(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update *= CbAverageY;   
     update_temp = CaAverageY * eY;
@@ -167,12 +176,16 @@ void KITGPI::ForwardSolver::FD2Demem<ValueType>::run(Acquisition::AcquisitionGeo
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eY, eX, hZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Demem<float>;
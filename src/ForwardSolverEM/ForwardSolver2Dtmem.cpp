@@ -123,14 +123,18 @@ void KITGPI::ForwardSolver::FD2Dtmem<ValueType>::run(Acquisition::AcquisitionGeo
     auto const &Dyf = derivatives.getDyf();
     auto const &Dyb = derivatives.getDyb();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Dtmem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* hx */
     /* ----------------*/
     update = Dyf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezy(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseMagneticPermeabilityAverageYZ;
     hX -= update;
@@ -140,7 +144,9 @@ void KITGPI::ForwardSolver::FD2Dtmem<ValueType>::run(Acquisition::AcquisitionGeo
     /* ----------------*/
     update_temp = Dxf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezx(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update = -update_temp;
     update *= inverseMagneticPermeabilityAverageXZ;
@@ -149,11 +155,14 @@ void KITGPI::ForwardSolver::FD2Dtmem<ValueType>::run(Acquisition::AcquisitionGeo
     /* ----------------*/
     /*  ez */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     update = Dxb * hY;
     update_temp = Dyb * hX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hyx(update);
         ConvPML.apply_hxy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     update *= CbAverageZ;   
@@ -162,12 +171,16 @@ void KITGPI::ForwardSolver::FD2Dtmem<ValueType>::run(Acquisition::AcquisitionGeo
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eZ, hX, hY);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dtmem<float>;
@@ -160,7 +160,9 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     
     lama::Matrix<ValueType> const &DybStaggeredX = derivatives.getDybStaggeredX();  
    
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Demem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* hz */
@@ -168,8 +170,10 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = Dxf * eY;
     update_temp = Dyf * eX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_eyx(update);
         ConvPML.apply_exy(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXY;
@@ -178,6 +182,7 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     /*  rX rY          */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     for (int l=0; l<numRelaxationMechanisms; l++) {
         update = Cc[l] * rX[l];
         update_temp = CdAverageX[l] * eX;
@@ -193,7 +198,9 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     update = DybStaggeredX * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzy(update);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     for (int l=0; l<numRelaxationMechanisms; l++) {
         update -= DT_temp * rX[l];
@@ -207,7 +214,9 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     update_temp = Dxb * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update = -update_temp;
     for (int l=0; l<numRelaxationMechanisms; l++) {
@@ -219,12 +228,16 @@ void KITGPI::ForwardSolver::FD2Dviscoemem<ValueType>::run(Acquisition::Acquisiti
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eY, eX, hZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dviscoemem<float>;
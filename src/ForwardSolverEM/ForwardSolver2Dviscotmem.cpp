@@ -147,14 +147,18 @@ void KITGPI::ForwardSolver::FD2Dviscotmem<ValueType>::run(Acquisition::Acquisiti
     auto const &Dyf = derivatives.getDyf();
     auto const &Dyb = derivatives.getDyb();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD2Dtmem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* hx */
     /* ----------------*/
     update = Dyf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezy(update);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update *= inverseMagneticPermeabilityAverageYZ;
     hX -= update;
@@ -164,7 +168,9 @@ void KITGPI::ForwardSolver::FD2Dviscotmem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     update_temp = Dxf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezx(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update = -update_temp;
     update *= inverseMagneticPermeabilityAverageXZ;
@@ -173,6 +179,7 @@ void KITGPI::ForwardSolver::FD2Dviscotmem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     /*  rZ             */
     /* ----------------*/    
+    kernelProfiler.start(Kernel::StressUpdate);
     for (int l=0; l<numRelaxationMechanisms; l++) {
         update = Cc[l] * rZ[l];
         update_temp = CdAverageZ[l] * eZ;
@@ -185,8 +192,10 @@ void KITGPI::ForwardSolver::FD2Dviscotmem<ValueType>::run(Acquisition::Acquisiti
     update = Dxb * hY;
     update_temp = Dyb * hX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hyx(update);
         ConvPML.apply_hxy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     for (int l=0; l<numRelaxationMechanisms; l++) {
@@ -198,12 +207,16 @@ void KITGPI::ForwardSolver::FD2Dviscotmem<ValueType>::run(Acquisition::Acquisiti
 
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eZ, hX, hY);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD2Dviscotmem<float>;
@@ -146,7 +146,9 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     lama::Matrix<ValueType> const &DyfStaggeredZ = derivatives.getDyfStaggeredZ();
     lama::Matrix<ValueType> const &DybStaggeredZ = derivatives.getDybStaggeredZ();
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD3Demem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
     
     /* ----------------*/
     /* hx */
@@ -154,8 +156,10 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = DyfStaggeredZ * eZ;
     update_temp = Dzf * eY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezy(update);
         ConvPML.apply_eyz(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageYZ;
@@ -167,8 +171,10 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = Dzf * eX;
     update_temp = Dxf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_exz(update);
         ConvPML.apply_ezx(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXZ;
@@ -180,8 +186,10 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = Dxf * eY;
     update_temp = DyfStaggeredX * eX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_eyx(update);
         ConvPML.apply_exy(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXY;
@@ -190,11 +198,14 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     /* ----------------*/
     /*  ex */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     update = DybStaggeredX * hZ;
     update_temp = Dzb * hY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzy(update);
         ConvPML.apply_hyz(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     update *= CbAverageX;    
@@ -207,8 +218,10 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = Dzb * hX;
     update_temp = Dxb * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hxz(update);
         ConvPML.apply_hzx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     update *= CbAverageY;   
@@ -221,8 +234,10 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     update = Dxb * hY;
     update_temp = DybStaggeredZ * hX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hyx(update);
         ConvPML.apply_hxy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     update *= CbAverageZ;   
@@ -231,12 +246,16 @@ void KITGPI::ForwardSolver::FD3Demem<ValueType>::run(Acquisition::AcquisitionGeo
     
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eZ, eY, eX, hX, hY, hZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD3Demem<float>;
@@ -192,7 +192,9 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     lama::Matrix<ValueType> const &DyfStaggeredZ = derivatives.getDyfStaggeredZ();
     lama::Matrix<ValueType> const &DybStaggeredZ = derivatives.getDybStaggeredZ();     
 
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiverImpl::FDTD3Demem<ValueType> SourceReceiver(sources, receiver, wavefield);
+    kernelProfiler.start(Kernel::VelocityUpdate);
 
     /* ----------------*/
     /* hx */
@@ -200,8 +202,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = DyfStaggeredZ * eZ;
     update_temp = Dzf * eY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_ezy(update);
         ConvPML.apply_eyz(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageYZ;
@@ -213,8 +217,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = Dzf * eX;
     update_temp = Dxf * eZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_exz(update);
         ConvPML.apply_ezx(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXZ;
@@ -226,8 +232,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = Dxf * eY;
     update_temp = DyfStaggeredX * eX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_eyx(update);
         ConvPML.apply_exy(update_temp);
+        kernelProfiler.start(Kernel::VelocityUpdate);
     }
     update -= update_temp;
     update *= inverseMagneticPermeabilityAverageXY;
@@ -236,6 +244,7 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     /* ----------------*/
     /*  rX rY rZ       */
     /* ----------------*/
+    kernelProfiler.start(Kernel::StressUpdate);
     for (int l=0; l<numRelaxationMechanisms; l++) {
         update = Cc[l] * rX[l];
         update_temp = CdAverageX[l] * eX;
@@ -256,8 +265,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = DybStaggeredX * hZ;
     update_temp = Dzb * hY;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hzy(update);
         ConvPML.apply_hyz(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     for (int l=0; l<numRelaxationMechanisms; l++) {
@@ -273,8 +284,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = Dzb * hX;
     update_temp = Dxb * hZ;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hxz(update);
         ConvPML.apply_hzx(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     for (int l=0; l<numRelaxationMechanisms; l++) {
@@ -290,8 +303,10 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     update = Dxb * hY;
     update_temp = DybStaggeredZ * hX;
     if (useConvPML) {
+        kernelProfiler.start(Kernel::CPML);
         ConvPML.apply_hyx(update);
         ConvPML.apply_hxy(update_temp);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     update -= update_temp;
     for (int l=0; l<numRelaxationMechanisms; l++) {
@@ -303,12 +318,16 @@ void KITGPI::ForwardSolver::FD3Dviscoemem<ValueType>::run(Acquisition::Acquisiti
     
     /* Apply the damping boundary */
     if (useDampingBoundary) {
+        kernelProfiler.start(Kernel::CPML);
         DampingBoundary.apply(eZ, eY, eX, hX, hY, hZ);
+        kernelProfiler.start(Kernel::StressUpdate);
     }
     
     /* Apply source and save seismogram */
+    kernelProfiler.start(Kernel::SourceReceiver);
     SourceReceiver.applySource(t);
     SourceReceiver.gatherSeismogram(t);
+    kernelProfiler.endStep();
 }
 
 template class KITGPI::ForwardSolver::FD3Dviscoemem<float>;
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "IO.hpp"
+#include "OwnedRuns.hpp"
+#include <scai/dmemo/Distribution.hpp>
+#include <scai/lama/DenseVector.hpp>
+#include <scai/tracing.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace KITGPI
+{
+    namespace IO
+    {
+        using namespace scai;
+
+        /*! \brief Return the file suffix of a file format
+         *
+         \param fileFormat File format 1=mtx 2=lmf 3=frv 4=pmf
+         */
+        inline std::string getFileSuffix(IndexType fileFormat)
+        {
+            switch (fileFormat) {
+            case 1:
+                return ".mtx";
+            case 2:
+                return ".lmf";
+            case 3:
+                return ".frv";
+            case 4:
+                return ".pmf";
+            default:
+                break;
+            }
+            COMMON_THROWEXCEPTION("Unexpected fileFormat option!")
+            return "";
+        }
+
+        /*! \brief Determine the binary layout of a vector file
+         *
+         * Only layouts which can be verified by the file size are accepted, every other file returns false and has to be read by LAMA.
+         \param filename Name of the file including suffix
+         \param fileFormat File format 2=lmf (5 int header, float values) 3=frv (raw float or double values)
+         \param globalSize Number of elements expected in the file
+         \param offset Byte offset of the first value
+         \param elementSize Size of a single value in bytes
+         */
+        inline bool getBinaryLayout(std::string const &filename, IndexType fileFormat, IndexType globalSize, std::streamoff &offset, IndexType &elementSize)
+        {
+            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            if (!file.good()) {
+                return false;
+            }
+            std::streamoff fileSize = file.tellg();
+            std::streamoff numValues = globalSize;
+
+            switch (fileFormat) {
+            case 2:
+                offset = 5 * sizeof(int);
+                elementSize = sizeof(float);
+                return (fileSize == offset + numValues * elementSize);
+            case 3:
+                offset = 0;
+                if (fileSize == numValues * static_cast<std::streamoff>(sizeof(float))) {
+                    elementSize = sizeof(float);
+                    return true;
+                }
+                if (fileSize == numValues * static_cast<std::streamoff>(sizeof(double))) {
+                    elementSize = sizeof(double);
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+            }
+        }
+
+        /*! \brief Read the owned runs of a binary vector file into the local values of a vector
+         *
+         \param localValues Local values of the vector, has to be allocated with the local size of the distribution
+         \param filename Name of the file including suffix
+         \param ownedRuns Owned runs of the distribution
+         \param offset Byte offset of the first value
+         */
+        template <typename ValueType, typename FileValueType>
+        void readOwnedRuns(hmemo::HArray<ValueType> &localValues, std::string const &filename, OwnedRuns const &ownedRuns, std::streamoff offset)
+        {
+            std::ifstream file(filename, std::ios::binary);
+            SCAI_ASSERT_ERROR(file.good(), "Could not open file " << filename);
+
+            auto write_localValues = hmemo::hostWriteAccess(localValues);
+            std::vector<FileValueType> buffer;
+            IndexType position = 0;
+            for (auto const &run : ownedRuns.runs) {
+                buffer.resize(run.second);
+                file.seekg(offset + static_cast<std::streamoff>(run.first) * sizeof(FileValueType));
+                file.read(reinterpret_cast<char *>(buffer.data()), run.second * sizeof(FileValueType));
+                SCAI_ASSERT_ERROR(file.good(), "Error while reading " << run.second << " values at index " << run.first << " from file " << filename);
+                for (IndexType i = 0; i < run.second; i++) {
+                    write_localValues[ownedRuns.localIndex[position + i]] = static_cast<ValueType>(buffer[i]);
+                }
+                position += run.second;
+            }
+            Common::Profiler::global().addBytesRead(double(position) * sizeof(FileValueType));
+        }
+
+        /*! \brief Read several vectors from packed model files
+         *
+         * The filenames are split into container and parameter name at the last dot, e.g. model/model.vp is read as parameter vp from model/model.pmf.
+         * All parameters of one container are read together. If no container exists, every vector is read from its own single parameter file.
+         \param vectors Vectors which will be read, all vectors have to be allocated with the same distribution
+         \param filenames Names of the files without suffix
+         \param indexRuns Runs of the global file indexes of the local values
+         \param numValues Number of values stored in each file
+         \param parameterisation Expected parameterisation of the containers, -1 accepts any parameterisation
+         */
+        template <typename ValueType>
+        void readPackedVectors(std::vector<lama::DenseVector<ValueType> *> const &vectors, std::vector<std::string> const &filenames, OwnedRuns const &indexRuns, IndexType numValues, IndexType parameterisation = -1)
+        {
+            std::vector<std::string> containers;
+            std::vector<std::vector<lama::DenseVector<ValueType> *>> containerVectors;
+            std::vector<std::vector<std::string>> containerNames;
+            std::vector<std::vector<std::string>> containerFilenames;
+
+            for (unsigned i = 0; i < vectors.size(); i++) {
+                std::string container;
+                std::string name;
+                splitParameterName(filenames[i], container, name);
+                unsigned j = std::find(containers.begin(), containers.end(), container) - containers.begin();
+                if (j == containers.size()) {
+                    containers.push_back(container);
+                    containerVectors.emplace_back();
+                    containerNames.emplace_back();
+                    containerFilenames.emplace_back();
+                }
+                containerVectors[j].push_back(vectors[i]);
+                containerNames[j].push_back(name);
+                containerFilenames[j].push_back(filenames[i]);
+            }
+
+            for (unsigned j = 0; j < containers.size(); j++) {
+                if (!containers[j].empty() && std::ifstream(containers[j] + ".pmf").good()) {
+                    readPackedModel(containerVectors[j], containerNames[j], containers[j], indexRuns, numValues, parameterisation);
+                } else {
+                    // single parameter files are written without a model and do not describe a parameterisation
+                    for (unsigned i = 0; i < containerVectors[j].size(); i++) {
+                        readPackedModel({containerVectors[j][i]}, {containerNames[j][i]}, containerFilenames[j][i], indexRuns, numValues);
+                    }
+                }
+            }
+        }
+
+        /*! \brief Read the values at given global indexes of several files into vectors
+         *
+         * Every process reads only the index ranges it needs, which may belong to a different grid than the distribution of the vectors (e.g. a regular model read onto a variable grid).
+         * The layout of all files is checked by all processes first. If a single file cannot be read directly (e.g. mtx) nothing is read and false is returned.
+         \param vectors Vectors which will be read, all vectors have to be allocated with the same distribution
+         \param filenames Names of the files without suffix
+         \param fileFormat Input file format 1=mtx 2=lmf 3=frv 4=pmf
+         \param indexRuns Runs of the global file indexes of the local values
+         \param numValues Number of values stored in each file
+         \param parameterisation Expected parameterisation of packed model files, -1 accepts any parameterisation
+         */
+        template <typename ValueType>
+        bool readVectors(std::vector<lama::DenseVector<ValueType> *> const &vectors, std::vector<std::string> const &filenames, IndexType fileFormat, OwnedRuns const &indexRuns, IndexType numValues, IndexType parameterisation = -1)
+        {
+            SCAI_REGION("IO.readVectors")
+
+            SCAI_ASSERT_ERROR(vectors.size() == filenames.size(), "Number of vectors and filenames differ");
+            if (vectors.empty()) {
+                return true;
+            }
+
+            if (fileFormat == 4) {
+                readPackedVectors(vectors, filenames, indexRuns, numValues, parameterisation);
+                return true;
+            }
+
+            auto dist = vectors[0]->getDistributionPtr();
+            auto comm = dist->getCommunicatorPtr();
+
+            std::vector<std::streamoff> offsets(vectors.size(), 0);
+            std::vector<IndexType> elementSizes(vectors.size(), 0);
+            IndexType readDirect = 1;
+            for (unsigned i = 0; i < vectors.size(); i++) {
+                SCAI_ASSERT_ERROR(vectors[i]->getDistribution() == *dist, "All vectors have to use the same distribution");
+                if (!getBinaryLayout(filenames[i] + getFileSuffix(fileFormat), fileFormat, numValues, offsets[i], elementSizes[i])) {
+                    readDirect = 0;
+                }
+            }
+            // all processes have to agree
+            if (comm->min(readDirect) == 0) {
+                return false;
+            }
+
+            for (unsigned i = 0; i < vectors.size(); i++) {
+                std::string filename = filenames[i] + getFileSuffix(fileFormat);
+                HOST_PRINT(comm, "", "reading " << filename << " (owned ranges)\n");
+                if (elementSizes[i] == static_cast<IndexType>(sizeof(float))) {
+                    readOwnedRuns<ValueType, float>(vectors[i]->getLocalValues(), filename, indexRuns, offsets[i]);
+                } else {
+                    readOwnedRuns<ValueType, double>(vectors[i]->getLocalValues(), filename, indexRuns, offsets[i]);
+                }
+            }
+            return true;
+        }
+
+        /*! \brief Read several vectors with the same distribution from file in one pass
+         *
+         * The owned runs of the distribution are computed once and every process reads only its own index ranges directly into the target distribution,
+         * so no intermediate block distribution and no redistribution is necessary.
+         * Files whose layout cannot be verified (e.g. mtx) are read by readVector.
+         \param vectors Vectors which will be read, all vectors have to be allocated with the same distribution
+         \param filenames Names of the files without suffix
+         \param fileFormat Input file format 1=mtx 2=lmf 3=frv 4=pmf
+         \param parameterisation Expected parameterisation of packed model files, -1 accepts any parameterisation
+         */
+        template <typename ValueType>
+        void readVectors(std::vector<lama::DenseVector<ValueType> *> const &vectors, std::vector<std::string> const &filenames, IndexType fileFormat, IndexType parameterisation = -1)
+        {
+            SCAI_ASSERT_ERROR(vectors.size() == filenames.size(), "Number of vectors and filenames differ");
+            if (vectors.empty()) {
+                return;
+            }
+
+            auto dist = vectors[0]->getDistributionPtr();
+            OwnedRuns ownedRuns = getOwnedRuns(dist);
+
+            if (fileFormat == 4) {
+                readPackedVectors(vectors, filenames, ownedRuns, dist->getGlobalSize(), parameterisation);
+                return;
+            }
+
+            // files which cannot be read directly are read one by one via LAMA
+            for (unsigned i = 0; i < vectors.size(); i++) {
+                if (!readVectors<ValueType>({vectors[i]}, {filenames[i]}, fileFormat, ownedRuns, dist->getGlobalSize())) {
+                    readVector(*vectors[i], filenames[i], fileFormat);
+                }
+            }
+        }
+    }
+}
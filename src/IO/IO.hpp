@@ -1,8 +1,12 @@
 #pragma once
 
 #include "../Common/HostPrint.hpp"
+#include "../Common/Profiler.hpp"
+#include "PackedModel.hpp"
 #include <scai/lama/Vector.hpp>
 
+#include <sys/stat.h>
+
 namespace KITGPI
 {
     //! \brief IO namespace
@@ -10,12 +14,51 @@ namespace KITGPI
     {
         using namespace scai;
 
+        /*! \brief Size of a file in bytes
+         *
+         \param filename Name of the file including suffix
+         \return size of the file, 0 if the file does not exist
+         */
+        inline double getFileSize(std::string const &filename)
+        {
+            struct stat status;
+            if (::stat(filename.c_str(), &status) != 0) {
+                return 0;
+            }
+            return (double(status.st_size));
+        }
+
+        /*! \brief Count a file which was written as a whole by the processes of a communicator
+         *
+         * The size of the file is counted once by the master process, so text files and the row pointers and column indexes of sparse matrices are included.
+         \param filename Name of the file including suffix
+         \param comm Communicator of the processes which have written the file
+         */
+        inline void addFileBytesWritten(std::string const &filename, dmemo::CommunicatorPtr comm)
+        {
+            if (comm->getRank() == MASTERGPI) {
+                Common::Profiler::global().addBytesWritten(getFileSize(filename));
+            }
+        }
+
+        /*! \brief Count a file which was read as a whole by the processes of a communicator
+         *
+         \param filename Name of the file including suffix
+         \param comm Communicator of the processes which have read the file
+         */
+        inline void addFileBytesRead(std::string const &filename, dmemo::CommunicatorPtr comm)
+        {
+            if (comm->getRank() == MASTERGPI) {
+                Common::Profiler::global().addBytesRead(getFileSize(filename));
+            }
+        }
+
         /*! \brief Write lama vector to an external file
         *
         *  Write a lama vector to an external file block.
         \param vector lama vector which will be written to filename
         \param filename Name of file in which vector will be written
-        \param fileFormat Output file format 1=mtx 2=lmf 3=frv
+        \param fileFormat Output file format 1=mtx 2=lmf 3=frv 4=pmf
         */
         template <typename ValueType>
         void writeVector(lama::Vector<ValueType> const &vector, std::string filename, IndexType fileFormat)
@@ -40,19 +83,33 @@ namespace KITGPI
                 HOST_PRINT(comm, "", "writing " << filename << " (binary + separate header)\n")
                 vector.writeToFile(filename, lama::FileMode::BINARY);
                 break;
+            case 4: {
+                // packed model file with a single parameter, written in parallel
+                lama::DenseVector<ValueType> denseVector;
+                denseVector = vector;
+                std::string container;
+                std::string name;
+                splitParameterName(filename, container, name);
+                writePackedModel<ValueType>({&denseVector}, {name}, filename, PackedModelHeader());
+                break;
+            }
 
             default:
                 COMMON_THROWEXCEPTION("Unexpected fileFormat option!")
                 break;
             }
 
+            // packed model files are counted by writePackedModel
+            if (fileFormat != 4) {
+                addFileBytesWritten(filename, comm);
+            }
         }
 
         /*! \brief Read a Vector from file
         * 
         \param vector lama vector which will be written to filename the size of the input vector must be known before reading the data. The vector will be redistributed to the dist of the input vector.
         \param filename Name of file in which vector will be written
-        \param fileFormat Output file format 1=mtx 2=lmf 3=frv
+        \param fileFormat Output file format 1=mtx 2=lmf 3=frv 4=pmf
         */
         template <typename ValueType>
         void readVector(scai::lama::Vector<ValueType> &vector, std::string filename, IndexType fileFormat)
@@ -68,6 +125,15 @@ namespace KITGPI
             case 3:
                 filename += ".frv";
                 break;
+            case 4: {
+                // packed model file with a single parameter
+                auto denseVector = dynamic_cast<lama::DenseVector<ValueType> *>(&vector);
+                SCAI_ASSERT_ERROR(denseVector != nullptr, "Packed model files can only be read into dense vectors");
+                PackedModelHeader header = readPackedModelHeader(filename + ".pmf");
+                SCAI_ASSERT_ERROR(header.names.size() == 1, filename << ".pmf contains " << header.names.size() << " parameters, expected a single parameter");
+                readPackedModel<ValueType>({denseVector}, header.names, filename);
+                return;
+            }
 
             default:
                 COMMON_THROWEXCEPTION("Unexpected fileFormat option!")
@@ -80,6 +146,7 @@ namespace KITGPI
             vector.readFromFile(filename, vector.getDistributionPtr());
             
             IndexType numelements_read=vector.size();
+            addFileBytesRead(filename, vector.getDistributionPtr()->getCommunicatorPtr());
             
             SCAI_ASSERT(numelements_exp == numelements_read, "Read " << numelements_read << " elements from file: " << filename << ", expected " << numelements_exp << " elements!");
             
@@ -117,6 +184,7 @@ namespace KITGPI
             }
 
             HOST_PRINT(matrix.getRowDistributionPtr()->getCommunicatorPtr(), "", "writing " << filename << "\n")
+            addFileBytesWritten(filename, matrix.getRowDistributionPtr()->getCommunicatorPtr());
 
         }
 
@@ -156,6 +224,7 @@ namespace KITGPI
 //             std::cout << "Finish reading " << filename << std::endl;
             
             IndexType numrows_read=matrix.getNumRows();
+            addFileBytesRead(filename, matrix.getRowDistributionPtr()->getCommunicatorPtr());
             IndexType numcols_read=matrix.getNumColumns();           
             
             SCAI_ASSERT(numrows_exp == numrows_read, "Read " << numrows_read << " rows from file: " << filename << " expected " << numrows_exp << " rows!");
@@ -191,6 +260,12 @@ namespace KITGPI
             matrix.readFromFile(filename, rowNumber, 1);
 
             hmemo::HArray<ValueType> localsignal = matrix.getValues();
+            // a formatted file has to be parsed as text, a binary file is read at the row only (lmf stores float)
+            if (fileFormat == 1) {
+                Common::Profiler::global().addBytesRead(getFileSize(filename));
+            } else {
+                Common::Profiler::global().addBytesRead(double(localsignal.size()) * (fileFormat == 2 ? sizeof(float) : sizeof(ValueType)));
+            }
             return (localsignal);
         }
     }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <scai/dmemo/Distribution.hpp>
+#include <scai/hmemo/HArray.hpp>
+#include <scai/hmemo/ReadAccess.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace KITGPI
+{
+    namespace IO
+    {
+        using namespace scai;
+
+        /*! \brief Owned global indexes of a distribution grouped into contiguous runs
+         *
+         * The runs are sorted by global index so that each run can be read from a file by a single seek and read.
+         * localIndex maps the position inside the sorted runs to the local position in the distributed vector.
+         * Two local positions with the same global index are stored in separate runs.
+         */
+        struct OwnedRuns {
+            std::vector<IndexType> localIndex;                 //!< local position of the sorted owned indexes
+            std::vector<std::pair<IndexType, IndexType>> runs; //!< first global index and length of each run
+        };
+
+        /*! \brief Group global indexes into contiguous runs
+         *
+         * The indexes may be unordered and may contain duplicates, e.g. the regular grid indexes of the points of a variable grid.
+         \param globalIndexes Global index for every local position
+         */
+        inline OwnedRuns getIndexRuns(std::vector<IndexType> const &globalIndexes)
+        {
+            std::vector<std::pair<IndexType, IndexType>> globalLocal;
+            globalLocal.reserve(globalIndexes.size());
+            for (IndexType localIndex = 0; localIndex < static_cast<IndexType>(globalIndexes.size()); localIndex++) {
+                globalLocal.emplace_back(globalIndexes[localIndex], localIndex);
+            }
+            std::sort(globalLocal.begin(), globalLocal.end());
+
+            OwnedRuns ownedRuns;
+            ownedRuns.localIndex.reserve(globalLocal.size());
+            for (auto const &entry : globalLocal) {
+                if (!ownedRuns.runs.empty() && ownedRuns.runs.back().first + ownedRuns.runs.back().second == entry.first) {
+                    ownedRuns.runs.back().second++;
+                } else {
+                    ownedRuns.runs.emplace_back(entry.first, 1);
+                }
+                ownedRuns.localIndex.push_back(entry.second);
+            }
+            return ownedRuns;
+        }
+
+        /*! \brief Group the owned indexes of a distribution into contiguous runs
+         *
+         \param dist Distribution of the vector which will be read
+         */
+        inline OwnedRuns getOwnedRuns(dmemo::DistributionPtr dist)
+        {
+            hmemo::HArray<IndexType> ownedIndexes;
+            dist->getOwnedIndexes(ownedIndexes);
+
+            auto read_ownedIndexes = hmemo::hostReadAccess(ownedIndexes);
+            return getIndexRuns(std::vector<IndexType>(read_ownedIndexes.begin(), read_ownedIndexes.end()));
+        }
+    }
+}
@@ -0,0 +1,405 @@
+#pragma once
+
+#include "../Common/HostPrint.hpp"
+#include "../Common/Profiler.hpp"
+#include "OwnedRuns.hpp"
+#include <scai/dmemo/Distribution.hpp>
+#include <scai/hmemo/WriteAccess.hpp>
+#include <scai/lama/DenseVector.hpp>
+#include <scai/tracing.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace KITGPI
+{
+    namespace IO
+    {
+        using namespace scai;
+
+        /*! \brief Header of a packed model file (.pmf)
+         *
+         * A packed model file stores several modelparameters of one grid in a single binary file:
+         *
+         * magic "WAVEPMF1" (8 byte), valueSize, layout, parameterisation, numParameters (int32),
+         * NX, NY, NZ (int64), DH (double) and for each parameter its name (32 byte) and the byte offset of its first value (int64).
+         *
+         * The values follow the header either planar (one array per parameter) or interleaved (all parameters of one grid point are consecutive).
+         */
+        struct PackedModelHeader {
+            int32_t valueSize = sizeof(float); //!< size of a single value in bytes, 4=float 8=double
+            int32_t layout = 0;                //!< 0=planar 1=interleaved
+            int32_t parameterisation = 0;      //!< parameterisation of the model
+            int64_t NX = 0;                    //!< number of grid points in x-direction
+            int64_t NY = 0;                    //!< number of grid points in y-direction
+            int64_t NZ = 0;                    //!< number of grid points in z-direction
+            double DH = 0;                     //!< grid spacing
+            std::vector<std::string> names;    //!< names of the parameters (e.g. vp, vs, density)
+            std::vector<int64_t> offsets;      //!< byte offset of the first value of each parameter
+
+            static constexpr int nameLength = 32;
+            static constexpr int maxParameters = 64; //!< maximum number of parameters of a file
+
+            //! \brief Number of grid points
+            int64_t numGridpoints() const { return NX * NY * NZ; }
+            //! \brief Size of the header in bytes
+            int64_t headerSize() const { return 8 + 4 * sizeof(int32_t) + 3 * sizeof(int64_t) + sizeof(double) + names.size() * (nameLength + sizeof(int64_t)); }
+            //! \brief Distance between two values of the same parameter in bytes
+            int64_t stride() const { return layout == 1 ? valueSize * static_cast<int64_t>(names.size()) : valueSize; }
+            //! \brief Size of the file in bytes
+            int64_t fileSize() const { return headerSize() + numGridpoints() * valueSize * static_cast<int64_t>(names.size()); }
+
+            //! \brief Calculate the offsets of all parameters from the layout
+            void calcOffsets()
+            {
+                offsets.resize(names.size());
+                for (unsigned i = 0; i < names.size(); i++) {
+                    offsets[i] = headerSize() + (layout == 1 ? i * static_cast<int64_t>(valueSize) : i * numGridpoints() * valueSize);
+                }
+            }
+
+            /*! \brief Check the value size, the layout and the number of parameters
+             *
+             * The same checks are used for reading and writing, so every written file can be read again.
+             \param numParameters Number of parameters of the file
+             \param filename Name of the file
+             */
+            void checkFormat(int64_t numParameters, std::string const &filename) const
+            {
+                SCAI_ASSERT_ERROR(valueSize == static_cast<int32_t>(sizeof(float)) || valueSize == static_cast<int32_t>(sizeof(double)), "Unsupported value size " << valueSize << " of " << filename);
+                SCAI_ASSERT_ERROR(layout == 0 || layout == 1, "Unsupported layout " << layout << " of " << filename);
+                SCAI_ASSERT_ERROR(numParameters > 0 && numParameters <= maxParameters, "Invalid number of parameters " << numParameters << " of " << filename);
+            }
+
+            //! \brief Return the position of a parameter, -1 if the parameter is not stored in the file
+            int getParameterIndex(std::string const &name) const
+            {
+                for (unsigned i = 0; i < names.size(); i++) {
+                    if (names[i] == name) {
+                        return i;
+                    }
+                }
+                return -1;
+            }
+        };
+
+        /*! \brief Split a filename into container and parameter name at the last dot
+         *
+         * model/model.vp is split into model/model and vp. A filename without a dot in its basename returns an empty container and the filename as name.
+         \param filename Filename without suffix
+         \param container Name of the packed model file without suffix
+         \param name Name of the parameter
+         */
+        inline void splitParameterName(std::string const &filename, std::string &container, std::string &name)
+        {
+            size_t dot = filename.find_last_of('.');
+            size_t slash = filename.find_last_of('/');
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+                container = "";
+                name = filename;
+            } else {
+                container = filename.substr(0, dot);
+                name = filename.substr(dot + 1);
+            }
+        }
+
+        /*! \brief Read the header of a packed model file
+         *
+         * The header is validated against the size of the file, so a truncated or foreign file is rejected before any value is read.
+         \param filename Name of the file including suffix
+         */
+        inline PackedModelHeader readPackedModelHeader(std::string const &filename)
+        {
+            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            SCAI_ASSERT_ERROR(file.good(), "Could not open packed model file " << filename);
+            int64_t fileSize = file.tellg();
+            file.seekg(0);
+
+            char magic[8];
+            file.read(magic, 8);
+            SCAI_ASSERT_ERROR(file.good() && std::strncmp(magic, "WAVEPMF1", 8) == 0, filename << " is not a packed model file");
+
+            PackedModelHeader header;
+            int32_t numParameters = 0;
+            file.read(reinterpret_cast<char *>(&header.valueSize), sizeof(int32_t));
+            file.read(reinterpret_cast<char *>(&header.layout), sizeof(int32_t));
+            file.read(reinterpret_cast<char *>(&header.parameterisation), sizeof(int32_t));
+            file.read(reinterpret_cast<char *>(&numParameters), sizeof(int32_t));
+            file.read(reinterpret_cast<char *>(&header.NX), sizeof(int64_t));
+            file.read(reinterpret_cast<char *>(&header.NY), sizeof(int64_t));
+            file.read(reinterpret_cast<char *>(&header.NZ), sizeof(int64_t));
+            file.read(reinterpret_cast<char *>(&header.DH), sizeof(double));
+            SCAI_ASSERT_ERROR(file.good(), "Error while reading the header of " << filename);
+            header.checkFormat(numParameters, filename);
+            SCAI_ASSERT_ERROR(header.NX > 0 && header.NY > 0 && header.NZ > 0, "Invalid grid " << header.NX << " x " << header.NY << " x " << header.NZ << " in " << filename);
+            // the partial products are bounded by the file size, so the number of grid points cannot overflow
+            SCAI_ASSERT_ERROR(header.NX <= fileSize && header.NY <= fileSize / header.NX && header.NZ <= fileSize / (header.NX * header.NY) && header.numGridpoints() <= fileSize / header.valueSize, "Grid " << header.NX << " x " << header.NY << " x " << header.NZ << " does not fit into " << filename << " (" << fileSize << " bytes)");
+
+            header.names.resize(numParameters);
+            SCAI_ASSERT_ERROR(header.headerSize() <= fileSize, "Header of " << filename << " is truncated");
+            for (int32_t i = 0; i < numParameters; i++) {
+                char name[PackedModelHeader::nameLength + 1] = {0};
+                int64_t offset = 0;
+                file.read(name, PackedModelHeader::nameLength);
+                file.read(reinterpret_cast<char *>(&offset), sizeof(int64_t));
+                header.names[i] = name;
+                header.offsets.push_back(offset);
+            }
+            SCAI_ASSERT_ERROR(file.good(), "Error while reading the header of " << filename);
+
+            // the last value of every parameter has to be inside the file
+            int64_t valuesSize = (header.numGridpoints() - 1) * header.stride() + header.valueSize;
+            for (int32_t i = 0; i < numParameters; i++) {
+                SCAI_ASSERT_ERROR(header.offsets[i] >= header.headerSize() && header.offsets[i] <= fileSize - valuesSize, "Parameter " << header.names[i] << " at offset " << header.offsets[i] << " exceeds " << filename << " (" << fileSize << " bytes), the file is truncated or corrupt");
+            }
+
+            return header;
+        }
+
+        /*! \brief Write the header of a packed model file
+         *
+         \param file Output stream positioned at the beginning of the file
+         \param header Header which will be written
+         */
+        inline void writePackedModelHeader(std::ostream &file, PackedModelHeader const &header)
+        {
+            int32_t numParameters = header.names.size();
+            file.write("WAVEPMF1", 8);
+            file.write(reinterpret_cast<char const *>(&header.valueSize), sizeof(int32_t));
+            file.write(reinterpret_cast<char const *>(&header.layout), sizeof(int32_t));
+            file.write(reinterpret_cast<char const *>(&header.parameterisation), sizeof(int32_t));
+            file.write(reinterpret_cast<char const *>(&numParameters), sizeof(int32_t));
+            file.write(reinterpret_cast<char const *>(&header.NX), sizeof(int64_t));
+            file.write(reinterpret_cast<char const *>(&header.NY), sizeof(int64_t));
+            file.write(reinterpret_cast<char const *>(&header.NZ), sizeof(int64_t));
+            file.write(reinterpret_cast<char const *>(&header.DH), sizeof(double));
+
+            for (int32_t i = 0; i < numParameters; i++) {
+                SCAI_ASSERT_ERROR(static_cast<int>(header.names[i].size()) < PackedModelHeader::nameLength, "Parameter name " << header.names[i] << " is too long");
+                char name[PackedModelHeader::nameLength] = {0};
+                header.names[i].copy(name, header.names[i].size());
+                file.write(name, PackedModelHeader::nameLength);
+                file.write(reinterpret_cast<char const *>(&header.offsets[i]), sizeof(int64_t));
+            }
+        }
+
+        /*! \brief Write the owned runs of several vectors to a packed model file
+         *
+         \param file File opened for reading and writing
+         \param localValues Local values of the vectors in the order of the header
+         \param header Header of the file
+         \param ownedRuns Owned runs of the distribution
+         */
+        template <typename ValueType, typename FileValueType>
+        void writePackedRuns(std::fstream &file, std::vector<hmemo::HArray<ValueType> const *> const &localValues, PackedModelHeader const &header, OwnedRuns const &ownedRuns)
+        {
+            IndexType numParameters = localValues.size();
+            std::vector<FileValueType> buffer;
+            IndexType position = 0;
+
+            for (auto const &run : ownedRuns.runs) {
+                if (header.layout == 1) {
+                    buffer.resize(run.second * numParameters);
+                    for (IndexType p = 0; p < numParameters; p++) {
+                        auto read_localValues = hmemo::hostReadAccess(*localValues[p]);
+                        for (IndexType i = 0; i < run.second; i++) {
+                            buffer[i * numParameters + p] = static_cast<FileValueType>(read_localValues[ownedRuns.localIndex[position + i]]);
+                        }
+                    }
+                    file.seekp(header.offsets[0] + run.first * header.stride());
+                    file.write(reinterpret_cast<char const *>(buffer.data()), buffer.size() * sizeof(FileValueType));
+                } else {
+                    buffer.resize(run.second);
+                    for (IndexType p = 0; p < numParameters; p++) {
+                        auto read_localValues = hmemo::hostReadAccess(*localValues[p]);
+                        for (IndexType i = 0; i < run.second; i++) {
+                            buffer[i] = static_cast<FileValueType>(read_localValues[ownedRuns.localIndex[position + i]]);
+                        }
+                        file.seekp(header.offsets[p] + run.first * header.stride());
+                        file.write(reinterpret_cast<char const *>(buffer.data()), buffer.size() * sizeof(FileValueType));
+                    }
+                }
+                SCAI_ASSERT_ERROR(file.good(), "Error while writing packed model run at index " << run.first);
+                position += run.second;
+            }
+        }
+
+        /*! \brief Read the owned runs of several parameters from a packed model file
+         *
+         \param file Opened packed model file
+         \param localValues Local values of the vectors which will be filled
+         \param parameterIndexes Position of each vector in the header
+         \param header Header of the file
+         \param ownedRuns Owned runs of the distribution
+         */
+        template <typename ValueType, typename FileValueType>
+        void readPackedRuns(std::ifstream &file, std::vector<hmemo::HArray<ValueType> *> const &localValues, std::vector<int> const &parameterIndexes, PackedModelHeader const &header, OwnedRuns const &ownedRuns)
+        {
+            IndexType numParameters = header.names.size();
+            std::vector<FileValueType> buffer;
+            IndexType position = 0;
+
+            std::vector<hmemo::WriteAccess<ValueType>> write_localValues;
+            write_localValues.reserve(localValues.size());
+            for (auto values : localValues) {
+                write_localValues.emplace_back(*values, hmemo::Context::getHostPtr());
+            }
+
+            for (auto const &run : ownedRuns.runs) {
+                if (header.layout == 1) {
+                    // one read per run fills all parameters
+                    buffer.resize(run.second * numParameters);
+                    file.seekg(header.offsets[0] + run.first * header.stride());
+                    file.read(reinterpret_cast<char *>(buffer.data()), buffer.size() * sizeof(FileValueType));
+                    for (unsigned p = 0; p < localValues.size(); p++) {
+                        for (IndexType i = 0; i < run.second; i++) {
+                            write_localValues[p][ownedRuns.localIndex[position + i]] = static_cast<ValueType>(buffer[i * numParameters + parameterIndexes[p]]);
+                        }
+                    }
+                } else {
+                    buffer.resize(run.second);
+                    for (unsigned p = 0; p < localValues.size(); p++) {
+                        file.seekg(header.offsets[parameterIndexes[p]] + run.first * header.stride());
+                        file.read(reinterpret_cast<char *>(buffer.data()), buffer.size() * sizeof(FileValueType));
+                        for (IndexType i = 0; i < run.second; i++) {
+                            write_localValues[p][ownedRuns.localIndex[position + i]] = static_cast<ValueType>(buffer[i]);
+                        }
+                    }
+                }
+                SCAI_ASSERT_ERROR(file.good(), "Error while reading packed model run at index " << run.first);
+                position += run.second;
+            }
+        }
+
+        /*! \brief Write several vectors of the same distribution to a packed model file
+         *
+         * The master process writes the header and allocates the file, afterwards every process writes its owned index ranges.
+         \param vectors Vectors which will be written
+         \param names Names of the parameters (e.g. vp, vs, density)
+         \param filename Name of the file, ".pmf" will be added
+         \param header Grid description of the model, names and offsets will be set by this function
+         \param valueSize Size of the stored values 4=float 8=double
+         */
+        template <typename ValueType>
+        void writePackedModel(std::vector<lama::DenseVector<ValueType> const *> const &vectors, std::vector<std::string> const &names, std::string filename, PackedModelHeader header, IndexType valueSize = sizeof(float))
+        {
+            SCAI_REGION("IO.writePackedModel")
+
+            SCAI_ASSERT_ERROR(vectors.size() == names.size() && !vectors.empty(), "Number of vectors and names differ");
+
+            auto dist = vectors[0]->getDistributionPtr();
+            auto comm = dist->getCommunicatorPtr();
+            filename += ".pmf";
+
+            header.valueSize = valueSize;
+            header.checkFormat(names.size(), filename);
+
+            if (header.numGridpoints() != dist->getGlobalSize()) {
+                // vector without grid description, e.g. a single wavefield
+                header.NX = dist->getGlobalSize();
+                header.NY = 1;
+                header.NZ = 1;
+            }
+            header.names = names;
+            header.calcOffsets();
+
+            HOST_PRINT(comm, "", "writing " << filename << " (packed model, " << names.size() << " parameters)\n")
+
+            if (comm->getRank() == MASTERGPI) {
+                std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+                SCAI_ASSERT_ERROR(file.good(), "Could not open file " << filename);
+                writePackedModelHeader(file, header);
+                file.seekp(header.fileSize() - 1);
+                file.put(0);
+                SCAI_ASSERT_ERROR(file.good(), "Error while allocating file " << filename);
+            }
+            comm->synchronize();
+
+            // a replicated vector is written by the master process only
+            if (!dist->isReplicated() || comm->getRank() == MASTERGPI) {
+                std::vector<hmemo::HArray<ValueType> const *> localValues;
+                for (auto vector : vectors) {
+                    SCAI_ASSERT_ERROR(vector->getDistribution() == *dist, "All vectors have to use the same distribution");
+                    localValues.push_back(&vector->getLocalValues());
+                }
+
+                OwnedRuns ownedRuns = getOwnedRuns(dist);
+                std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+                SCAI_ASSERT_ERROR(file.good(), "Could not open file " << filename);
+                if (valueSize == static_cast<IndexType>(sizeof(float))) {
+                    writePackedRuns<ValueType, float>(file, localValues, header, ownedRuns);
+                } else {
+                    writePackedRuns<ValueType, double>(file, localValues, header, ownedRuns);
+                }
+                Common::Profiler::global().addBytesWritten(double(vectors.size()) * ownedRuns.localIndex.size() * valueSize);
+            }
+            comm->synchronize();
+        }
+
+        /*! \brief Read several parameters at given global indexes from a packed model file
+         *
+         * Every process reads only the given index ranges, for the interleaved layout all parameters of a run are read at once.
+         \param vectors Vectors which will be read, all vectors have to be allocated with the same distribution
+         \param names Names of the parameters in the packed model file
+         \param filename Name of the file, ".pmf" will be added
+         \param indexRuns Runs of the global file indexes of the local values
+         \param numValues Number of grid points stored in the file
+         \param parameterisation Expected parameterisation of the model, -1 accepts any parameterisation
+         */
+        template <typename ValueType>
+        void readPackedModel(std::vector<lama::DenseVector<ValueType> *> const &vectors, std::vector<std::string> const &names, std::string filename, OwnedRuns const &indexRuns, IndexType numValues, IndexType parameterisation = -1)
+        {
+            SCAI_REGION("IO.readPackedModel")
+
+            SCAI_ASSERT_ERROR(vectors.size() == names.size(), "Number of vectors and names differ");
+            if (vectors.empty()) {
+                return;
+            }
+
+            auto dist = vectors[0]->getDistributionPtr();
+            filename += ".pmf";
+            HOST_PRINT(dist->getCommunicatorPtr(), "", "reading " << filename << " (packed model, " << names.size() << " parameters)\n");
+
+            PackedModelHeader header = readPackedModelHeader(filename);
+            SCAI_ASSERT_ERROR(header.numGridpoints() == numValues, "Packed model " << filename << " contains " << header.numGridpoints() << " grid points, expected " << numValues);
+            SCAI_ASSERT_ERROR(parameterisation < 0 || header.parameterisation == parameterisation, "Packed model " << filename << " uses parameterisation " << header.parameterisation << ", the model uses parameterisation " << parameterisation);
+
+            std::vector<hmemo::HArray<ValueType> *> localValues;
+            std::vector<int> parameterIndexes;
+            for (unsigned i = 0; i < vectors.size(); i++) {
+                SCAI_ASSERT_ERROR(vectors[i]->getDistribution() == *dist, "All vectors have to use the same distribution");
+                int parameterIndex = header.getParameterIndex(names[i]);
+                SCAI_ASSERT_ERROR(parameterIndex >= 0, "Parameter " << names[i] << " is not stored in " << filename);
+                localValues.push_back(&vectors[i]->getLocalValues());
+                parameterIndexes.push_back(parameterIndex);
+            }
+
+            std::ifstream file(filename, std::ios::binary);
+            if (header.valueSize == static_cast<int32_t>(sizeof(float))) {
+                readPackedRuns<ValueType, float>(file, localValues, parameterIndexes, header, indexRuns);
+            } else {
+                readPackedRuns<ValueType, double>(file, localValues, parameterIndexes, header, indexRuns);
+            }
+            Common::Profiler::global().addBytesRead(double(vectors.size()) * indexRuns.localIndex.size() * header.valueSize);
+        }
+
+        /*! \brief Read several parameters from a packed model file
+         *
+         \param vectors Vectors which will be read, all vectors have to be allocated with the same distribution
+         \param names Names of the parameters in the packed model file
+         \param filename Name of the file, ".pmf" will be added
+         */
+        template <typename ValueType>
+        void readPackedModel(std::vector<lama::DenseVector<ValueType> *> const &vectors, std::vector<std::string> const &names, std::string filename)
+        {
+            if (vectors.empty()) {
+                return;
+            }
+            auto dist = vectors[0]->getDistributionPtr();
+            readPackedModel(vectors, names, filename, getOwnedRuns(dist), dist->getGlobalSize());
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "../Acquisition/Coordinates.hpp"
 #include "../Common/HostPrint.hpp"
+#include "../Common/Profiler.hpp"
 #include "segy.hpp"
 #include <scai/dmemo/BlockDistribution.hpp>
 #include <scai/dmemo/CollectiveFile.hpp>
@@ -266,6 +267,7 @@ namespace KITGPI
             cfile->open(filetemp, "w");
             cfile->writeAll(localBuffer);
             cfile->close();
+            Common::Profiler::global().addBytesWritten(localBuffer.size());
         }
 
         //! \brief Read a SU file from disk without header
@@ -317,6 +319,7 @@ namespace KITGPI
             HOST_PRINT(data.getRowDistributionPtr()->getCommunicatorPtr(), "", "reading " << filenameTmp << "\n");
             cfile->readAll(localBuffer, numLocalTraces * (240 + sizeof(float) * ns));
             cfile->close();
+            Common::Profiler::global().addBytesRead(localBuffer.size());
 
             scai::hmemo::HArray<float> localTraces(numLocalTraces * ns);
             auto writeLocalData = hmemo::hostWriteAccess(localTraces);
@@ -365,6 +368,7 @@ namespace KITGPI
             fseek(pFile, nSkip, SEEK_CUR);
             notUsed = fread(&tr.data[0], 4, tr.ns, pFile);
             (void)notUsed;
+            Common::Profiler::global().addBytesRead(240 + tr.ns * 4);
 
             dataTmp.setRawData(tr.ns, tr.data);
             traceTmp.assign(dataTmp);
@@ -108,7 +108,6 @@ namespace KITGPI
             KITGPI::Modelparameter::Acoustic<ValueType> &operator=(KITGPI::Modelparameter::Acoustic<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates);
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::equationType;
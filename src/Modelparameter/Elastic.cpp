@@ -105,36 +105,36 @@ void KITGPI::Modelparameter::Elastic<ValueType>::getModelPerShot(KITGPI::Modelpa
 {
     auto distBig = density.getDistributionPtr();
 
-    scai::lama::CSRSparseMatrix<ValueType> shrinkMatrix = this->getShrinkMatrix(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
+    this->initWindowPlan(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
 
     lama::DenseVector<ValueType> temp;
     
-    temp = shrinkMatrix * velocityP;
+    this->getWindow(temp, velocityP);
     modelPerShot.setVelocityP(temp);
         
-    temp = shrinkMatrix * velocityS;
+    this->getWindow(temp, velocityS);
     modelPerShot.setVelocityS(temp);
     
-    temp = shrinkMatrix * density;
+    this->getWindow(temp, density);
     modelPerShot.setDensity(temp);
     
-    temp = shrinkMatrix * porosity;
+    this->getWindow(temp, porosity);
     modelPerShot.setPorosity(temp);
     
-    temp = shrinkMatrix * saturation;
+    this->getWindow(temp, saturation);
     modelPerShot.setSaturation(temp);  
     
-    temp = shrinkMatrix * reflectivity;
+    this->getWindow(temp, reflectivity);
     modelPerShot.setReflectivity(temp);    
     
     if (this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        temp = shrinkMatrix * bulkModulusRockMatrix;
+        this->getWindow(temp, bulkModulusRockMatrix);
         modelPerShot.setBulkModulusRockMatrix(temp);
         
-        temp = shrinkMatrix * shearModulusRockMatrix;
+        this->getWindow(temp, shearModulusRockMatrix);
         modelPerShot.setShearModulusRockMatrix(temp);
         
-        temp = shrinkMatrix * densityRockMatrix;
+        this->getWindow(temp, densityRockMatrix);
         modelPerShot.setDensityRockMatrix(temp);
     }
 }
@@ -174,13 +174,12 @@ void KITGPI::Modelparameter::Elastic<ValueType>::init(Configuration::Configurati
     } else if (config.get<IndexType>("ModelRead") == 1 && config.get<IndexType>("UseVariableGrid") == 1) {
 
         Acquisition::Coordinates<ValueType> regularCoordinates(config.get<IndexType>("NX"), config.get<IndexType>("NY"), config.get<IndexType>("NZ"), config.get<ValueType>("DH"));
-        dmemo::DistributionPtr regularDist(new dmemo::BlockDistribution(regularCoordinates.getNGridpoints(), dist->getCommunicatorPtr()));
 
-        init(ctx, regularDist, config.get<std::string>("ModelFilename"), config.get<IndexType>("FileFormat"));
-
-        HOST_PRINT(dist->getCommunicatorPtr(), "", "reading regular model finished\n\n")
+        // read only the regular grid samples needed by the variable grid
+        this->initRegularModelMapping(dist, modelCoordinates, regularCoordinates);
+        init(ctx, dist, config.get<std::string>("ModelFilename"), config.get<IndexType>("FileFormat"));
+        this->clearRegularModelMapping();
 
-        init(dist, modelCoordinates, regularCoordinates);
         HOST_PRINT(dist->getCommunicatorPtr(), "", "initialising model on discontineous grid finished\n")
 
     } else {
@@ -189,37 +188,6 @@ void KITGPI::Modelparameter::Elastic<ValueType>::init(Configuration::Configurati
 
 }
 
-/*! \brief initialisation function which creates a variable grid model on top of a regular model
-             \param model regular input model
-             \param variableDist Distribution for a variable grid
-             \param variableCoordinates Coordinate Class of a Variable Grid
-             \param regularCoordinates Coordinate Class of a regular Grid
-             */
-template <typename ValueType>
-void KITGPI::Modelparameter::Elastic<ValueType>::init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates)
-{
-
-    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
-    variableDist->getOwnedIndexes(ownedIndexes);
-
-    lama::MatrixAssembly<ValueType> assembly;
-
-    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
-
-        Acquisition::coordinate3D coordinate = variableCoordinates.index2coordinate(ownedIndex);
-        IndexType const &regularIndex = regularCoordinates.coordinate2index(coordinate);
-        assembly.push(ownedIndex, regularIndex, 1.0);
-    }
-
-    lama::CSRSparseMatrix<ValueType> meshingMatrix;
-    meshingMatrix = lama::zero<lama::CSRSparseMatrix<ValueType>>(variableDist, velocityP.getDistributionPtr());
-    meshingMatrix.fillFromAssembly(assembly);
-
-    density = meshingMatrix * density;
-    velocityP = meshingMatrix * velocityP;
-    velocityS = meshingMatrix * velocityS;
-}
-
 /*! \brief Constructor that is generating a homogeneous model
  *
  *  Generates a homogeneous model, which will be initialized by the two given scalar values.
@@ -283,21 +251,7 @@ KITGPI::Modelparameter::Elastic<ValueType>::Elastic(scai::hmemo::ContextPtr ctx,
 template <typename ValueType>
 void KITGPI::Modelparameter::Elastic<ValueType>::init(scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::string filename, IndexType fileFormat)
 {
-    this->initModelparameter(velocityP, ctx, dist, filename + ".vp", fileFormat);
-    this->initModelparameter(velocityS, ctx, dist, filename + ".vs", fileFormat);
-    this->initModelparameter(density, ctx, dist, filename + ".density", fileFormat);
-    if (this->getInversionType() == 3 || this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        this->initModelparameter(porosity, ctx, dist, filename + ".porosity", fileFormat);
-        this->initModelparameter(saturation, ctx, dist, filename + ".saturation", fileFormat);
-    } else {
-        this->initModelparameter(porosity, ctx, dist, 0.0);
-        this->initModelparameter(saturation, ctx, dist, 0.0);
-    }
-    if (this->getGradientKernel() != 0 && this->getDecomposition() == 0) {
-        this->initModelparameter(reflectivity, ctx, dist, filename + ".reflectivity", fileFormat);
-    } else {
-        this->initModelparameter(reflectivity, ctx, dist, 0.0);
-    }
+    this->initModelparameters({{&velocityP, ".vp"}, {&velocityS, ".vs"}, {&density, ".density"}}, ctx, dist, filename, fileFormat);
 }
 
 //! \brief Copy constructor
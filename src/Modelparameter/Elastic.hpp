@@ -99,7 +99,6 @@ namespace KITGPI
             KITGPI::Modelparameter::Elastic<ValueType> &operator=(KITGPI::Modelparameter::Elastic<ValueType> const &rhs);
             
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates);
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::equationType;
@@ -1,5 +1,6 @@
 #include "Modelparameter.hpp"
 #include "../IO/IO.hpp"
+#include "../IO/ChunkedIO.hpp"
 
 using namespace scai;
 using namespace KITGPI;
@@ -171,6 +172,84 @@ scai::lama::CSRSparseMatrix<ValueType> KITGPI::Modelparameter::Modelparameter<Va
     return shrinkMatrix;
 }
 
+/*! \brief Prepare the communication plan which copies a per-shot window out of the big model
+ *
+ *  Every process computes the big model index of its per-shot points, the resulting plan is reused by getWindow for all parameters.
+ *  The plan is kept if the next shot uses the same cut coordinate and distributions.
+ *  On regular grids the index is linear in the coordinates, so the indexes of the window shape are computed once and only shifted by the index of the cut coordinate for the next shots.
+ \param dist Distribution of the pershot
+ \param distBig Distribution of the big model
+ \param modelCoordinates coordinate class object of the pershot
+ \param modelCoordinatesBig coordinate class object of the big model
+ \param cutCoordinate coordinate where to cut the pershot
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::initWindowPlan(scai::dmemo::DistributionPtr dist, scai::dmemo::DistributionPtr distBig, Acquisition::Coordinates<ValueType> const &modelCoordinates, Acquisition::Coordinates<ValueType> const &modelCoordinatesBig, Acquisition::coordinate3D const cutCoordinate)
+{
+    if (windowPlan && windowDist == dist && windowDistBig == distBig && windowCutCoordinate == cutCoordinate) {
+        return;
+    }
+
+    SCAI_REGION("Modelparameter.initWindowPlan")
+
+    bool regularGrid = !modelCoordinates.isVariable() && !modelCoordinatesBig.isVariable();
+    bool sameShape = windowPlan && windowDist == dist && windowDistBig == distBig;
+
+    hmemo::HArray<IndexType> bigIndexes;
+    if (!regularGrid || !sameShape) {
+        Acquisition::coordinate3D offset = cutCoordinate;
+        if (regularGrid) {
+            offset.x = 0;
+            offset.y = 0;
+            offset.z = 0;
+        }
+
+        hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
+        dist->getOwnedIndexes(ownedIndexes);
+        std::vector<Acquisition::coordinate3D> coordinates = modelCoordinates.index2coordinate(ownedIndexes);
+        for (auto &coordinate : coordinates) {
+            coordinate.x += offset.x;
+            coordinate.y += offset.y;
+            coordinate.z += offset.z;
+        }
+        bigIndexes = modelCoordinatesBig.coordinate2index(coordinates);
+        if (regularGrid) {
+            windowIndexes = bigIndexes;
+        }
+    }
+    if (regularGrid) {
+        // offset depends on shot number
+        IndexType cutIndex = modelCoordinatesBig.coordinate2index(cutCoordinate);
+        bigIndexes.resize(windowIndexes.size());
+        auto read_windowIndexes = hmemo::hostReadAccess(windowIndexes);
+        auto write_bigIndexes = hmemo::hostWriteAccess(bigIndexes);
+        for (IndexType i = 0; i < windowIndexes.size(); i++) {
+            write_bigIndexes[i] = read_windowIndexes[i] + cutIndex;
+        }
+    }
+
+    windowPlan = std::make_shared<dmemo::GlobalAddressingPlan>(dmemo::globalAddressingPlan(*distBig, bigIndexes));
+    windowDist = dist;
+    windowDistBig = distBig;
+    windowCutCoordinate = cutCoordinate;
+}
+
+/*! \brief Copy the per-shot window of a big model parameter
+ *
+ *  initWindowPlan has to be called before.
+ \param windowVector per-shot parameter which will be filled
+ \param bigVector parameter of the big model
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::getWindow(scai::lama::DenseVector<ValueType> &windowVector, scai::lama::DenseVector<ValueType> const &bigVector) const
+{
+    SCAI_ASSERT_ERROR(windowPlan && bigVector.getDistributionPtr() == windowDistBig, "window plan does not match the big model");
+
+    windowVector.setContextPtr(bigVector.getContextPtr());
+    windowVector.allocate(windowDist);
+    windowPlan->gather(windowVector.getLocalValues(), bigVector.getLocalValues());
+}
+
 /*! \brief Get shrink-vector that shrinks the old values in the big model
  \param dist Distribution of the pershot
  \param distBig Distribution of the big model
@@ -261,6 +340,132 @@ void KITGPI::Modelparameter::Modelparameter<ValueType>::initModelparameter(scai:
     IO::readVector(vector, filename, fileFormat);
 }
 
+/*! \brief Init several modelparameters by reading them from external files in one pass
+ *
+ *  All modelparameters share the same distribution, so the owned index ranges are computed once and each process reads only its own part of every file.
+ \param vectors Modelparameters which will be initialized
+ \param ctx Context
+ \param dist Distribution
+ \param filenames Location of the external files which will be read in (one per modelparameter)
+ \param fileFormat Input file format
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::initModelparameter(std::vector<scai::lama::DenseVector<ValueType> *> const &vectors, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::vector<std::string> const &filenames, IndexType fileFormat)
+{
+    for (auto vector : vectors) {
+        allocateModelparameter(*vector, ctx, dist);
+    }
+    for (auto const &filename : filenames) {
+        HOST_PRINT(dist->getCommunicatorPtr(), "", "initModelParameter from file " << filename << "\n")
+    }
+
+    if (regularModelSize == 0) {
+        IO::readVectors(vectors, filenames, fileFormat, parameterisation);
+        return;
+    }
+
+    // regular model onto variable grid: read only the regular grid samples of the local variable grid points
+    SCAI_ASSERT_ERROR(static_cast<IndexType>(regularModelIndexes.size()) == dist->getLocalSize(), "Regular model mapping does not match the distribution");
+    if (IO::readVectors(vectors, filenames, fileFormat, IO::getIndexRuns(regularModelIndexes), regularModelSize, parameterisation)) {
+        return;
+    }
+
+    // file layout cannot be read directly (e.g. mtx), read one regular parameter at a time and mesh it onto the variable grid
+    dmemo::DistributionPtr regularDist(new dmemo::BlockDistribution(regularModelSize, dist->getCommunicatorPtr()));
+
+    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
+    dist->getOwnedIndexes(ownedIndexes);
+
+    lama::MatrixAssembly<ValueType> assembly;
+    IndexType localIndex = 0;
+    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+        assembly.push(ownedIndex, regularModelIndexes[localIndex], 1.0);
+        localIndex++;
+    }
+
+    lama::CSRSparseMatrix<ValueType> meshingMatrix;
+    meshingMatrix = lama::zero<lama::CSRSparseMatrix<ValueType>>(dist, regularDist);
+    meshingMatrix.fillFromAssembly(assembly);
+
+    for (unsigned i = 0; i < vectors.size(); i++) {
+        lama::DenseVector<ValueType> regularVector;
+        allocateModelparameter(regularVector, ctx, regularDist);
+        IO::readVector(regularVector, filenames[i], fileFormat);
+        *vectors[i] = meshingMatrix * regularVector;
+    }
+}
+
+/*! \brief Init the modelparameters of an equation and the petrophysical parameters by reading them from external files in one pass
+ *
+ *  Porosity and saturation are read if they are required by the inversion type or the parameterisation, the reflectivity if it is required by the gradient kernel.
+ *  Otherwise they are initialized with zero.
+ \param parameters Modelparameters of the equation and the suffix which is added to filename
+ \param ctx Context
+ \param dist Distribution
+ \param filename Prefix of the external files
+ \param fileFormat Input file format
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::initModelparameters(std::vector<std::pair<scai::lama::DenseVector<ValueType> *, std::string>> const &parameters, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::string const &filename, IndexType fileFormat)
+{
+    std::vector<scai::lama::DenseVector<ValueType> *> vectors;
+    std::vector<std::string> filenames;
+    for (auto const &parameter : parameters) {
+        vectors.push_back(parameter.first);
+        filenames.push_back(filename + parameter.second);
+    }
+    if (getInversionType() == 3 || getParameterisation() == 1 || getParameterisation() == 2) {
+        vectors.push_back(&porosity);
+        filenames.push_back(filename + ".porosity");
+        vectors.push_back(&saturation);
+        filenames.push_back(filename + ".saturation");
+    } else {
+        initModelparameter(porosity, ctx, dist, 0.0);
+        initModelparameter(saturation, ctx, dist, 0.0);
+    }
+    if (getGradientKernel() != 0 && getDecomposition() == 0) {
+        vectors.push_back(&reflectivity);
+        filenames.push_back(filename + ".reflectivity");
+    } else {
+        initModelparameter(reflectivity, ctx, dist, 0.0);
+    }
+
+    initModelparameter(vectors, ctx, dist, filenames, fileFormat);
+}
+
+/*! \brief Set the mapping which is used to read a regular model onto a variable grid
+ *
+ *  While the mapping is set, every modelparameter read from file is initialized on the variable grid by reading only the regular grid samples of the local variable grid points.
+ *  No regular model is kept in memory.
+ \param variableDist Distribution of the variable grid
+ \param variableCoordinates Coordinate Class of the variable grid
+ \param regularCoordinates Coordinate Class of the regular grid of the model files
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::initRegularModelMapping(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates)
+{
+    hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
+    variableDist->getOwnedIndexes(ownedIndexes);
+
+    regularModelIndexes.clear();
+    regularModelIndexes.reserve(ownedIndexes.size());
+    for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
+        Acquisition::coordinate3D coordinate = variableCoordinates.index2coordinate(ownedIndex);
+        regularModelIndexes.push_back(regularCoordinates.coordinate2index(coordinate));
+    }
+    regularModelSize = regularCoordinates.getNGridpoints();
+}
+
+/*! \brief Remove the mapping of a regular model onto a variable grid
+ */
+template <typename ValueType>
+void KITGPI::Modelparameter::Modelparameter<ValueType>::clearRegularModelMapping()
+{
+    regularModelIndexes.clear();
+    regularModelIndexes.shrink_to_fit();
+    regularModelSize = 0;
+}
+
 /*! \brief Allocate a single modelparameter
  */
 template <typename ValueType>
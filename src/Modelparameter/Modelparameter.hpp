@@ -8,6 +8,7 @@
 #include <scai/lama/norm/L2Norm.hpp>
 
 #include <scai/dmemo/BlockDistribution.hpp>
+#include <scai/dmemo/GlobalAddressingPlan.hpp>
 
 #include <scai/hmemo/HArray.hpp>
 #include <scai/hmemo/ReadAccess.hpp>
@@ -23,6 +24,7 @@
 #include "../Common/HostPrint.hpp"
 #include "../Configuration/Configuration.hpp"
 #include <iostream>
+#include <utility>
 #include "../ForwardSolver/Derivatives/Derivatives.hpp"
 
 namespace KITGPI
@@ -109,6 +111,8 @@ namespace KITGPI
             typedef scai::lama::CSRSparseMatrix<ValueType> SparseFormat; //!< Declare Sparse-Matrix
             SparseFormat getShrinkMatrix(scai::dmemo::DistributionPtr dist, scai::dmemo::DistributionPtr distBig, Acquisition::Coordinates<ValueType> const &modelCoordinates, Acquisition::Coordinates<ValueType> const &modelCoordinatesBig, Acquisition::coordinate3D const cutCoordinate);            
             scai::lama::SparseVector<ValueType> getShrinkVector(scai::dmemo::DistributionPtr dist, scai::dmemo::DistributionPtr distBig, Acquisition::Coordinates<ValueType> const &modelCoordinates, Acquisition::Coordinates<ValueType> const &modelCoordinatesBig, Acquisition::coordinate3D const cutCoordinate, scai::IndexType boundaryWidthLeft, scai::IndexType boundaryWidthRight);
+            void initWindowPlan(scai::dmemo::DistributionPtr dist, scai::dmemo::DistributionPtr distBig, Acquisition::Coordinates<ValueType> const &modelCoordinates, Acquisition::Coordinates<ValueType> const &modelCoordinatesBig, Acquisition::coordinate3D const cutCoordinate);
+            void getWindow(scai::lama::DenseVector<ValueType> &windowVector, scai::lama::DenseVector<ValueType> const &bigVector) const;
             
             virtual void minusAssign(KITGPI::Modelparameter::Modelparameter<ValueType> const &rhs) = 0;
             virtual void plusAssign(KITGPI::Modelparameter::Modelparameter<ValueType> const &rhs) = 0;
@@ -265,6 +269,10 @@ namespace KITGPI
 
             void initModelparameter(scai::lama::Vector<ValueType> &vector, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, ValueType value);
             void initModelparameter(scai::lama::Vector<ValueType> &vector, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::string filename, scai::IndexType fileFormat);
+            void initModelparameter(std::vector<scai::lama::DenseVector<ValueType> *> const &vectors, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::vector<std::string> const &filenames, scai::IndexType fileFormat);
+            void initModelparameters(std::vector<std::pair<scai::lama::DenseVector<ValueType> *, std::string>> const &parameters, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::string const &filename, scai::IndexType fileFormat);
+            void initRegularModelMapping(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates);
+            void clearRegularModelMapping();
 
             /*! \brief Calculate Averaging if they are required */
             virtual void calculateAveraging() = 0;
@@ -392,6 +400,15 @@ namespace KITGPI
             scai::lama::DenseVector<ValueType> tauDielectricPermittivityAverageZ; //!< Vector storing averaged modulus in z-direction.
 
             std::vector<ValueType> relaxationTime;     // relaxation time of electric displacement
+
+            std::vector<scai::IndexType> regularModelIndexes; //!< regular grid index of every local variable grid point, only set while a regular model is read onto a variable grid
+            scai::IndexType regularModelSize = 0;             //!< number of grid points of the regular model, 0 if no mapping is set
+
+            std::shared_ptr<scai::dmemo::GlobalAddressingPlan> windowPlan; //!< communication plan which copies a per-shot window out of the big model
+            scai::dmemo::DistributionPtr windowDist;                        //!< distribution of the per-shot model of windowPlan
+            scai::dmemo::DistributionPtr windowDistBig;                     //!< distribution of the big model of windowPlan
+            Acquisition::coordinate3D windowCutCoordinate;                  //!< cut coordinate of windowPlan
+            scai::hmemo::HArray<IndexType> windowIndexes;                   //!< big model index of every local per-shot point for the cut coordinate (0,0,0)
             
           private:
             void allocateModelparameter(scai::lama::Vector<ValueType> &vector, scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist);
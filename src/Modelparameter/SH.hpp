@@ -104,7 +104,6 @@ namespace KITGPI
             KITGPI::Modelparameter::SH<ValueType> &operator=(KITGPI::Modelparameter::SH<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates){COMMON_THROWEXCEPTION("variable grid is not implemented in the sh case")};
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::equationType;
@@ -100,7 +100,6 @@ namespace KITGPI
             KITGPI::Modelparameter::ViscoSH<ValueType> &operator=(KITGPI::Modelparameter::ViscoSH<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates){COMMON_THROWEXCEPTION("variable grid is not implemented in the viscosh case")};
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::equationType;
@@ -104,42 +104,42 @@ void KITGPI::Modelparameter::Viscoelastic<ValueType>::getModelPerShot(KITGPI::Mo
 {
     auto distBig = density.getDistributionPtr();
 
-    scai::lama::CSRSparseMatrix<ValueType> shrinkMatrix = this->getShrinkMatrix(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
+    this->initWindowPlan(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
     
     lama::DenseVector<ValueType> temp;
     
-    temp = shrinkMatrix * velocityP;
+    this->getWindow(temp, velocityP);
     modelPerShot.setVelocityP(temp);
         
-    temp = shrinkMatrix * velocityS;
+    this->getWindow(temp, velocityS);
     modelPerShot.setVelocityS(temp);
     
-    temp = shrinkMatrix * density;
+    this->getWindow(temp, density);
     modelPerShot.setDensity(temp);
     
-    temp = shrinkMatrix * tauP;
+    this->getWindow(temp, tauP);
     modelPerShot.setTauP(temp);
         
-    temp = shrinkMatrix * tauS;
+    this->getWindow(temp, tauS);
     modelPerShot.setTauS(temp);
     
-    temp = shrinkMatrix * porosity;
+    this->getWindow(temp, porosity);
     modelPerShot.setPorosity(temp);
     
-    temp = shrinkMatrix * saturation;
+    this->getWindow(temp, saturation);
     modelPerShot.setSaturation(temp); 
     
-    temp = shrinkMatrix * reflectivity;
+    this->getWindow(temp, reflectivity);
     modelPerShot.setReflectivity(temp); 
     
     if (this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        temp = shrinkMatrix * bulkModulusRockMatrix;
+        this->getWindow(temp, bulkModulusRockMatrix);
         modelPerShot.setBulkModulusRockMatrix(temp);
         
-        temp = shrinkMatrix * shearModulusRockMatrix;
+        this->getWindow(temp, shearModulusRockMatrix);
         modelPerShot.setShearModulusRockMatrix(temp);
         
-        temp = shrinkMatrix * densityRockMatrix;
+        this->getWindow(temp, densityRockMatrix);
         modelPerShot.setDensityRockMatrix(temp);
     }
 }
@@ -270,23 +270,7 @@ KITGPI::Modelparameter::Viscoelastic<ValueType>::Viscoelastic(scai::hmemo::Conte
 template <typename ValueType>
 void KITGPI::Modelparameter::Viscoelastic<ValueType>::init(scai::hmemo::ContextPtr ctx, scai::dmemo::DistributionPtr dist, std::string filename, IndexType fileFormat)
 {
-    this->initModelparameter(velocityS, ctx, dist, filename + ".vs", fileFormat);
-    this->initModelparameter(velocityP, ctx, dist, filename + ".vp", fileFormat);
-    this->initModelparameter(density, ctx, dist, filename + ".density", fileFormat);
-    this->initModelparameter(tauS, ctx, dist, filename + ".tauS", fileFormat);
-    this->initModelparameter(tauP, ctx, dist, filename + ".tauP", fileFormat);
-    if (this->getInversionType() == 3 || this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        this->initModelparameter(porosity, ctx, dist, filename + ".porosity", fileFormat);
-        this->initModelparameter(saturation, ctx, dist, filename + ".saturation", fileFormat);
-    } else {
-        this->initModelparameter(porosity, ctx, dist, 0.0);
-        this->initModelparameter(saturation, ctx, dist, 0.0);
-    }
-    if (this->getGradientKernel() != 0 && this->getDecomposition() == 0) {
-        this->initModelparameter(reflectivity, ctx, dist, filename + ".reflectivity", fileFormat);
-    } else {
-        this->initModelparameter(reflectivity, ctx, dist, 0.0);
-    }
+    this->initModelparameters({{&velocityS, ".vs"}, {&velocityP, ".vp"}, {&density, ".density"}, {&tauS, ".tauS"}, {&tauP, ".tauP"}}, ctx, dist, filename, fileFormat);
 }
 
 //! \brief Copy constructor
@@ -88,7 +88,6 @@ namespace KITGPI
             KITGPI::Modelparameter::TMEM<ValueType> &operator=(KITGPI::Modelparameter::TMEM<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates);
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::MagneticPermeabilityVacuum;        // magnetic permeability of free space
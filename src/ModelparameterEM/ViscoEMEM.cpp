@@ -105,39 +105,39 @@ void KITGPI::Modelparameter::ViscoEMEM<ValueType>::getModelPerShot(KITGPI::Model
 {
     auto distBig = dielectricPermittivity.getDistributionPtr();
 
-    scai::lama::CSRSparseMatrix<ValueType> shrinkMatrix = this->getShrinkMatrix(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
+    this->initWindowPlan(dist, distBig, modelCoordinates, modelCoordinatesBig, cutCoordinate);
 
     lama::DenseVector<ValueType> temp;
     
-    temp = shrinkMatrix * magneticPermeability;
+    this->getWindow(temp, magneticPermeability);
     modelPerShot.setMagneticPermeability(temp);
     
-    temp = shrinkMatrix * dielectricPermittivity;
+    this->getWindow(temp, dielectricPermittivity);
     modelPerShot.setDielectricPermittivity(temp);
         
-    temp = shrinkMatrix * electricConductivity;
+    this->getWindow(temp, electricConductivity);
     modelPerShot.setElectricConductivity(temp);
     
-    temp = shrinkMatrix * tauDielectricPermittivity;
+    this->getWindow(temp, tauDielectricPermittivity);
     modelPerShot.setTauDielectricPermittivity(temp);
         
-    temp = shrinkMatrix * tauElectricConductivity;
+    this->getWindow(temp, tauElectricConductivity);
     modelPerShot.setTauElectricConductivity(temp);
     
-    temp = shrinkMatrix * porosity;
+    this->getWindow(temp, porosity);
     modelPerShot.setPorosity(temp);
     
-    temp = shrinkMatrix * saturation;
+    this->getWindow(temp, saturation);
     modelPerShot.setSaturation(temp);
     
-    temp = shrinkMatrix * reflectivity;
+    this->getWindow(temp, reflectivity);
     modelPerShot.setReflectivity(temp);
     
     if (this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        temp = shrinkMatrix * relativeDieletricPeimittivityRockMatrix;
+        this->getWindow(temp, relativeDieletricPeimittivityRockMatrix);
         modelPerShot.setRelativeDieletricPeimittivityRockMatrix(temp);
         
-        temp = shrinkMatrix * electricConductivityWater;
+        this->getWindow(temp, electricConductivityWater);
         modelPerShot.setElectricConductivityWater(temp);
     }
 }
@@ -276,24 +276,7 @@ void KITGPI::Modelparameter::ViscoEMEM<ValueType>::init(scai::hmemo::ContextPtr
 {
     scai::lama::DenseVector<ValueType> dielectricPermittivityRealEffective;
     scai::lama::DenseVector<ValueType> electricConductivityRealEffective;
-    
-    this->initModelparameter(magneticPermeability, ctx, dist, filename + ".mur", fileFormat);
-    this->initModelparameter(electricConductivityRealEffective, ctx, dist, filename + ".sigma", fileFormat);
-    this->initModelparameter(dielectricPermittivityRealEffective, ctx, dist, filename + ".epsilonr", fileFormat);
-    this->initModelparameter(tauElectricConductivity, ctx, dist, filename + ".tauSigmar", fileFormat);
-    this->initModelparameter(tauDielectricPermittivity, ctx, dist, filename + ".tauEpsilon", fileFormat);
-    if (this->getInversionType() == 3 || this->getParameterisation() == 1 || this->getParameterisation() == 2) {
-        this->initModelparameter(porosity, ctx, dist, filename + ".porosity", fileFormat);
-        this->initModelparameter(saturation, ctx, dist, filename + ".saturation", fileFormat);
-    } else {
-        this->initModelparameter(porosity, ctx, dist, 0.0);
-        this->initModelparameter(saturation, ctx, dist, 0.0);
-    }
-    if (this->getGradientKernel() != 0 && this->getDecomposition() == 0) {
-        this->initModelparameter(reflectivity, ctx, dist, filename + ".reflectivity", fileFormat);
-    } else {
-        this->initModelparameter(reflectivity, ctx, dist, 0.0);
-    }
+    this->initModelparameters({{&magneticPermeability, ".mur"}, {&electricConductivityRealEffective, ".sigma"}, {&dielectricPermittivityRealEffective, ".epsilonr"}, {&tauElectricConductivity, ".tauSigmar"}, {&tauDielectricPermittivity, ".tauEpsilon"}}, ctx, dist, filename, fileFormat);
             
     magneticPermeability *= MagneticPermeabilityVacuum;  // calculate the real magneticPermeability
     ValueType relaxationTime_ref = 1.0 / (2.0 * M_PI * centerFrequencyCPML);
@@ -88,7 +88,6 @@ namespace KITGPI
             KITGPI::Modelparameter::ViscoEMEM<ValueType> &operator=(KITGPI::Modelparameter::ViscoEMEM<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates){COMMON_THROWEXCEPTION("variable grid is not implemented in the viscoemem case")};
 
             void calculateAveraging() override;
 
@@ -86,7 +86,6 @@ namespace KITGPI
             KITGPI::Modelparameter::ViscoTMEM<ValueType> &operator=(KITGPI::Modelparameter::ViscoTMEM<ValueType> const &rhs);
 
           private:
-            void init(scai::dmemo::DistributionPtr variableDist, Acquisition::Coordinates<ValueType> const &variableCoordinates, Acquisition::Coordinates<ValueType> const &regularCoordinates);
             void calculateAveraging() override;
 
             using Modelparameter<ValueType>::MagneticPermeabilityVacuum;        // magnetic permeability of free space
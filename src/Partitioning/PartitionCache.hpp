@@ -0,0 +1,179 @@
+#pragma once
+
+#include "../Acquisition/Coordinates.hpp"
+#include "../Common/Checksum.hpp"
+#include "../Common/Common.hpp"
+#include "../Common/HostPrint.hpp"
+#include "../Configuration/Configuration.hpp"
+#include "../IO/IO.hpp"
+
+#include <scai/dmemo.hpp>
+#include <scai/lama.hpp>
+#include <scai/lama/DenseVector.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace scai;
+
+namespace KITGPI
+{
+    namespace Partitioning
+    {
+        /*! \brief Hash of the content of a file for the partition key
+         *
+         * The hash does not depend on the build, so the cache can be shared between builds and machines.
+         \param filename name of the file
+         \return hash of the content or "none" if the file cannot be read
+         */
+        inline std::string getFileHash(std::string const &filename)
+        {
+            unsigned long long checksum = 0;
+            unsigned long long size = 0;
+            if (!Common::Checksum::ofFile(filename, checksum, size)) {
+                return ("none");
+            }
+            return (std::to_string(checksum));
+        }
+
+        /*! \brief Key of a partition in the partition cache
+         *
+         * The key contains everything the partitioners depend on: the grid, the layout of the variable grid, the FD orders, the boundaries, the equation, the partitioning method, the inputs of the node weights (relaxation mechanisms, weight model and acquisition) and the number of processes of a shot domain.
+         * The weight model and acquisition files are included with a hash of their content, so a modified file invalidates the cached partition.
+         \param config configuration object
+         \param commShot communicator of a shot domain
+         \param modelCoordinates coordinate object
+         */
+        template <typename ValueType>
+        std::string getPartitionKey(Configuration::Configuration const &config, scai::dmemo::CommunicatorPtr commShot, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            std::ostringstream key;
+            key << "dimension=" << config.get<std::string>("dimension") << "\n";
+            key << "equationType=" << config.get<std::string>("equationType") << "\n";
+            key << "grid=" << modelCoordinates.getNX() << "," << modelCoordinates.getNY() << "," << modelCoordinates.getNZ() << "," << modelCoordinates.getNGridpoints() << "\n";
+
+            key << "interfaces=";
+            for (auto interface : modelCoordinates.getInterfaceVec()) {
+                key << interface << ",";
+            }
+            key << "\ndhFactors=";
+            for (IndexType layer = 0; layer < modelCoordinates.getNumLayers(); layer++) {
+                key << modelCoordinates.getDHFactor(layer) << ",";
+            }
+
+            key << "\nspatialFDorder=";
+            if (config.get<bool>("useVariableFDoperators")) {
+                std::vector<IndexType> spatialFDorderVec;
+                Common::readColumnFromFile(config.get<std::string>("gridConfigurationFilename"), spatialFDorderVec, 2);
+                for (auto spatialFDorder : spatialFDorderVec) {
+                    key << spatialFDorder << ",";
+                }
+            } else {
+                key << config.get<IndexType>("spatialFDorder");
+            }
+
+            key << "\nboundary=" << config.get<IndexType>("DampingBoundary") << "," << config.get<IndexType>("BoundaryWidth") << "," << config.get<IndexType>("FreeSurface") << "\n";
+            key << "partitioning=" << config.get<IndexType>("partitioning") << "," << config.getAndCatch("graphPartitionTool", std::string("geoKMeans")) << "\n";
+            key << "numRelaxationMechanisms=" << config.getAndCatch("numRelaxationMechanisms", IndexType(0)) << "\n";
+            key << "nodeWeights=" << config.getAndCatch("useNodeWeights", true) << "\n";
+
+            std::string weightModelFilename = config.getAndCatch("weightModelFilename", std::string(""));
+            key << "weightModel=" << config.getAndCatch("calibratePartitionWeights", false) << "," << weightModelFilename << "," << getFileHash(weightModelFilename) << "\n";
+
+            // the acquisition contributes to the node weights (see acquisitionWeights())
+            if (config.getAndCatch("useStreamConfig", false)) {
+                key << "acquisition=stream\n";
+            } else {
+                std::string sourceFilename = config.get<std::string>("SourceFilename") + ".txt";
+                std::string receiverFilename = config.get<std::string>("ReceiverFilename") + ".txt";
+                key << "sources=" << config.get<bool>("initSourcesFromSU") << "," << sourceFilename << "," << getFileHash(sourceFilename) << "\n";
+                key << "receivers=" << config.get<bool>("initReceiverFromSU") << "," << config.get<IndexType>("useReceiversPerShot") << "," << receiverFilename << "," << getFileHash(receiverFilename) << "\n";
+            }
+            key << "numProcesses=" << commShot->getSize() << "\n";
+            return (key.str());
+        }
+
+        /*! \brief Return the filename of a partition in the partition cache
+         *
+         * The filename contains a hash of the key, the full key is stored in the file <filename>.key.
+         \param config configuration object
+         \param key key of the partition
+         */
+        inline std::string getPartitionCacheFilename(Configuration::Configuration const &config, std::string const &key)
+        {
+            std::string prefix = config.getAndCatch("partitionCacheFilename", config.getAndCatch("partitionFilename", std::string("partition/partition")) + ".cache");
+            return (prefix + "." + std::to_string(Common::Checksum::of(key)));
+        }
+
+        /*! \brief Read a partition from the partition cache
+         *
+         * Has to be called by all processes of the shot domain.
+         \param config configuration object
+         \param commShot communicator of a shot domain
+         \param BlockDist initial (block) distribution of the model
+         \param modelCoordinates coordinate object
+         \return distribution of the cached partition or nullptr if no partition with the same key is cached
+         */
+        template <typename ValueType>
+        dmemo::DistributionPtr readPartitionCache(Configuration::Configuration const &config, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            SCAI_REGION("KITGPI.readPartitionCache")
+
+            std::string key = getPartitionKey(config, commShot, modelCoordinates);
+            std::string filename = getPartitionCacheFilename(config, key);
+
+            // the key file protects against hash collisions and incomplete cache entries
+            int found = 0;
+            if (commShot->getRank() == MASTERGPI) {
+                std::ifstream keyFile(filename + ".key");
+                if (keyFile.good()) {
+                    std::stringstream cachedKey;
+                    cachedKey << keyFile.rdbuf();
+                    found = (cachedKey.str() == key);
+                }
+            }
+            commShot->bcast(&found, 1, MASTERGPI);
+            if (!found) {
+                HOST_PRINT(commShot, "", "No cached partition found in " << filename << "\n");
+                return (nullptr);
+            }
+
+            HOST_PRINT(commShot, "Reading cached partition from " << filename << "\n");
+            lama::DenseVector<IndexType> newOwners(BlockDist, 0);
+            IO::readVector(newOwners, filename, 3);
+            SCAI_ASSERT_ERROR(newOwners.min() >= 0 && newOwners.max() < commShot->getSize(), "Invalid owners in cached partition " << filename);
+
+            return (scai::dmemo::generalDistributionByNewOwners(newOwners.getDistribution(), newOwners.getLocalValues()));
+        }
+
+        /*! \brief Write a partition to the partition cache
+         *
+         * Has to be called by all processes of the shot domain. The key file is written after the partition, so an interrupted write is never read back.
+         \param config configuration object
+         \param commShot communicator of a shot domain
+         \param dist distribution of the partition
+         \param modelCoordinates coordinate object
+         */
+        template <typename ValueType>
+        void writePartitionCache(Configuration::Configuration const &config, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            SCAI_REGION("KITGPI.writePartitionCache")
+
+            std::string key = getPartitionKey(config, commShot, modelCoordinates);
+            std::string filename = getPartitionCacheFilename(config, key);
+
+            HOST_PRINT(commShot, "Writing partition to cache " << filename << "\n");
+            lama::DenseVector<IndexType> newOwners(dist, commShot->getRank());
+            IO::writeVector(newOwners, filename, 3);
+
+            commShot->synchronize();
+            if (commShot->getRank() == MASTERGPI) {
+                std::ofstream keyFile(filename + ".key");
+                SCAI_ASSERT_ERROR(keyFile.good(), "Could not open " << filename << ".key");
+                keyFile << key;
+            }
+        }
+    }
+}
@@ -1,16 +1,23 @@
 #pragma once
 
+#include "../Acquisition/AcquisitionSettings.hpp"
 #include "../ForwardSolver/Derivatives/Derivatives.hpp"
 #include "../IO/IO.hpp"
+#include "PartitionCache.hpp"
+#include "WeightModel.hpp"
 
 #include <scai/hmemo/HArray.hpp>
 #include <scai/hmemo/WriteAccess.hpp>
 #include <scai/lama.hpp>
 #include <scai/lama/DenseVector.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
+#include <scai/dmemo/GeneralDistribution.hpp>
 #include <scai/dmemo/RedistributePlan.hpp>
 
 #ifdef USE_GEOGRAPHER
@@ -250,25 +257,63 @@ namespace KITGPI
         }
 #endif
 
-        /*! \brief calculation of the node weights (variable fd order + pml)
-        \param config configuration object
-        \param dist distributionPtr of the model
-        \param modelCoordinates coordinate object
-        */
+        /*! \brief Weights of the source and receiver points
+         *
+         * A source point is only active in its own shot, so its weight is averaged over all shots. Receivers are active in every shot.
+         * Only acquisitions which are defined by the txt files of the configuration are taken into account.
+         \param config configuration object
+         \param modelCoordinates coordinate object
+         \param weightModel cost model of the node weights
+         */
         template <typename ValueType>
-        scai::lama::DenseVector<ValueType> Weights(Configuration::Configuration const &config, dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        std::unordered_map<IndexType, ValueType> acquisitionWeights(Configuration::Configuration const &config, Acquisition::Coordinates<ValueType> const &modelCoordinates, WeightModel<ValueType> const &weightModel)
         {
-            SCAI_REGION("KITGPI.Weights")
-            // Weights of single operations; valid for all cases
-            ValueType MatrixVector2ndOrderWeight = 1.00;
-            ValueType VectorAssignmentWeight = 0.25;
-            ValueType VectorPlusVectorWeight = 0.43;
-            ValueType PMLWeight = 1.5;
+            std::unordered_map<IndexType, ValueType> weights;
+            if (config.getAndCatch("useStreamConfig", false)) {
+                return (weights);
+            }
+
+            if (weightModel.SourceWeight > 0 && !config.get<bool>("initSourcesFromSU")) {
+                std::vector<Acquisition::sourceSettings<ValueType>> sourceSettings;
+                Acquisition::readAllSettings<ValueType>(sourceSettings, config.get<std::string>("SourceFilename") + ".txt");
+                std::vector<IndexType> shotNumbers;
+                for (auto const &source : sourceSettings) {
+                    shotNumbers.push_back(source.sourceNo);
+                }
+                std::sort(shotNumbers.begin(), shotNumbers.end());
+                IndexType numShots = std::unique(shotNumbers.begin(), shotNumbers.end()) - shotNumbers.begin();
+                for (auto const &source : sourceSettings) {
+                    weights[modelCoordinates.coordinate2index(source.sourceCoords)] += weightModel.SourceWeight / numShots;
+                }
+            }
+
+            if (weightModel.ReceiverWeight > 0 && !config.get<bool>("initReceiverFromSU") && config.get<IndexType>("useReceiversPerShot") != 1) {
+                std::vector<Acquisition::receiverSettings> receiverSettings;
+                Acquisition::readAllSettings(receiverSettings, config.get<std::string>("ReceiverFilename") + ".txt");
+                for (auto const &receiver : receiverSettings) {
+                    weights[modelCoordinates.coordinate2index(receiver.receiverCoords)] += weightModel.ReceiverWeight;
+                }
+            }
+            return (weights);
+        }
 
-            IndexType NumMatrixVector = 0;
-            IndexType NumVectorAssignement = 0;
-            IndexType NumVectorPlusVector = 0;
-            IndexType NumPMLPerDim = 0;
+        //! \brief Number of operations per gridpoint and time step of the forward solver
+        struct OperationCounts {
+            IndexType NumMatrixVector = 0;      //!< matrix vector products
+            IndexType NumVectorAssignement = 0; //!< elementwise vector operations
+            IndexType NumVectorPlusVector = 0;  //!< vector additions
+            IndexType NumPMLPerDim = 0;         //!< CPML updates per dimension
+            IndexType NumFreeSurface = 0;       //!< wavefields which are updated on the free surface
+            IndexType NumInterpolation = 0;     //!< wavefields which are interpolated on variable grid interfaces
+            IndexType NumMemoryVariables = 0;   //!< memory variables per relaxation mechanism
+        };
+
+        /*! \brief Number of operations per gridpoint and time step of the configured equation
+        \param config configuration object
+        */
+        inline OperationCounts getOperationCounts(Configuration::Configuration const &config)
+        {
+            OperationCounts counts;
 
             std::string dimension = config.get<std::string>("dimension");
             std::string type = config.get<std::string>("equationType");
@@ -284,99 +329,169 @@ namespace KITGPI
             //Number of operations during the time stepping
             // 2D
             if (dimension.compare("2d") == 0 && type.compare("acoustic") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 7;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 7;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("2d") == 0 && type.compare("elastic") == 0) {
-                NumMatrixVector = 8;
-                NumVectorAssignement = 20;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 4;
+                counts.NumMatrixVector = 8;
+                counts.NumVectorAssignement = 20;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 4;
+                counts.NumFreeSurface = 3;
+                counts.NumInterpolation = 5;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("2d") == 0 && type.compare("viscoelastic") == 0) {
-                NumMatrixVector = 8;
-                NumVectorAssignement = 41;
-                NumVectorPlusVector = 8;
-                NumPMLPerDim = 4;
+                counts.NumMatrixVector = 8;
+                counts.NumVectorAssignement = 41;
+                counts.NumVectorPlusVector = 8;
+                counts.NumPMLPerDim = 4;
+                counts.NumFreeSurface = 3;
+                counts.NumInterpolation = 5;
+                counts.NumMemoryVariables = 3;
             }
             if (dimension.compare("2d") == 0 && type.compare("sh") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 7;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 7;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("2d") == 0 && type.compare("viscosh") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 7;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 7;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 2;
             }
 
             // 3D
             if (dimension.compare("3d") == 0 && type.compare("acoustic") == 0) {
-                NumMatrixVector = 6;
-                NumVectorAssignement = 10;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 6;
+                counts.NumVectorAssignement = 10;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 4;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("3d") == 0 && type.compare("elastic") == 0) {
-                NumMatrixVector = 18;
-                NumVectorAssignement = 34;
-                NumVectorPlusVector = 3;
-                NumPMLPerDim = 6;
+                counts.NumMatrixVector = 18;
+                counts.NumVectorAssignement = 34;
+                counts.NumVectorPlusVector = 3;
+                counts.NumPMLPerDim = 6;
+                counts.NumFreeSurface = 5;
+                counts.NumInterpolation = 9;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("3d") == 0 && type.compare("viscoelastic") == 0) {
-                NumMatrixVector = 18;
-                NumVectorAssignement = 72;
-                NumVectorPlusVector = 22;
-                NumPMLPerDim = 6;
+                counts.NumMatrixVector = 18;
+                counts.NumVectorAssignement = 72;
+                counts.NumVectorPlusVector = 22;
+                counts.NumPMLPerDim = 6;
+                counts.NumFreeSurface = 5;
+                counts.NumInterpolation = 9;
+                counts.NumMemoryVariables = 6;
             }
 
             // 2D
             if (dimension.compare("2d") == 0 && type.compare("tmem") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 7;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 7;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("2d") == 0 && type.compare("emem") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 7;
-                NumVectorPlusVector = 0;
-                NumPMLPerDim = 2;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 7;
+                counts.NumVectorPlusVector = 0;
+                counts.NumPMLPerDim = 2;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("2d") == 0 && type.compare("viscotmem") == 0) {
-                NumMatrixVector = 4;
-                NumVectorAssignement = 41;
-                NumVectorPlusVector = 8;
-                NumPMLPerDim = 4;
+                counts.NumMatrixVector = 4;
+                counts.NumVectorAssignement = 41;
+                counts.NumVectorPlusVector = 8;
+                counts.NumPMLPerDim = 4;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 2;
             }
             if (dimension.compare("2d") == 0 && type.compare("viscoemem") == 0) {
-                NumMatrixVector = 8;
-                NumVectorAssignement = 41;
-                NumVectorPlusVector = 8;
-                NumPMLPerDim = 4;
+                counts.NumMatrixVector = 8;
+                counts.NumVectorAssignement = 41;
+                counts.NumVectorPlusVector = 8;
+                counts.NumPMLPerDim = 4;
+                counts.NumFreeSurface = 1;
+                counts.NumInterpolation = 3;
+                counts.NumMemoryVariables = 2;
             }
 
             // 3D
             if (dimension.compare("3d") == 0 && type.compare("emem") == 0) {
-                NumMatrixVector = 18;
-                NumVectorAssignement = 34;
-                NumVectorPlusVector = 3;
-                NumPMLPerDim = 6;
+                counts.NumMatrixVector = 18;
+                counts.NumVectorAssignement = 34;
+                counts.NumVectorPlusVector = 3;
+                counts.NumPMLPerDim = 6;
+                counts.NumFreeSurface = 2;
+                counts.NumInterpolation = 6;
+                counts.NumMemoryVariables = 0;
             }
             if (dimension.compare("3d") == 0 && type.compare("viscoemem") == 0) {
-                NumMatrixVector = 18;
-                NumVectorAssignement = 72;
-                NumVectorPlusVector = 22;
-                NumPMLPerDim = 6;
+                counts.NumMatrixVector = 18;
+                counts.NumVectorAssignement = 72;
+                counts.NumVectorPlusVector = 22;
+                counts.NumPMLPerDim = 6;
+                counts.NumFreeSurface = 2;
+                counts.NumInterpolation = 6;
+                counts.NumMemoryVariables = 3;
             }
 
+            return (counts);
+        }
+
+        /*! \brief calculation of the node weights (variable fd order + pml + free surface + variable grid interfaces + relaxation mechanisms + acquisition)
+        \param config configuration object
+        \param dist distributionPtr of the model
+        \param modelCoordinates coordinate object
+        \param weightModel cost model of the node weights (see getWeightModel())
+        */
+        template <typename ValueType>
+        scai::lama::DenseVector<ValueType> Weights(Configuration::Configuration const &config, dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates, WeightModel<ValueType> const &weightModel = WeightModel<ValueType>())
+        {
+            SCAI_REGION("KITGPI.Weights")
+            // Weights of single operations
+            ValueType MatrixVector2ndOrderWeight = weightModel.MatrixVectorWeight[0];
+            ValueType VectorAssignmentWeight = weightModel.VectorAssignmentWeight;
+            ValueType VectorPlusVectorWeight = weightModel.VectorPlusVectorWeight;
+            ValueType PMLWeight = weightModel.PMLWeight;
+
+            OperationCounts counts = getOperationCounts(config);
+
+            std::string dimension = config.get<std::string>("dimension");
+            std::transform(dimension.begin(), dimension.end(), dimension.begin(), ::tolower);
+
             //runtime of Vector Operations are not influenced by the FDorder;
-            ValueType constantWeight = NumVectorAssignement * VectorAssignmentWeight + NumVectorPlusVector * VectorPlusVectorWeight;
-            ValueType referenceTotalWeight = NumMatrixVector * MatrixVector2ndOrderWeight + constantWeight;
+            ValueType constantWeight = counts.NumVectorAssignement * VectorAssignmentWeight + counts.NumVectorPlusVector * VectorPlusVectorWeight;
+            // the operation counts include one relaxation mechanism
+            if (counts.NumMemoryVariables > 0) {
+                constantWeight += (config.get<IndexType>("numRelaxationMechanisms") - 1) * counts.NumMemoryVariables * weightModel.RelaxationWeight;
+            }
+            ValueType referenceTotalWeight = counts.NumMatrixVector * MatrixVector2ndOrderWeight + constantWeight;
 
             hmemo::HArray<IndexType> ownedIndexes; // all (global) points owned by this process
             dist->getOwnedIndexes(ownedIndexes);
@@ -402,7 +517,11 @@ namespace KITGPI
                 }
 
                 // Weights of single Matrix vector Products with FDorder 2-12
-                ValueType FDWeights[6] = {MatrixVector2ndOrderWeight, 1.56, 2.06, 2.54, 3.00, 3.70};
+                ValueType const *FDWeights = weightModel.MatrixVectorWeight;
+
+                bool useVariableGrid = config.getAndCatch("useVariableGrid", false);
+                IndexType useFreeSurface = config.get<IndexType>("FreeSurface");
+                auto acquisitionWeight = acquisitionWeights(config, modelCoordinates, weightModel);
 
                 //loop over all (local) indeces
                 for (IndexType ownedIndex : hmemo::hostReadAccess(ownedIndexes)) {
@@ -418,7 +537,18 @@ namespace KITGPI
 
                     //FDOrder Weights
 
-                    ValueType fdWeight = (NumMatrixVector * FDWeights[FDOrder / 2 - 1] + constantWeight);
+                    ValueType fdWeight = (counts.NumMatrixVector * FDWeights[FDOrder / 2 - 1] + constantWeight);
+
+                    if (useFreeSurface != 0 && coordinate.y == 0) {
+                        fdWeight += counts.NumFreeSurface * weightModel.FreeSurfaceWeight;
+                    }
+                    if (useVariableGrid && modelCoordinates.locatedOnInterface(coordinate)) {
+                        fdWeight += counts.NumInterpolation * weightModel.InterpolationWeight;
+                    }
+                    auto acquisition = acquisitionWeight.find(ownedIndex);
+                    if (acquisition != acquisitionWeight.end()) {
+                        fdWeight += acquisition->second;
+                    }
 
                     assembly.push(ownedIndex, fdWeight);
                 }
@@ -447,22 +577,22 @@ namespace KITGPI
                     IndexType zDist = coordinatedist.z / modelCoordinates.getDHFactor(layer);
 
                     if (xDist < width) {
-                        pmlWeight += NumPMLPerDim * PMLWeight;
+                        pmlWeight += counts.NumPMLPerDim * PMLWeight;
                     }
 
                     if (yDist < width) {
                         IndexType yCoord = coordinate.y / modelCoordinates.getDHFactor(layer);
                         if (yCoord < width) {
                             if (config.get<IndexType>("FreeSurface") == 0) {
-                                pmlWeight += NumPMLPerDim * PMLWeight;
+                                pmlWeight += counts.NumPMLPerDim * PMLWeight;
                             }
                         } else {
-                            pmlWeight += NumPMLPerDim * PMLWeight;
+                            pmlWeight += counts.NumPMLPerDim * PMLWeight;
                         }
                     }
                     if (dimension.compare("3d") == 0) {
                         if (zDist < width) {
-                            pmlWeight += NumPMLPerDim * PMLWeight;
+                            pmlWeight += counts.NumPMLPerDim * PMLWeight;
                         }
                     }
 
@@ -482,8 +612,260 @@ namespace KITGPI
             return (weights);
         }
 
+        /*! \brief New owners of the gridpoints for a weighted recursive coordinate bisection into numParts parts (see rcbPartition())
+         *
+         \param comm communicator of the processes which own the gridpoints
+         \param numParts number of parts
+         \param weights node weights, distributed over comm
+         \param modelCoordinates coordinate object
+         \return part of every local gridpoint of weights
+         */
         template <typename ValueType>
-        dmemo::DistributionPtr graphPartition(Configuration::Configuration const &config, scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType> &derivatives, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        hmemo::HArray<IndexType> rcbOwners(scai::dmemo::CommunicatorPtr comm, IndexType numParts, lama::DenseVector<ValueType> const &weights, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            SCAI_REGION("KITGPI.rcbOwners")
+
+            hmemo::HArray<IndexType> ownedIndexes;
+            weights.getDistribution().getOwnedIndexes(ownedIndexes);
+            IndexType numLocal = ownedIndexes.size();
+            double numGlobal = weights.size();
+
+            // coordinates and weights of the local gridpoints
+            std::vector<IndexType> pointCoordinates(3 * numLocal);
+            std::vector<double> pointWeights(numLocal);
+            std::vector<double> pointFraction(numLocal); // global index scaled to [0,1) to order points with equal coordinates
+            {
+                auto read_ownedIndexes = hmemo::hostReadAccess(ownedIndexes);
+                auto read_weights = hmemo::hostReadAccess(weights.getLocalValues());
+                for (IndexType i = 0; i < numLocal; i++) {
+                    Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(read_ownedIndexes[i]);
+                    pointCoordinates[3 * i] = coordinate.x;
+                    pointCoordinates[3 * i + 1] = coordinate.y;
+                    pointCoordinates[3 * i + 2] = coordinate.z;
+                    pointWeights[i] = read_weights[i];
+                    pointFraction[i] = read_ownedIndexes[i] / numGlobal;
+                }
+            }
+            IndexType maxExtent = std::max(std::max(modelCoordinates.getNX(), modelCoordinates.getNY()), modelCoordinates.getNZ());
+            IndexType numBisectionSteps = std::ceil(std::log2((maxExtent + 1.0) * numGlobal)) + 1;
+
+            // every gridpoint belongs to the processes [first, last) of its part, all processes know the same parts
+            std::vector<IndexType> pointPart(numLocal, 0);
+            std::vector<IndexType> partFirst = {0};
+            std::vector<IndexType> partLast = {numParts};
+
+            while (partFirst.size() < std::size_t(numParts)) {
+                IndexType numCurrent = partFirst.size();
+
+                // spread of the coordinates of every part: sum of w, w*c and w*c^2 per dimension
+                hmemo::HArray<double> moments(7 * numCurrent, 0.0);
+                {
+                    auto write_moments = hmemo::hostWriteAccess(moments);
+                    for (IndexType i = 0; i < numLocal; i++) {
+                        double *partMoments = &write_moments[7 * pointPart[i]];
+                        partMoments[0] += pointWeights[i];
+                        for (IndexType dim = 0; dim < 3; dim++) {
+                            double c = pointCoordinates[3 * i + dim];
+                            partMoments[1 + 2 * dim] += pointWeights[i] * c;
+                            partMoments[2 + 2 * dim] += pointWeights[i] * c * c;
+                        }
+                    }
+                }
+                comm->sumArray(moments);
+
+                std::vector<IndexType> cutDimension(numCurrent, 0);
+                std::vector<double> targetWeight(numCurrent, 0.0);
+                std::vector<double> cutLower(numCurrent, 0.0);
+                std::vector<double> cutUpper(numCurrent, maxExtent + 1.0);
+                {
+                    auto read_moments = hmemo::hostReadAccess(moments);
+                    for (IndexType part = 0; part < numCurrent; part++) {
+                        double sumWeights = read_moments[7 * part];
+                        double maxVariance = -1.0;
+                        for (IndexType dim = 0; dim < 3; dim++) {
+                            double variance = 0.0;
+                            if (sumWeights > 0) {
+                                double mean = read_moments[7 * part + 1 + 2 * dim] / sumWeights;
+                                variance = read_moments[7 * part + 2 + 2 * dim] / sumWeights - mean * mean;
+                            }
+                            if (variance > maxVariance) {
+                                maxVariance = variance;
+                                cutDimension[part] = dim;
+                            }
+                        }
+                        IndexType numPartsLeft = (partLast[part] - partFirst[part]) / 2;
+                        targetWeight[part] = sumWeights * numPartsLeft / (partLast[part] - partFirst[part]);
+                    }
+                }
+
+                // bisection of the cut key (coordinate + scaled global index) of all parts
+                for (IndexType step = 0; step < numBisectionSteps; step++) {
+                    hmemo::HArray<double> leftWeights(numCurrent, 0.0);
+                    {
+                        auto write_leftWeights = hmemo::hostWriteAccess(leftWeights);
+                        for (IndexType i = 0; i < numLocal; i++) {
+                            IndexType part = pointPart[i];
+                            double key = pointCoordinates[3 * i + cutDimension[part]] + pointFraction[i];
+                            if (key < 0.5 * (cutLower[part] + cutUpper[part])) {
+                                write_leftWeights[part] += pointWeights[i];
+                            }
+                        }
+                    }
+                    comm->sumArray(leftWeights);
+                    auto read_leftWeights = hmemo::hostReadAccess(leftWeights);
+                    for (IndexType part = 0; part < numCurrent; part++) {
+                        double cut = 0.5 * (cutLower[part] + cutUpper[part]);
+                        if (read_leftWeights[part] < targetWeight[part]) {
+                            cutLower[part] = cut;
+                        } else {
+                            cutUpper[part] = cut;
+                        }
+                    }
+                }
+
+                // split every part with more than one process into two parts
+                std::vector<IndexType> newPartOfLeft(numCurrent);
+                std::vector<IndexType> newPartOfRight(numCurrent);
+                std::vector<IndexType> newFirst;
+                std::vector<IndexType> newLast;
+                for (IndexType part = 0; part < numCurrent; part++) {
+                    IndexType numPartsLeft = (partLast[part] - partFirst[part]) / 2;
+                    newPartOfLeft[part] = newFirst.size();
+                    if (numPartsLeft > 0) {
+                        newFirst.push_back(partFirst[part]);
+                        newLast.push_back(partFirst[part] + numPartsLeft);
+                    }
+                    newPartOfRight[part] = newFirst.size();
+                    newFirst.push_back(partFirst[part] + numPartsLeft);
+                    newLast.push_back(partLast[part]);
+                }
+                for (IndexType i = 0; i < numLocal; i++) {
+                    IndexType part = pointPart[i];
+                    double key = pointCoordinates[3 * i + cutDimension[part]] + pointFraction[i];
+                    bool left = (partLast[part] - partFirst[part]) / 2 > 0 && key < cutUpper[part];
+                    pointPart[i] = left ? newPartOfLeft[part] : newPartOfRight[part];
+                }
+                partFirst = newFirst;
+                partLast = newLast;
+            }
+
+            hmemo::HArray<IndexType> newLocalOwners(numLocal);
+            {
+                auto write_newLocalOwners = hmemo::hostWriteAccess(newLocalOwners);
+                for (IndexType i = 0; i < numLocal; i++) {
+                    write_newLocalOwners[i] = partFirst[pointPart[i]];
+                }
+            }
+
+            return (newLocalOwners);
+        }
+
+        /*! \brief Weighted recursive coordinate bisection (RCB) of the model
+         *
+         * Self-contained parallel partitioner which only requires the coordinates of the gridpoints and the node weights of Weights().
+         * The processes of the shot domain are split recursively into two halves and the gridpoints of every part are cut at the weighted median of the coordinate with the largest spread.
+         * All parts of one level are cut at the same time, the cuts are found by bisection with one reduction over all parts per step.
+         * Gridpoints with equal coordinates are ordered by their global index, so the cuts balance the weights up to a single gridpoint.
+         * Every part is a box of the grid, so the local gridpoints keep the x-fastest order within small ranges of the global index.
+         \param config configuration object
+         \param commShot communicator of a shot domain
+         \param BlockDist initial (block) distribution of the model
+         \param modelCoordinates coordinate object
+         \param weightModel cost model of the node weights
+         */
+        template <typename ValueType>
+        dmemo::DistributionPtr rcbPartition(Configuration::Configuration const &config, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, Acquisition::Coordinates<ValueType> const &modelCoordinates, WeightModel<ValueType> const &weightModel = WeightModel<ValueType>())
+        {
+            SCAI_REGION("KITGPI.rcbPartition")
+
+            IndexType numParts = commShot->getSize();
+            if (numParts == 1) {
+                return (BlockDist);
+            }
+
+            HOST_PRINT(commShot, "", "calculate weights for RCB \n");
+            auto &&weights = Weights(config, BlockDist, modelCoordinates, weightModel);
+
+            auto newLocalOwners = rcbOwners(commShot, numParts, weights, modelCoordinates);
+            return (scai::dmemo::generalDistributionByNewOwners(*BlockDist, newLocalOwners));
+        }
+
+        /*! \brief Morton (Z-order) key of a coordinate
+         *
+         * Interleaves the bits of the x, y and z coordinate (21 bits each), so gridpoints which are close in space get close keys.
+         \param coordinate coordinate of the gridpoint
+         */
+        inline uint64_t mortonKey(Acquisition::coordinate3D coordinate)
+        {
+            uint64_t key = 0;
+            for (IndexType bit = 0; bit < 21; bit++) {
+                key |= (uint64_t((coordinate.x >> bit) & 1) << (3 * bit));
+                key |= (uint64_t((coordinate.y >> bit) & 1) << (3 * bit + 1));
+                key |= (uint64_t((coordinate.z >> bit) & 1) << (3 * bit + 2));
+            }
+            return (key);
+        }
+
+        /*! \brief Renumber the local gridpoints of a distribution along a Morton curve
+         *
+         * The ownership of the gridpoints does not change, only the order of the local gridpoints. With a graph partition the local gridpoints are scattered over many rows of the x-fastest global index.
+         * Ordering them along a space filling curve keeps the gridpoints of a stencil close in memory for all wavefields, models, derivative matrices and halos, which are all built on the returned distribution.
+         \param dist distribution of the model
+         \param modelCoordinates coordinate object
+         */
+        template <typename ValueType>
+        dmemo::DistributionPtr mortonRenumbering(dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        {
+            SCAI_REGION("KITGPI.mortonRenumbering")
+
+            hmemo::HArray<IndexType> ownedIndexes;
+            dist->getOwnedIndexes(ownedIndexes);
+            IndexType numLocal = ownedIndexes.size();
+
+            std::vector<std::pair<uint64_t, IndexType>> keys(numLocal);
+            {
+                auto read_ownedIndexes = hmemo::hostReadAccess(ownedIndexes);
+                for (IndexType i = 0; i < numLocal; i++) {
+                    keys[i] = std::make_pair(mortonKey(modelCoordinates.index2coordinate(read_ownedIndexes[i])), read_ownedIndexes[i]);
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+
+            hmemo::HArray<IndexType> localIndices(numLocal);
+            {
+                auto write_localIndices = hmemo::hostWriteAccess(localIndices);
+                for (IndexType i = 0; i < numLocal; i++) {
+                    write_localIndices[i] = keys[i].second;
+                }
+            }
+
+            // same owners as dist, so the distribution does not have to be checked
+            return (dmemo::DistributionPtr(new dmemo::GeneralDistribution(dist->getGlobalSize(), localIndices, false, dist->getCommunicatorPtr())));
+        }
+
+        /*! \brief Check if the local gridpoints are renumbered along a Morton curve (see mortonRenumbering())
+         *
+         * Only graph partitions (partitioning >= 2) are renumbered. A shot domain with a single process is never renumbered:
+         * it stores the model in the order of the global index, which the batched modelling relies on for the source and receiver positions.
+         \param config configuration object
+         \param commShot communicator of a shot domain
+         */
+        inline bool useMortonRenumbering(Configuration::Configuration const &config, scai::dmemo::CommunicatorPtr commShot)
+        {
+            return (config.getAndCatch("localRenumbering", 0) == 1 && config.get<IndexType>("partitioning") >= 2 && commShot->getSize() > 1);
+        }
+
+        /*! \brief Graph partitioning of the model with Geographer
+        \param config configuration object
+        \param ctx context
+        \param commShot communicator of a shot domain
+        \param BlockDist initial (block) distribution of the model
+        \param derivatives derivatives object which defines the graph
+        \param modelCoordinates coordinate object
+        \param weightModel cost model of the node weights
+        */
+        template <typename ValueType>
+        dmemo::DistributionPtr graphPartition(Configuration::Configuration const &config, scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType> &derivatives, Acquisition::Coordinates<ValueType> const &modelCoordinates, WeightModel<ValueType> const &weightModel = WeightModel<ValueType>())
         {
             SCAI_REGION("KITGPI.graphPartitionAll")
 
@@ -508,7 +890,7 @@ namespace KITGPI
             coords[2].setContextPtr(loc);
 
             HOST_PRINT(commShot, "", "calculate node weights for partitioner \n");
-            auto &&weights = Weights(config, BlockDist, modelCoordinates);
+            auto &&weights = Weights(config, BlockDist, modelCoordinates, weightModel);
             weights.setContextPtr(loc);
 
             end_t = common::Walltime::get();
@@ -532,13 +914,22 @@ namespace KITGPI
             return (dist);
 #else
             HOST_PRINT(commShot, "partitioning=2 or useVariableGrid was set, but geographer was not compiled. \nUse < make prog GEOGRAPHER_ROOT= > to compile the partitioner")
-            HOST_PRINT(commShot, "\nBlock Distribution will be used instead!\n\n")
-            return (BlockDist);
+            HOST_PRINT(commShot, "\nThe built-in RCB partitioner will be used instead!\n\n")
+            return (rcbPartition(config, commShot, BlockDist, modelCoordinates, weightModel));
 #endif
         }
 
+        /*! \brief Graph partitioning of the model with ParMetis
+        \param config configuration object
+        \param ctx context
+        \param commShot communicator of a shot domain
+        \param BlockDist initial (block) distribution of the model
+        \param derivatives derivatives object which defines the graph
+        \param modelCoordinates coordinate object
+        \param weightModel cost model of the node weights
+        */
         template <typename ValueType>
-        dmemo::DistributionPtr metisPartition(Configuration::Configuration const &config, scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType> &derivatives, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+        dmemo::DistributionPtr metisPartition(Configuration::Configuration const &config, scai::hmemo::ContextPtr ctx, scai::dmemo::CommunicatorPtr commShot, scai::dmemo::DistributionPtr BlockDist, KITGPI::ForwardSolver::Derivatives::Derivatives<ValueType> &derivatives, Acquisition::Coordinates<ValueType> const &modelCoordinates, WeightModel<ValueType> const &weightModel = WeightModel<ValueType>())
         {
             SCAI_REGION("KITGPI.metisPartitionAll")
 
@@ -549,7 +940,7 @@ namespace KITGPI
 
             HOST_PRINT(commShot, "", "caclulate weights for ParMetis \n");
 
-            auto &&weights = Weights(config, BlockDist, modelCoordinates);
+            auto &&weights = Weights(config, BlockDist, modelCoordinates, weightModel);
 
             HOST_PRINT(commShot, "", "create partitioning by ParMetis \n");
 
@@ -575,7 +966,8 @@ namespace KITGPI
 
                 newDist = plan.getTargetDistributionPtr();
             } else {
-                HOST_PRINT(commShot, "", "ATTENTION: PARMETIS partitioning not supported, will use BLOCK distribution")
+                HOST_PRINT(commShot, "ATTENTION: PARMETIS partitioning not supported, will use the built-in RCB partitioner\n");
+                newDist = rcbPartition(config, commShot, BlockDist, modelCoordinates, weightModel);
             }
 
             return newDist;
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Partitioning.hpp"
+
+#include <scai/common/Walltime.hpp>
+#include <scai/dmemo/NoDistribution.hpp>
+#include <scai/hmemo/HArray.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <unistd.h>
+#include <vector>
+
+using namespace scai;
+
+namespace KITGPI
+{
+    namespace Partitioning
+    {
+        /*! \brief Number of shots of the acquisition
+         *
+         \param config configuration object
+         \return number of different shot numbers in the source file, 0 if the sources are not defined by a txt file
+         */
+        template <typename ValueType>
+        IndexType getNumShots(Configuration::Configuration const &config)
+        {
+            if (config.getAndCatch("useStreamConfig", false) || config.get<bool>("initSourcesFromSU")) {
+                return (0);
+            }
+            std::vector<Acquisition::sourceSettings<ValueType>> sourceSettings;
+            Acquisition::readAllSettings<ValueType>(sourceSettings, config.get<std::string>("SourceFilename") + ".txt");
+            std::vector<IndexType> shotNumbers;
+            for (auto const &source : sourceSettings) {
+                shotNumbers.push_back(source.sourceNo);
+            }
+            std::sort(shotNumbers.begin(), shotNumbers.end());
+            return (std::unique(shotNumbers.begin(), shotNumbers.end()) - shotNumbers.begin());
+        }
+
+        /*! \brief Choose the number of shot domains with the highest shot throughput
+         *
+         * Used with NumShotDomains = 0. Every divisor of the number of processes is a candidate, if the memory of a shot domain fits into the memory of the nodes.
+         * The runtime per time step of a candidate is predicted from a short calibration on all processes:
+         * the matrix vector product of the FD stencil is timed with as many gridpoints per process as the candidate has, scaled by the operation counts of the equation (see getOperationCounts() and WeightModel),
+         * and the halo exchange is estimated from the measured latency and bandwidth of a ring shift for the faces of a box partition.
+         * Has to be called by all processes.
+         \param config configuration object
+         \param ctx context
+         \param commAll communicator of all processes
+         \param modelCoordinates coordinate object
+         \param memTotal estimated memory of one shot domain in MB
+         \return number of shot domains
+         */
+        template <typename ValueType>
+        IndexType adviseNumShotDomains(Configuration::Configuration const &config, hmemo::ContextPtr ctx, dmemo::CommunicatorPtr commAll, Acquisition::Coordinates<ValueType> const &modelCoordinates, ValueType memTotal)
+        {
+            SCAI_REGION("KITGPI.adviseNumShotDomains")
+
+            SCAI_ASSERT_ERROR(config.get<IndexType>("ShotDomainDefinition") == 0, "NumShotDomains = 0 (automatic layout) requires ShotDomainDefinition = 0");
+
+            IndexType numProcesses = commAll->getSize();
+            IndexType numGridpoints = modelCoordinates.getNGridpoints();
+            IndexType numDimensions = (modelCoordinates.getNZ() > 1) ? 3 : 2;
+            IndexType NT = static_cast<IndexType>((config.get<ValueType>("T") / config.get<ValueType>("DT")) + 0.5);
+            IndexType spatialFDorder = config.get<IndexType>("spatialFDorder");
+            IndexType numShots = getNumShots<ValueType>(config);
+
+            // memory per process which is available on the nodes
+            double nodeMemory = config.getAndCatch("nodeMemory", 0.0); // in MB
+            if (nodeMemory <= 0) {
+                nodeMemory = double(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGE_SIZE) / (1024.0 * 1024.0);
+            }
+            nodeMemory = commAll->min(nodeMemory);
+            double memoryPerProcess = 0.9 * nodeMemory / commAll->getNodeSize();
+
+            // operations per gridpoint and time step relative to a matrix vector product with a 2nd order stencil
+            WeightModel<ValueType> weightModel;
+            std::string weightModelFilename = config.getAndCatch("weightModelFilename", std::string(""));
+            if (!weightModelFilename.empty()) {
+                weightModel.read(weightModelFilename);
+            }
+            OperationCounts counts = getOperationCounts(config);
+            double pointWeight = counts.NumMatrixVector * weightModel.MatrixVectorWeight[spatialFDorder / 2 - 1] + counts.NumVectorAssignement * weightModel.VectorAssignmentWeight + counts.NumVectorPlusVector * weightModel.VectorPlusVectorWeight;
+
+            // latency and time per value of a halo exchange
+            auto timeShift = [&](IndexType numValues) {
+                hmemo::HArray<ValueType> sendArray(numValues, 1.0);
+                hmemo::HArray<ValueType> recvArray;
+                IndexType numRepetitions = 10;
+                commAll->synchronize();
+                double start = common::Walltime::get();
+                for (IndexType repetition = 0; repetition < numRepetitions; repetition++) {
+                    commAll->shiftArray(recvArray, sendArray, 1);
+                }
+                return (commAll->max((common::Walltime::get() - start) / numRepetitions));
+            };
+            IndexType numShiftValues = 1 << 16;
+            double latency = timeShift(1);
+            double timePerValue = std::max(timeShift(numShiftValues) - latency, 0.0) / numShiftValues;
+
+            HOST_PRINT(commAll, "\n Automatic shot domain layout (" << numProcesses << " processes, " << commAll->getNodeSize() << " per node, " << memoryPerProcess << " MB per process available):\n");
+
+            IndexType bestNumShotDomains = 0;
+            double bestThroughput = 0;
+            for (IndexType numShotDomains = 1; numShotDomains <= numProcesses; numShotDomains++) {
+                if (numProcesses % numShotDomains != 0 || (numShots > 0 && numShotDomains > numShots)) {
+                    continue;
+                }
+                IndexType processesPerDomain = numProcesses / numShotDomains;
+                double memoryPerDomainProcess = memTotal / processesPerDomain;
+                if (memoryPerDomainProcess > memoryPerProcess) {
+                    HOST_PRINT(commAll, " - " << numShotDomains << " shot domains: " << memoryPerDomainProcess << " MB per process do not fit into memory\n");
+                    continue;
+                }
+
+                // calibration of the matrix vector product with the local size of the candidate
+                IndexType numLocal = (numGridpoints + processesPerDomain - 1) / processesPerDomain;
+                IndexType numBench = std::max(std::min(numLocal, IndexType(1) << 22), IndexType(1000));
+                dmemo::DistributionPtr benchDist(new dmemo::NoDistribution(numBench));
+                auto matrix = stencilMatrix<ValueType>(benchDist, 2, 1, ctx);
+                lama::DenseVector<ValueType> x;
+                lama::DenseVector<ValueType> y;
+                x.setContextPtr(ctx);
+                y.setContextPtr(ctx);
+                x.setSameValue(benchDist, 1.0);
+                y = matrix * x;
+                commAll->synchronize();
+                double start = common::Walltime::get();
+                IndexType numRepetitions = 5;
+                for (IndexType repetition = 0; repetition < numRepetitions; repetition++) {
+                    y = matrix * x;
+                }
+                double timePerPoint = commAll->max((common::Walltime::get() - start) / (numRepetitions * numBench));
+
+                double computeTime = pointWeight * timePerPoint * numLocal;
+                double haloTime = 0.0;
+                if (processesPerDomain > 1) {
+                    double facePoints = std::pow(double(numLocal), double(numDimensions - 1) / numDimensions);
+                    haloTime = counts.NumMatrixVector * (2 * latency + 2 * timePerValue * facePoints * spatialFDorder / 2);
+                }
+                double timePerStep = computeTime + haloTime;
+
+                IndexType numRounds = (numShots > 0) ? (numShots + numShotDomains - 1) / numShotDomains : 1;
+                IndexType numShotsRun = (numShots > 0) ? numShots : numShotDomains;
+                double throughput = 3600.0 * numShotsRun / (numRounds * NT * timePerStep);
+
+                HOST_PRINT(commAll, " - " << numShotDomains << " shot domains x " << processesPerDomain << " processes: " << memoryPerDomainProcess << " MB per process, " << timePerStep * 1000 << " ms per time step, " << std::fixed << std::setprecision(1) << throughput << std::defaultfloat << " shots per hour\n");
+
+                if (throughput > bestThroughput) {
+                    bestThroughput = throughput;
+                    bestNumShotDomains = numShotDomains;
+                }
+            }
+
+            SCAI_ASSERT_ERROR(bestNumShotDomains > 0, "The model (" << memTotal << " MB) does not fit into the memory of the nodes");
+
+            HOST_PRINT(commAll, "\n Using NumShotDomains = " << bestNumShotDomains << " with " << numProcesses / bestNumShotDomains << " processes per shot domain, predicted throughput " << std::fixed << std::setprecision(1) << bestThroughput << std::defaultfloat << " shots per hour\n\n");
+
+            return (bestNumShotDomains);
+        }
+    }
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "../Common/HostPrint.hpp"
+#include "../Configuration/Configuration.hpp"
+
+#include <scai/common/Walltime.hpp>
+#include <scai/dmemo/NoDistribution.hpp>
+#include <scai/lama.hpp>
+#include <scai/lama/DenseVector.hpp>
+#include <scai/lama/SparseVector.hpp>
+#include <scai/lama/matrix/CSRSparseMatrix.hpp>
+#include <scai/lama/matrix/DenseMatrix.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace scai;
+
+namespace KITGPI
+{
+    namespace Partitioning
+    {
+        /*! \brief Cost model of the node weights for the graph partitioners
+         *
+         * All weights are runtimes per gridpoint (per trace for sources and receivers) relative to one row of a matrix vector product with a 2nd order FD stencil.
+         * The default values are the weights which have been measured once on a reference machine.
+         * A calibrated model can be measured on the target machine with calibrateWeightModel() and is stored as a `KEY=VALUE` file like the configuration.
+         */
+        template <typename ValueType>
+        struct WeightModel {
+            ValueType MatrixVectorWeight[6] = {1.00, 1.56, 2.06, 2.54, 3.00, 3.70}; //!< matrix vector product with FD order 2-12
+            ValueType VectorAssignmentWeight = 0.25;                                //!< elementwise vector operation (e.g. v *= c)
+            ValueType VectorPlusVectorWeight = 0.43;                                //!< vector addition (e.g. v += u)
+            ValueType PMLWeight = 1.5;                                              //!< CPML update of one derivative
+            ValueType FreeSurfaceWeight = 0.6;                                      //!< sparse update of one wavefield on the free surface
+            ValueType InterpolationWeight = 1.56;                                   //!< interpolation of one wavefield on a variable grid interface
+            ValueType RelaxationWeight = 0.93;                                      //!< update of one memory variable of one relaxation mechanism
+            ValueType SourceWeight = 2.0;                                           //!< injection of one source trace per time step
+            ValueType ReceiverWeight = 2.0;                                         //!< recording of one receiver trace per time step
+
+            /*! \brief Read the weight model from file
+             *
+             * Missing keys keep their default value.
+             \param filename Name of the weight model file
+             */
+            void read(std::string const &filename)
+            {
+                Configuration::Configuration file(filename);
+                for (IndexType i = 0; i < 6; i++) {
+                    MatrixVectorWeight[i] = file.getAndCatch("MatrixVectorWeight" + std::to_string(2 * i + 2), MatrixVectorWeight[i]);
+                }
+                VectorAssignmentWeight = file.getAndCatch("VectorAssignmentWeight", VectorAssignmentWeight);
+                VectorPlusVectorWeight = file.getAndCatch("VectorPlusVectorWeight", VectorPlusVectorWeight);
+                PMLWeight = file.getAndCatch("PMLWeight", PMLWeight);
+                FreeSurfaceWeight = file.getAndCatch("FreeSurfaceWeight", FreeSurfaceWeight);
+                InterpolationWeight = file.getAndCatch("InterpolationWeight", InterpolationWeight);
+                RelaxationWeight = file.getAndCatch("RelaxationWeight", RelaxationWeight);
+                SourceWeight = file.getAndCatch("SourceWeight", SourceWeight);
+                ReceiverWeight = file.getAndCatch("ReceiverWeight", ReceiverWeight);
+            }
+
+            /*! \brief Write the weight model to file
+             *
+             \param filename Name of the weight model file
+             */
+            void write(std::string const &filename) const
+            {
+                std::ofstream outputFile(filename);
+                SCAI_ASSERT_ERROR(outputFile.good(), "Could not open weight model file " << filename);
+                outputFile << "# node weights per gridpoint relative to a matrix vector product with a 2nd order FD stencil\n";
+                outputFile << std::setprecision(4);
+                for (IndexType i = 0; i < 6; i++) {
+                    outputFile << "MatrixVectorWeight" << 2 * i + 2 << "=" << MatrixVectorWeight[i] << "\n";
+                }
+                outputFile << "VectorAssignmentWeight=" << VectorAssignmentWeight << "\n";
+                outputFile << "VectorPlusVectorWeight=" << VectorPlusVectorWeight << "\n";
+                outputFile << "PMLWeight=" << PMLWeight << "\n";
+                outputFile << "FreeSurfaceWeight=" << FreeSurfaceWeight << "\n";
+                outputFile << "InterpolationWeight=" << InterpolationWeight << "\n";
+                outputFile << "RelaxationWeight=" << RelaxationWeight << "\n";
+                outputFile << "SourceWeight=" << SourceWeight << "\n";
+                outputFile << "ReceiverWeight=" << ReceiverWeight << "\n";
+            }
+        };
+
+        /*! \brief Banded matrix with the structure of an FD derivative for micro benchmarks
+         *
+         \param dist distribution of the matrix
+         \param spatialFDorder number of entries per row
+         \param stride distance of the entries, 1 corresponds to x and NX to y derivatives
+         \param ctx context
+         */
+        template <typename ValueType>
+        lama::CSRSparseMatrix<ValueType> stencilMatrix(dmemo::DistributionPtr dist, IndexType spatialFDorder, IndexType stride, hmemo::ContextPtr ctx)
+        {
+            IndexType N = dist->getGlobalSize();
+            lama::MatrixAssembly<ValueType> assembly;
+            for (IndexType i = 0; i < N; i++) {
+                for (IndexType j = -spatialFDorder / 2 + 1; j <= spatialFDorder / 2; j++) {
+                    IndexType column = i + j * stride;
+                    if (column >= 0 && column < N) {
+                        assembly.push(i, column, 1.0 / (j + spatialFDorder));
+                    }
+                }
+            }
+            lama::CSRSparseMatrix<ValueType> matrix = lama::zero<lama::CSRSparseMatrix<ValueType>>(dist, dist);
+            matrix.fillFromAssembly(assembly);
+            matrix.setContextPtr(ctx);
+            return (matrix);
+        }
+
+        /*! \brief Calibrate the weight model with micro benchmarks on the target machine
+         *
+         * Every process of the shot domain times the kernels of the time stepping on as many gridpoints as it owns with the initial distribution.
+         * All processes run at the same time, so the measurement includes the shared memory bandwidth of a node. The runtimes are averaged over the shot domain.
+         \param config configuration object
+         \param ctx context
+         \param commShot communicator of a shot domain
+         \param dist initial (block) distribution of the model
+         */
+        template <typename ValueType>
+        WeightModel<ValueType> calibrateWeightModel(Configuration::Configuration const &config, hmemo::ContextPtr ctx, dmemo::CommunicatorPtr commShot, dmemo::DistributionPtr dist)
+        {
+            SCAI_REGION("KITGPI.calibrateWeightModel")
+
+            double start_t = common::Walltime::get();
+            HOST_PRINT(commShot, "", "Calibration of the partitioner node weights...\n");
+
+            IndexType numRepetitions = config.getAndCatch("weightCalibrationRepetitions", 10);
+            SCAI_ASSERT_ERROR(numRepetitions > 0, "weightCalibrationRepetitions has to be positive");
+
+            IndexType N = std::max(dist->getLocalSize(), IndexType(1000));
+            IndexType NX = std::min(config.get<IndexType>("NX"), N - 1);
+            IndexType numTraces = std::min(N, IndexType(1000));
+
+            dmemo::DistributionPtr benchDist(new dmemo::NoDistribution(N));
+
+            lama::DenseVector<ValueType> x;
+            lama::DenseVector<ValueType> y;
+            lama::DenseVector<ValueType> z;
+            lama::DenseVector<ValueType> r;
+            lama::DenseVector<ValueType> temp;
+            for (auto vector : {&x, &y, &z, &r, &temp}) {
+                vector->setContextPtr(ctx);
+                vector->setSameValue(benchDist, 1.0);
+            }
+
+            // runtime of one call of kernel per gridpoint, the first call is not timed
+            auto timeKernel = [&](std::function<void(IndexType)> kernel, IndexType numPoints) {
+                kernel(0);
+                commShot->synchronize();
+                double start = common::Walltime::get();
+                for (IndexType repetition = 0; repetition < numRepetitions; repetition++) {
+                    kernel(repetition);
+                }
+                double time = (common::Walltime::get() - start) / (numRepetitions * numPoints);
+                return (commShot->sum(time) / commShot->getSize());
+            };
+
+            std::vector<double> matrixVectorTime(6);
+            for (IndexType i = 0; i < 6; i++) {
+                for (IndexType stride : {IndexType(1), NX}) {
+                    auto matrix = stencilMatrix<ValueType>(benchDist, 2 * i + 2, stride, ctx);
+                    matrixVectorTime[i] += 0.5 * timeKernel([&](IndexType) { y = matrix * x; }, N);
+                }
+            }
+
+            double vectorAssignmentTime = timeKernel([&](IndexType) { y *= z; }, N);
+            double vectorPlusVectorTime = timeKernel([&](IndexType) { y += x; }, N);
+            double relaxationTime = timeKernel([&](IndexType) { temp = x; temp *= z; r *= z; r -= temp; }, N);
+
+            // CPML and free surface kernels work on sparse vectors which cover the benchmark points
+            lama::VectorAssembly<ValueType> assembly;
+            for (IndexType i = 0; i < N; i++) {
+                assembly.push(i, 0.5);
+            }
+            lama::SparseVector<ValueType> a;
+            lama::SparseVector<ValueType> b;
+            lama::SparseVector<ValueType> psi;
+            lama::SparseVector<ValueType> tempSparse;
+            for (auto vector : {&a, &b, &psi, &tempSparse}) {
+                vector->setContextPtr(ctx);
+                vector->allocate(benchDist);
+                vector->fillFromAssembly(assembly);
+            }
+
+            double pmlTime = timeKernel([&](IndexType) {
+                SCAI_SPARSE_VECTOR_SAME_PATTERN
+                tempSparse = a;
+                psi *= b;
+                tempSparse *= x;
+                psi += tempSparse;
+                r += psi;
+            },
+                                        N);
+            double freeSurfaceTime = timeKernel([&](IndexType) {
+                SCAI_SPARSE_VECTOR_SAME_PATTERN
+                tempSparse = a;
+                tempSparse *= x;
+                r += tempSparse;
+            },
+                                                N);
+
+            // sources and receivers are gathered/scattered trace by trace into the seismogram data
+            auto coordinates = lama::linearDenseVector<IndexType>(numTraces, 0, N / numTraces);
+            coordinates.setContextPtr(ctx);
+            dmemo::DistributionPtr traceDist(new dmemo::NoDistribution(numTraces));
+            dmemo::DistributionPtr sampleDist(new dmemo::NoDistribution(numRepetitions));
+            auto traces = lama::zero<lama::DenseMatrix<ValueType>>(traceDist, sampleDist);
+            traces.setContextPtr(ctx);
+            lama::DenseVector<ValueType> traceSample;
+            traceSample.setContextPtr(ctx);
+
+            double receiverTime = timeKernel([&](IndexType t) {
+                traceSample.gatherInto(x, coordinates, common::BinaryOp::COPY);
+                traces.setColumn(traceSample, t, common::BinaryOp::COPY);
+            },
+                                             numTraces);
+            double sourceTime = timeKernel([&](IndexType t) {
+                traces.getColumn(traceSample, t);
+                x.scatter(coordinates, true, traceSample, common::BinaryOp::ADD);
+            },
+                                           numTraces);
+
+            WeightModel<ValueType> weightModel;
+            double referenceTime = matrixVectorTime[0];
+            for (IndexType i = 0; i < 6; i++) {
+                weightModel.MatrixVectorWeight[i] = matrixVectorTime[i] / referenceTime;
+            }
+            weightModel.VectorAssignmentWeight = vectorAssignmentTime / referenceTime;
+            weightModel.VectorPlusVectorWeight = vectorPlusVectorTime / referenceTime;
+            weightModel.PMLWeight = pmlTime / referenceTime;
+            weightModel.FreeSurfaceWeight = freeSurfaceTime / referenceTime;
+            // the interpolation on a variable grid interface is a matrix vector product with 4 entries per row
+            weightModel.InterpolationWeight = matrixVectorTime[1] / referenceTime;
+            weightModel.RelaxationWeight = relaxationTime / referenceTime;
+            weightModel.SourceWeight = sourceTime / referenceTime;
+            weightModel.ReceiverWeight = receiverTime / referenceTime;
+
+            double end_t = common::Walltime::get();
+            HOST_PRINT(commShot, "", "Finished calibration of the partitioner node weights in " << end_t - start_t << " sec.\n\n");
+
+            return (weightModel);
+        }
+
+        /*! \brief Get the weight model of the graph partitioners
+         *
+         * calibratePartitionWeights = 1: the model is measured with calibrateWeightModel() and written to weightModelFilename (if given).
+         * Otherwise the model is read from weightModelFilename (if given) or the default weights are used.
+         \param config configuration object
+         \param ctx context
+         \param commAll communicator of all processes
+         \param commShot communicator of a shot domain
+         \param dist initial (block) distribution of the model
+         */
+        template <typename ValueType>
+        WeightModel<ValueType> getWeightModel(Configuration::Configuration const &config, hmemo::ContextPtr ctx, dmemo::CommunicatorPtr commAll, dmemo::CommunicatorPtr commShot, dmemo::DistributionPtr dist)
+        {
+            std::string weightModelFilename = config.getAndCatch("weightModelFilename", std::string(""));
+
+            WeightModel<ValueType> weightModel;
+            if (config.getAndCatch("calibratePartitionWeights", false)) {
+                weightModel = calibrateWeightModel<ValueType>(config, ctx, commShot, dist);
+                if (!weightModelFilename.empty() && commAll->getRank() == MASTERGPI) {
+                    weightModel.write(weightModelFilename);
+                }
+            } else if (!weightModelFilename.empty()) {
+                weightModel.read(weightModelFilename);
+            }
+            return (weightModel);
+        }
+    }
+}
@@ -7,11 +7,15 @@
 #include <scai/tracing.hpp>
 #include <scai/common/macros/assert.hpp>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <future>
 
 #include "Configuration/Configuration.hpp"
+#include "Configuration/SimulationParameters.hpp"
 #include "Configuration/ValueType.hpp"
 
 #include "Acquisition/Receivers.hpp"
@@ -25,8 +29,13 @@
 #include "CheckParameter/CheckParameter.hpp"
 #include "Common/HostPrint.hpp"
 #include "Common/Common.hpp"
+#include "Common/NodeSharedMemory.hpp"
+#include "Common/Profiler.hpp"
+#include "Common/ShotManifest.hpp"
+#include "Common/ShotScheduler.hpp"
 #include <scai/lama/io/PartitionIO.hpp>
 #include "Partitioning/Partitioning.hpp"
+#include "Partitioning/ShotDomainAdvisor.hpp"
 
 using namespace scai;
 using namespace KITGPI;
@@ -57,6 +66,9 @@ int main(int argc, const char *argv[])
     Configuration::Configuration config(argv[1]);
     verbose = config.get<bool>("verbose");
     
+    // typed and validated parameters of the shot and time loops
+    Configuration::SimulationParameters<ValueType> const parameters(config);
+    
     Configuration::Configuration configBig;
     bool useStreamConfig = config.getAndCatch("useStreamConfig", false);
     
@@ -113,11 +125,28 @@ int main(int argc, const char *argv[])
     /* execution context */
     hmemo::ContextPtr ctx = hmemo::Context::getContextPtr(); // default context, set by environment variable SCAI_CONTEXT
 
+    if (config.get<IndexType>("NumShotDomains") == 0) {
+        // automatic layout: memory estimation of a single shot domain on a block distribution
+        dmemo::DistributionPtr estimationDist = std::make_shared<dmemo::BlockDistribution>(modelCoordinates.getNGridpoints(), commAll);
+        ForwardSolver::Derivatives::Derivatives<ValueType>::DerivativesPtr estimationDerivatives(ForwardSolver::Derivatives::Factory<ValueType>::Create(dimension));
+        Modelparameter::Modelparameter<ValueType>::ModelparameterPtr estimationModel(Modelparameter::Factory<ValueType>::Create(equationType));
+        Wavefields::Wavefields<ValueType>::WavefieldPtr estimationWavefields(Wavefields::Factory<ValueType>::Create(dimension, equationType));
+        ForwardSolver::ForwardSolver<ValueType>::ForwardSolverPtr estimationSolver(ForwardSolver::Factory<ValueType>::Create(dimension, equationType));
+        ValueType memShotDomain = estimationDerivatives->estimateMemory(config, estimationDist, modelCoordinates) + estimationWavefields->estimateMemory(estimationDist, numRelaxationMechanisms) + estimationModel->estimateMemory(estimationDist) + estimationSolver->estimateMemory(config, estimationDist, modelCoordinates);
+
+        IndexType numShotDomains = Partitioning::adviseNumShotDomains<ValueType>(config, ctx, commAll, modelCoordinates, memShotDomain);
+        config.add2config("NumShotDomains", numShotDomains, true);
+    }
+
     IndexType shotDomain = Partitioning::getShotDomain(config, commAll); // will contain the domain to which this processor belongs
 
     // Build subsets of processors for the shots
     dmemo::CommunicatorPtr commShot = commAll->split(shotDomain);
     dmemo::CommunicatorPtr commInterShot = commAll->split(commShot->getRank());
+    // the shot pipeline sets up and writes shots on a helper thread, a shot domain with a single process therefore works without MPI so that only the main thread calls MPI
+    if (config.getAndCatch("useShotPipeline", false) && commShot->getSize() == 1) {
+        commShot = dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO);
+    }
     SCAI_DMEMO_TASK(commShot)
 
     /* --------------------------------------- */
@@ -133,6 +162,7 @@ int main(int argc, const char *argv[])
     case 0:
     case 2:
     case 3:
+    case 4:
         //Block distribution = starting distribution for graph partitioner
         dist = std::make_shared<dmemo::BlockDistribution>(modelCoordinates.getNGridpoints(), commShot);
         break;
@@ -184,31 +214,85 @@ int main(int argc, const char *argv[])
 
     HOST_PRINT(commAll, "\n\n ===========================================================\n")
 
+    // machine-readable copy of the estimation, e.g. to choose the number of nodes of a job
+    std::string memoryReportFilename = config.getAndCatch("memoryReportFilename", std::string(""));
+    if (!memoryReportFilename.empty() && commAll->getRank() == MASTERGPI) {
+        std::ofstream report(memoryReportFilename);
+        report << "{\n";
+        report << "  \"unit\": \"MB\",\n";
+        report << "  \"numGridpoints\": " << modelCoordinates.getNGridpoints() << ",\n";
+        report << "  \"numPartitions\": " << dist->getNumPartitions() << ",\n";
+        report << "  \"numShotDomains\": " << numShotDomains << ",\n";
+        report << "  \"derivatives\": " << memDerivatives << ",\n";
+        report << "  \"wavefields\": " << memWavefileds << ",\n";
+        report << "  \"model\": " << memModel << ",\n";
+        report << "  \"boundaryConditions\": " << memSolver << ",\n";
+        report << "  \"total\": " << memTotal << ",\n";
+        report << "  \"perPartition\": " << memTotal / dist->getNumPartitions() << ",\n";
+        report << "  \"allShotDomains\": " << memTotal * numShotDomains << "\n";
+        report << "}\n";
+        SCAI_ASSERT_ERROR(report.good(), "Could not write memory report " << memoryReportFilename);
+    }
+
     /* --------------------------------------- */
     /* Call partitioner                        */
     /* --------------------------------------- */
-    if (configPartitioning == 2) {
+    Common::PhaseTimer partitioningTimer(Common::Phase::Partitioning);
+    bool usePartitionCache = config.getAndCatch("usePartitionCache", false) && configPartitioning >= 2;
+    bool partitionCached = false;
+    if (usePartitionCache) {
+        auto cachedDist = Partitioning::readPartitionCache(config, commShot, dist, modelCoordinates);
+        if (cachedDist) {
+            dist = cachedDist;
+            partitionCached = true;
+        }
+    }
+
+    Partitioning::WeightModel<ValueType> weightModel;
+    if (configPartitioning >= 2 && !partitionCached) {
+        weightModel = Partitioning::getWeightModel<ValueType>(config, ctx, commAll, commShot, dist);
+    }
+
+    if (configPartitioning == 2 && !partitionCached) {
         SCAI_REGION("WAVE-Simulation.partitioningGEO")
         start_t = common::Walltime::get();
-        dist = Partitioning::graphPartition(config, ctx, commShot, dist, *derivatives, modelCoordinates);
+        dist = Partitioning::graphPartition(config, ctx, commShot, dist, *derivatives, modelCoordinates, weightModel);
         end_t = common::Walltime::get();
         HOST_PRINT(commAll, "", "Finished Geographer graph partitioning in " << end_t - start_t << " sec.\n\n");
     }
 
-    if (configPartitioning == 3) {
+    if (configPartitioning == 3 && !partitionCached) {
         SCAI_REGION("WAVE-Simulation.partitioningMetis")
         start_t = common::Walltime::get();
-        dist = Partitioning::metisPartition(config, ctx, commShot, dist, *derivatives, modelCoordinates);
+        dist = Partitioning::metisPartition(config, ctx, commShot, dist, *derivatives, modelCoordinates, weightModel);
         end_t = common::Walltime::get();
         HOST_PRINT(commAll, "", "Finished ParMetis graph partitioning in " << end_t - start_t << " sec.\n\n");
     }
 
+    if (configPartitioning == 4 && !partitionCached) {
+        SCAI_REGION("WAVE-Simulation.partitioningRCB")
+        start_t = common::Walltime::get();
+        dist = Partitioning::rcbPartition(config, commShot, dist, modelCoordinates, weightModel);
+        end_t = common::Walltime::get();
+        HOST_PRINT(commAll, "", "Finished RCB partitioning in " << end_t - start_t << " sec.\n\n");
+    }
+
+    if (usePartitionCache && !partitionCached && shotDomain == 0) {
+        Partitioning::writePartitionCache(config, commShot, dist, modelCoordinates);
+    }
+
+    if (Partitioning::useMortonRenumbering(config, commShot)) {
+        HOST_PRINT(commAll, "", "Renumbering the local gridpoints along a Morton curve\n");
+        dist = Partitioning::mortonRenumbering(dist, modelCoordinates);
+    }
+
     bool writePartition = config.getAndCatch("writePartition", false);
 
     if (writePartition) {
         scai::lama::DenseVector<IndexType> partition(dist, commShot->getRank());
         IO::writeVector(partition, config.get<std::string>("partitionFilename") + std::to_string(shotDomain), config.get<IndexType>("fileFormat"));
     }
+    partitioningTimer.stop();
 
     /* --------------------------------------- */
     /* Calculate derivative matrizes           */
@@ -218,6 +302,7 @@ int main(int argc, const char *argv[])
     derivatives->init(dist, ctx, modelCoordinates, commShot);
     end_t = common::Walltime::get();
     HOST_PRINT(commAll, "", "Finished initializing matrices in " << end_t - start_t << " sec.\n\n");
+    Common::Profiler::global().addTime(Common::Phase::Derivatives, end_t - start_t);
 
     /* --------------------------------------- */
     /* Wavefields                              */
@@ -227,6 +312,7 @@ int main(int argc, const char *argv[])
     wavefields->init(ctx, dist, numRelaxationMechanisms);
     end_t = common::Walltime::get();
     HOST_PRINT(commAll, "", "Finished initializing wavefield in " << end_t - start_t << " sec.\n\n");
+    Common::Profiler::global().addTime(Common::Phase::Wavefields, end_t - start_t);
 
     /* --------------------------------------- */
     /* Acquisition geometry                    */
@@ -266,20 +352,18 @@ int main(int argc, const char *argv[])
     }
     SCAI_ASSERT_ERROR(numshots >= numShotDomains, "numshots = " + std::to_string(numshots) + ", numShotDomains = " + std::to_string(numShotDomains));
     IndexType useRandomSource = config.getAndCatch("useRandomSource", 0);
-    if (useSourceEncode == 0 && useRandomSource == 0) {
-        SCAI_ASSERT_ERROR(numshots % numShotDomains == 0, "numshots = " + std::to_string(numshots) + ", numShotDomains = " + std::to_string(numShotDomains));
-    }    
     sources.writeShotIndsIncr(commAll, config, uniqueShotNos);
     sources.writeSourceFC(commAll, config); 
     sources.writeSourceEncode(commAll, config); 
     Acquisition::writeCutCoordToFile(commAll, config, cutCoordinates, uniqueShotNos, NXPerShot);    
     
-    if (config.get<IndexType>("useReceiversPerShot") == 0) {
+    if (!parameters.useReceiversPerShot) {
         receivers.init(config, modelCoordinates, ctx, dist);
     }
     
     end_t = common::Walltime::get();
     HOST_PRINT(commAll, "", "Finished initializing Acquisition in " << end_t - start_t << " sec.\n\n");
+    Common::Profiler::global().addTime(Common::Phase::Acquisition, end_t - start_t);
     
     /* --------------------------------------- */
     /* Modelparameter                          */
@@ -294,31 +378,33 @@ int main(int argc, const char *argv[])
     }
     end_t = common::Walltime::get();
     HOST_PRINT(commAll, "", "Finished initializing model in " << end_t - start_t << " sec.\n\n");
+    Common::Profiler::global().addTime(Common::Phase::Model, end_t - start_t);
 
     /* --------------------------------------- */
     /* Forward solver                          */
     /* --------------------------------------- */
     SCAI_REGION("WAVE-Simulation.initForwardSolver")
     start_t = common::Walltime::get();
-    ValueType DT = config.get<ValueType>("DT");
-    IndexType tStepEnd = Common::time2index(config.get<ValueType>("T"), DT);
+    ValueType DT = parameters.DT;
+    IndexType tStepEnd = parameters.tStepEnd;
     if (!useStreamConfig) {
         solver->initForwardSolver(config, *derivatives, *wavefields, *model, modelCoordinates, ctx, DT);
     }
+    solver->getKernelProfiler().init(config, dist, modelCoordinates);
     end_t = common::Walltime::get();
     HOST_PRINT(commAll, "", "Finished initializing forward solver in " << end_t - start_t << " sec.\n\n");
+    Common::Profiler::global().addTime(Common::Phase::ForwardSolverInit, end_t - start_t);
     
     /* --------------------------------------- */
     /* Hilbert handler                         */
     /* --------------------------------------- */
-    IndexType snapType = config.get<IndexType>("snapType");
+    IndexType snapType = parameters.snapType;
     Hilbert::HilbertFFT<ValueType> hilbertHandlerTime;
-    IndexType decomposition = config.getAndCatch("decomposeWavefieldType", 0);
+    IndexType decomposition = parameters.decomposition;
     if (decomposition != 0) {
         IndexType kernelSize = Common::calcNextPowTwo<ValueType>(tStepEnd - 1);  
         hilbertHandlerTime.setCoefficientLength(kernelSize);
         hilbertHandlerTime.calcHilbertCoefficient(); 
-        snapType = decomposition + 3;
     }
     
     /* --------------------------------------- */
@@ -336,17 +422,64 @@ int main(int argc, const char *argv[])
     
     IndexType maxcount = 1;    
     std::vector<IndexType> shotHistory(numshots, 0);
-    std::shared_ptr<const dmemo::BlockDistribution> shotDist;
+    Common::ShotScheduler shotScheduler;
+    IndexType numShotsScheduled = numshots;
     if (useRandomSource != 0) {  
-        shotDist = dmemo::blockDistribution(numShotDomains, commInterShot);
-    } else {
-        shotDist = dmemo::blockDistribution(numshots, commInterShot);
+        numShotsScheduled = numShotDomains;
+    }
+    // shots which are finished according to the shot manifest are not computed again
+    Common::ShotManifest shotManifest;
+    shotManifest.init(config, commAll, commShot);
+    if (shotManifest.isActive()) {
+        SCAI_ASSERT_ERROR(useRandomSource == 0, "The shot manifest (shotManifestFilename) does not support useRandomSource");
+        SCAI_ASSERT_ERROR(!(uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && (parameters.writeSource || receivers.getNumTracesGlobal() == numShotPerSuperShot)), "The shot manifest (shotManifestFilename) does not support common offset gathers");
     }
     IndexType numRand = numshots / numShotDomains;  
     if (decomposition != 0) {
         numRand = 2;
     }
     
+    bool writeModelPerShot = config.getAndCatch("writeModelPerShot", true);
+    bool solverInitializedPerShot = false;
+    // the model does not change during the shot loop, so its velocity range is computed only for the first shot
+    CheckParameter::VelocityRange<ValueType> velocityRange;
+    
+    IndexType numShotsPerBatch = config.getAndCatch("numShotsPerBatch", 1);
+    bool useNodeSharedMemory = config.getAndCatch("useNodeSharedMemory", false);
+    bool useBlockStructuredOperators = config.getAndCatch("useBlockStructuredOperators", false);
+    // the block-structured operators are only implemented in the batched modelling, all other configurations keep the sparse matrices of the regular time loop
+    if (useBlockStructuredOperators && numShotsPerBatch == 1 && !useNodeSharedMemory) {
+        bool useCommonOffset = (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && (parameters.writeSource || receivers.getNumTracesGlobal() == numShotPerSuperShot));
+        std::string batchSolver = dimension + equationType;
+        std::transform(batchSolver.begin(), batchSolver.end(), batchSolver.begin(), ::tolower);
+        bool batchSupported = batchSolver == "2dacoustic" && commShot->getSize() == 1 && !useStreamConfig && decomposition == 0 && snapType == 0 && !parameters.useCompensation && !useCommonOffset && !config.getAndCatch("useShotPipeline", false);
+        if (!batchSupported) {
+            HOST_PRINT(commAll, "Note: useBlockStructuredOperators is only available for 2D acoustic modelling with a single process per shot domain and without useStreamConfig, decomposition, snapshots, compensation, common offset gathers and the shot pipeline, the sparse matrices are used\n");
+            useBlockStructuredOperators = false;
+        }
+    }
+    // node shared memory and the block-structured operators are only used by the batched modelling (also with a single shot per batch)
+    bool useBatch = (numShotsPerBatch > 1 || useNodeSharedMemory || useBlockStructuredOperators);
+    Common::NodeSharedMemory nodeSharedMemory;
+    if (useBatch) {
+        SCAI_ASSERT_ERROR(numShotsPerBatch > 0, "numShotsPerBatch has to be positive");
+        SCAI_ASSERT_ERROR(commShot->getSize() == 1, "Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) requires shot domains with a single process, the kernels use OpenMP threads instead");
+        SCAI_ASSERT_ERROR(!useStreamConfig && decomposition == 0 && snapType == 0 && !parameters.useCompensation, "Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) does not support useStreamConfig, wavefield decomposition, snapshots and compensation");
+        SCAI_ASSERT_ERROR(!(uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && (parameters.writeSource || receivers.getNumTracesGlobal() == numShotPerSuperShot)), "Batched modelling (numShotsPerBatch > 1, useNodeSharedMemory or useBlockStructuredOperators) does not support common offset gathers");
+        if (useNodeSharedMemory) {
+            nodeSharedMemory.init(commAll);
+        }
+        solver->initBatch(*derivatives, *model, modelCoordinates, numShotsPerBatch, nodeSharedMemory);
+    }
+    
+    // the setup of the next shot and the output of the previous shot run on a helper thread during the time stepping
+    bool useShotPipeline = config.getAndCatch("useShotPipeline", false);
+    if (useShotPipeline) {
+        SCAI_ASSERT_ERROR(!useBatch && commShot->getSize() == 1, "The shot pipeline (useShotPipeline) requires shot domains with a single process and no batched modelling");
+        SCAI_ASSERT_ERROR(!useStreamConfig && decomposition == 0 && snapType == 0, "The shot pipeline (useShotPipeline) does not support useStreamConfig, wavefield decomposition and snapshots");
+        SCAI_ASSERT_ERROR(!(uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && (parameters.writeSource || receivers.getNumTracesGlobal() == numShotPerSuperShot)), "The shot pipeline (useShotPipeline) does not support common offset gathers");
+    }
+    
     double tInit = common::Walltime::get();
     HOST_PRINT(commAll, "\nFinished all initialization in " << tInit - globalStart_t << " sec.\n");
         
@@ -354,7 +487,7 @@ int main(int argc, const char *argv[])
     /* Loop over shots                         */
     /* --------------------------------------- */
     if (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1) {
-        if (config.getAndCatch("writeSource", false))
+        if (parameters.writeSource)
             sources.getSeismogramHandler().allocateCOP(numshots, tStepEnd);
         if (receivers.getNumTracesGlobal() == numShotPerSuperShot)
             receivers.getSeismogramHandler().allocateCOP(numshots, tStepEnd);
@@ -366,8 +499,231 @@ int main(int argc, const char *argv[])
         IndexType shotNumber;
         IndexType shotIndTrue = 0;
         IndexType shotIndIncr = 0;
-        for (IndexType shotInd = shotDist->lb(); shotInd < shotDist->ub(); shotInd++) {
+        shotScheduler.init(config, commAll, commShot, commInterShot, numShotsScheduled, randInd);
+        shotScheduler.skipShots(shotManifest.getCompletedShots(randInd));
+        IndexType shotInd;
+        
+        /* --------------------------------------- */
+        /* Batched modelling of several shots      */
+        /* --------------------------------------- */
+        if (useBatch) {
+            std::vector<Acquisition::Sources<ValueType>> sourcesBatch(numShotsPerBatch);
+            std::vector<Acquisition::Receivers<ValueType>> receiversBatch(numShotsPerBatch);
+            std::vector<IndexType> shotNumbersBatch;
+            std::vector<IndexType> shotIndsBatch;
+            bool shotsLeft = true;
+            while (shotsLeft) {
+                SCAI_REGION("WAVE-Simulation.batchLoop")
+                std::vector<Acquisition::AcquisitionGeometry<ValueType> *> receiversPtr;
+                std::vector<Acquisition::AcquisitionGeometry<ValueType> const *> sourcesPtr;
+                shotNumbersBatch.clear();
+                shotIndsBatch.clear();
+                while (IndexType(shotNumbersBatch.size()) < numShotsPerBatch) {
+                    shotsLeft = shotScheduler.getNextShot(shotInd);
+                    if (!shotsLeft) {
+                        break;
+                    }
+                    Common::PhaseTimer setupTimer(Common::Phase::ShotSetup);
+                    IndexType k = shotNumbersBatch.size();
+                    shotIndTrue = uniqueShotInds[shotInd];
+                    
+                    std::vector<Acquisition::sourceSettings<ValueType>> sourceSettingsShot;
+                    if (useSourceEncode == 0) {
+                        shotNumber = uniqueShotNos[shotIndTrue];
+                        Acquisition::createSettingsForShot(sourceSettingsShot, sourceSettings, shotNumber);
+                    } else {
+                        shotNumber = uniqueShotNosEncode[shotIndTrue];
+                        Acquisition::createSettingsForShot(sourceSettingsShot, sourceSettingsEncode, shotNumber);
+                    }
+                    sourcesBatch[k].init(sourceSettingsShot, config, modelCoordinates, ctx, dist);
+                    CheckParameter::checkNumericalArtefactsAndInstabilities<ValueType>(config, sourceSettingsShot, *model, modelCoordinates, shotNumber, &velocityRange);
+                    
+                    if (parameters.useReceiversPerShot) {
+                        receiversBatch[k].init(config, modelCoordinates, ctx, dist, shotNumber, sourceSettingsEncode);
+                    } else {
+                        receiversBatch[k].init(config, modelCoordinates, ctx, dist);
+                    }
+                    
+                    sourcesPtr.push_back(&sourcesBatch[k]);
+                    receiversPtr.push_back(&receiversBatch[k]);
+                    shotNumbersBatch.push_back(shotNumber);
+                    shotIndsBatch.push_back(shotInd);
+                }
+                if (shotNumbersBatch.empty()) {
+                    break;
+                }
+                
+                HOST_PRINT(commShot, "Start time stepping for " << shotNumbersBatch.size() << " shots starting with shot number " << shotNumbersBatch[0] << " (" << "domain " << shotDomain << ", batched)\n", "\nTotal Number of time steps: " << tStepEnd << "\n");
+                start_t = common::Walltime::get();
+                solver->setBatchAcquisition(receiversPtr, sourcesPtr);
+                
+                double start_t2 = 0.0, end_t2 = 0.0;
+                for (IndexType tStep = 0; tStep < tStepEnd; tStep++) {
+                    SCAI_REGION("WAVE-Simulation.timeLoop")
+                    if ((tStep - 1) % 100 == 0) {
+                        start_t2 = common::Walltime::get();
+                    }
+                    
+                    solver->runBatch(tStep);
+                    
+                    if (tStep % 100 == 0 && tStep != 0) {
+                        end_t2 = common::Walltime::get();
+                        HOST_PRINT(commShot, "", "Calculated " << tStep << " time steps" << " in batch at t = " << end_t2 - globalStart_t << "\nLast 100 timesteps calculated in " << end_t2 - start_t2 << " sec. - Estimated runtime (Simulation/total): " << (int)((tStepEnd / 100) * (end_t2 - start_t2)) << " / " << (int)((tStepEnd / 100) * (end_t2 - start_t2) + tInit) << " sec.\n\n");
+                    }
+                }
+                end_t = common::Walltime::get();
+                HOST_PRINT(commShot, "Finished time stepping for " << shotNumbersBatch.size() << " shots in " << end_t - start_t << " sec.\n", "");
+                Common::Profiler::global().addTime(Common::Phase::TimeLoop, end_t - start_t);
+                
+                Common::PhaseTimer outputTimer(Common::Phase::Output);
+                for (unsigned k = 0; k < shotNumbersBatch.size(); k++) {
+                    shotNumber = shotNumbersBatch[k];
+                    auto &seismogramHandler = receiversBatch[k].getSeismogramHandler();
+                    SCAI_ASSERT_ERROR(commShot->all(seismogramHandler.isFinite()), "Infinite or NaN value in seismogram of shot " << shotNumber)
+                    
+                    std::vector<std::string> outputFilenames;
+                    if (parameters.normalizeTraces == 3) {
+                        seismogramHandler.setFrequencyAGC(parameters.frequencyAGC);
+                        seismogramHandler.calcInverseAGC();
+                        seismogramHandler.write(5, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumber), modelCoordinates, &outputFilenames);
+                    }
+                    seismogramHandler.normalize(parameters.normalizeTraces);
+                    seismogramHandler.write(parameters.seismogramFormat, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumber), modelCoordinates, &outputFilenames);
+                    receiversBatch[k].decode(config, parameters.seismogramFilename, shotNumber, sourceSettingsEncode, 1);
+                    receiversBatch[k].writeReceiverMark(config, shotNumber);
+                    shotManifest.recordShot(randInd, shotIndsBatch[k], shotNumber, outputFilenames);
+                }
+            }
+        }
+        
+        /* --------------------------------------- */
+        /* Pipelined modelling of single shots     */
+        /* --------------------------------------- */
+        if (useShotPipeline) {
+            // two stages: the helper thread finalizes the previous shot and prepares the next shot of one stage, while the shot of the other stage is modelled
+            std::vector<Acquisition::Sources<ValueType>> sourcesPipeline(2);
+            std::vector<Acquisition::Receivers<ValueType>> receiversPipeline(2);
+            std::vector<IndexType> shotNumbersPipeline(2, -1);
+            std::vector<IndexType> shotIndsPipeline(2, -1);
+            if (!parameters.useReceiversPerShot) {
+                receiversPipeline[0].init(config, modelCoordinates, ctx, dist);
+                receiversPipeline[1].init(config, modelCoordinates, ctx, dist);
+            }
+            
+            auto prepareShot = [&](IndexType stage, IndexType shotIndPrepare) {
+                SCAI_REGION("WAVE-Simulation.prepareShot")
+                Common::PhaseTimer setupTimer(Common::Phase::ShotSetup);
+                IndexType shotIndTruePrepare = uniqueShotInds[shotIndPrepare];
+                IndexType shotNumberPrepare;
+                std::vector<Acquisition::sourceSettings<ValueType>> sourceSettingsShot;
+                if (useSourceEncode == 0) {
+                    shotNumberPrepare = uniqueShotNos[shotIndTruePrepare];
+                    Acquisition::createSettingsForShot(sourceSettingsShot, sourceSettings, shotNumberPrepare);
+                } else {
+                    shotNumberPrepare = uniqueShotNosEncode[shotIndTruePrepare];
+                    Acquisition::createSettingsForShot(sourceSettingsShot, sourceSettingsEncode, shotNumberPrepare);
+                }
+                sourcesPipeline[stage].init(sourceSettingsShot, config, modelCoordinates, ctx, dist);
+                CheckParameter::checkNumericalArtefactsAndInstabilities<ValueType>(config, sourceSettingsShot, *model, modelCoordinates, shotNumberPrepare, &velocityRange);
+                if (parameters.writeSource) {
+                    sourcesPipeline[stage].getSeismogramHandler().write(parameters.seismogramFormat, parameters.writeSourceFilename + ".shot_" + std::to_string(shotNumberPrepare), modelCoordinates);
+                }
+                if (parameters.useReceiversPerShot) {
+                    receiversPipeline[stage].init(config, modelCoordinates, ctx, dist, shotNumberPrepare, sourceSettingsEncode);
+                }
+                shotNumbersPipeline[stage] = shotNumberPrepare;
+                shotIndsPipeline[stage] = shotIndPrepare;
+            };
+            
+            auto finalizeShot = [&](IndexType stage) {
+                SCAI_REGION("WAVE-Simulation.finalizeShot")
+                Common::PhaseTimer outputTimer(Common::Phase::Output);
+                IndexType shotNumberFinalize = shotNumbersPipeline[stage];
+                auto &seismogramHandler = receiversPipeline[stage].getSeismogramHandler();
+                std::vector<std::string> outputFilenames;
+                if (parameters.normalizeTraces == 3) {
+                    seismogramHandler.setFrequencyAGC(parameters.frequencyAGC);
+                    seismogramHandler.calcInverseAGC();
+                    seismogramHandler.write(5, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumberFinalize), modelCoordinates, &outputFilenames);
+                }
+                seismogramHandler.normalize(parameters.normalizeTraces);
+                seismogramHandler.write(parameters.seismogramFormat, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumberFinalize), modelCoordinates, &outputFilenames);
+                receiversPipeline[stage].decode(config, parameters.seismogramFilename, shotNumberFinalize, sourceSettingsEncode, 1);
+                receiversPipeline[stage].writeReceiverMark(config, shotNumberFinalize);
+                shotManifest.recordShot(randInd, shotIndsPipeline[stage], shotNumberFinalize, outputFilenames);
+                shotNumbersPipeline[stage] = -1;
+            };
+            
+            IndexType stage = 0;
+            bool shotsLeft = shotScheduler.getNextShot(shotInd);
+            if (shotsLeft) {
+                prepareShot(stage, shotInd);
+            }
+            while (shotsLeft) {
+                SCAI_REGION("WAVE-Simulation.shotLoop")
+                IndexType nextStage = 1 - stage;
+                shotNumber = shotNumbersPipeline[stage];
+                
+                // the shot scheduler communicates between the shot domains and is therefore only called by the main thread
+                IndexType nextShotInd;
+                bool nextShotLeft = shotScheduler.getNextShot(nextShotInd);
+                std::future<void> helper = std::async(std::launch::async, [&, nextStage, nextShotLeft, nextShotInd]() {
+                    SCAI_DMEMO_TASK(commShot)
+                    if (shotNumbersPipeline[nextStage] >= 0) {
+                        finalizeShot(nextStage);
+                    }
+                    if (nextShotLeft) {
+                        prepareShot(nextStage, nextShotInd);
+                    }
+                });
+                
+                HOST_PRINT(commShot, "Start time stepping for shot number " << shotNumber << " (" << "domain " << shotDomain << ", pipelined)\n", "\nTotal Number of time steps: " << tStepEnd << "\n");
+                start_t = common::Walltime::get();
+                wavefields->resetWavefields();
+                
+                double start_t2 = 0.0, end_t2 = 0.0;
+                lama::DenseVector<ValueType> compensation;
+                if (parameters.useCompensation)
+                    compensation = model->getCompensation(DT, 1);
+                for (IndexType tStep = 0; tStep < tStepEnd; tStep++) {
+                    SCAI_REGION("WAVE-Simulation.timeLoop")
+                    if ((tStep - 1) % 100 == 0) {
+                        start_t2 = common::Walltime::get();
+                    }
+                    
+                    solver->run(receiversPipeline[stage], sourcesPipeline[stage], *model, *wavefields, *derivatives, tStep);
+                    
+                    if (parameters.useCompensation)
+                        *wavefields *= compensation;
+                    
+                    if (tStep % 100 == 0 && tStep != 0) {
+                        end_t2 = common::Walltime::get();
+                        HOST_PRINT(commShot, "", "Calculated " << tStep << " time steps" << " in shot  " << shotNumber << " at t = " << end_t2 - globalStart_t << "\nLast 100 timesteps calculated in " << end_t2 - start_t2 << " sec. - Estimated runtime (Simulation/total): " << (int)((tStepEnd / 100) * (end_t2 - start_t2)) << " / " << (int)((tStepEnd / 100) * (end_t2 - start_t2) + tInit) << " sec.\n\n");
+                    }
+                }
+                solver->resetCPML();
+                end_t = common::Walltime::get();
+                HOST_PRINT(commShot, "Finished time stepping for shot number: " << shotNumber << " in " << end_t - start_t << " sec.\n", "");
+                Common::Profiler::global().addTime(Common::Phase::TimeLoop, end_t - start_t);
+                
+                // exceptions of the helper thread are rethrown here
+                helper.get();
+                solver->getKernelProfiler().printSummary(shotNumber);
+                
+                SCAI_ASSERT_ERROR(commShot->all(wavefields->isFinite(dist)) && commShot->all(receiversPipeline[stage].getSeismogramHandler().isFinite()), "Infinite or NaN value in seismogram or/and velocity wavefield!")
+                
+                stage = nextStage;
+                shotsLeft = nextShotLeft;
+            }
+            // output of the last shot
+            if (shotNumbersPipeline[1 - stage] >= 0) {
+                finalizeShot(1 - stage);
+            }
+        }
+        
+        while (!useBatch && !useShotPipeline && shotScheduler.getNextShot(shotInd)) {
             SCAI_REGION("WAVE-Simulation.shotLoop")
+            Common::PhaseTimer setupTimer(Common::Phase::ShotSetup);
             shotIndTrue = uniqueShotInds[shotInd];
             shotIndIncr = shotIndsIncr[shotInd]; // it is not compatible with useSourceEncode != 0
             
@@ -381,12 +737,12 @@ int main(int argc, const char *argv[])
                 Acquisition::createSettingsForShot(sourceSettingsShot, sourceSettingsEncode, shotNumber);
             }                    
             sources.init(sourceSettingsShot, config, modelCoordinates, ctx, dist);
-            if (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && config.getAndCatch("writeSource", false)) {
+            if (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && parameters.writeSource) {
                 sources.getSeismogramHandler().setShotInd(shotIndTrue, shotIndIncr);
             }
 
             if (!useStreamConfig) {
-                CheckParameter::checkNumericalArtefactsAndInstabilities<ValueType>(config, sourceSettingsShot, *model, modelCoordinates, shotNumber);
+                CheckParameter::checkNumericalArtefactsAndInstabilities<ValueType>(config, sourceSettingsShot, *model, modelCoordinates, shotNumber, &velocityRange);
             } else {
                 HOST_PRINT(commShot, "Shot number " << shotNumber << " (" << "domain " << commInterShot->getRank() << ", index " << shotIndTrue + 1 << " of " << numshots << "): Switch to model subset\n");
                 IndexType shotIndPerShot = shotIndTrue;
@@ -395,8 +751,15 @@ int main(int argc, const char *argv[])
                 }
                 model->getModelPerShot(*modelPerShot, dist, modelCoordinates, modelCoordinatesBig, cutCoordinates.at(shotIndPerShot));
                 modelPerShot->prepareForModelling(modelCoordinates, ctx, dist, commShot); 
-                modelPerShot->write((config.get<std::string>("ModelFilename") + ".shot_" + std::to_string(shotNumber)), config.get<IndexType>("FileFormat"));
-                solver->initForwardSolver(config, *derivatives, *wavefields, *modelPerShot, modelCoordinates, ctx, DT);
+                if (writeModelPerShot) {
+                    modelPerShot->write((config.get<std::string>("ModelFilename") + ".shot_" + std::to_string(shotNumber)), config.get<IndexType>("FileFormat"));
+                }
+                // grid and distribution of the model subsets are the same for all shots, only the material changes
+                // the boundary coefficients only depend on the grid, DT and the boundary parameters of the configuration, so the ones of the first shot are reused for all later shots
+                if (!solverInitializedPerShot) {
+                    solver->initForwardSolver(config, *derivatives, *wavefields, *modelPerShot, modelCoordinates, ctx, DT);
+                    solverInitializedPerShot = true;
+                }
                 solver->prepareForModelling(*modelPerShot, DT);
                 
                 CheckParameter::checkNumericalArtefactsAndInstabilities<ValueType>(config, sourceSettingsShot, *modelPerShot, modelCoordinates, shotNumber);
@@ -407,15 +770,15 @@ int main(int argc, const char *argv[])
                 hilbertHandlerTime.hilbert(sourcesignalHilbert);
                 sources.setsourcesignal(sourcesignalHilbert);
             }
-            if (config.getAndCatch("writeSource", false)) {
+            if (parameters.writeSource) {
                 if (randInd == 1 && decomposition != 0) {
-                    sources.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("writeSourceFilename") + ".shot_" + std::to_string(shotNumber) + ".Hilbert", modelCoordinates);
+                    sources.getSeismogramHandler().write(parameters.seismogramFormat, parameters.writeSourceFilename + ".shot_" + std::to_string(shotNumber) + ".Hilbert", modelCoordinates);
                 } else {
-                    sources.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("writeSourceFilename") + ".shot_" + std::to_string(shotNumber), modelCoordinates);
+                    sources.getSeismogramHandler().write(parameters.seismogramFormat, parameters.writeSourceFilename + ".shot_" + std::to_string(shotNumber), modelCoordinates);
                 }
             }
 
-            if (config.get<IndexType>("useReceiversPerShot") != 0) {
+            if (parameters.useReceiversPerShot) {
                 receivers.init(config, modelCoordinates, ctx, dist, shotNumber, sourceSettingsEncode);
             }
             if (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1 && receivers.getNumTracesGlobal() == numShotPerSuperShot) {
@@ -427,6 +790,7 @@ int main(int argc, const char *argv[])
             } else {
                 HOST_PRINT(commShot, "Start time stepping for shot number " << shotNumber << " (" << "domain " << shotDomain << ", index " << shotIndTrue + 1 << " of " << numshots << ")\n", "\nTotal Number of time steps: " << tStepEnd << "\n");
             }
+            setupTimer.stop();
             
             start_t = common::Walltime::get();
             wavefields->resetWavefields();
@@ -436,10 +800,10 @@ int main(int argc, const char *argv[])
             /* --------------------------------------- */
             /* Loop over time steps                    */
             /* --------------------------------------- */
-            ValueType DTinv = 1 / config.get<ValueType>("DT");
+            ValueType DTinv = parameters.DTinv;
             lama::DenseVector<ValueType> compensation;
             if (!useStreamConfig) {
-                if (config.getAndCatch("compensation", 0))
+                if (parameters.useCompensation)
                     compensation = model->getCompensation(DT, 1);
                 for (IndexType tStep = 0; tStep < tStepEnd; tStep++) {
 
@@ -451,7 +815,7 @@ int main(int argc, const char *argv[])
 
                     solver->run(receivers, sources, *model, *wavefields, *derivatives, tStep);
                     
-                    if (config.getAndCatch("compensation", 0))
+                    if (parameters.useCompensation)
                         *wavefields *= compensation;
                     
                     if (randInd == 0 && decomposition != 0) {
@@ -465,17 +829,17 @@ int main(int argc, const char *argv[])
                         HOST_PRINT(commShot, "", "Calculated " << tStep << " time steps" << " in shot  " << shotNumber << " at t = " << end_t2 - globalStart_t << "\nLast 100 timesteps calculated in " << end_t2 - start_t2 << " sec. - Estimated runtime (Simulation/total): " << (int)((tStepEnd / 100) * (end_t2 - start_t2)) << " / " << (int)((tStepEnd / 100) * (end_t2 - start_t2) + tInit) << " sec.\n\n");
                     }
 
-                    if (snapType > 0 && tStep >= Common::time2index(config.get<ValueType>("tFirstSnapshot"), DT) && tStep <= Common::time2index(config.get<ValueType>("tlastSnapshot"), DT) && (tStep - Common::time2index(config.get<ValueType>("tFirstSnapshot"), DT)) % Common::time2index(config.get<ValueType>("tincSnapshot"), DT) == 0) {
+                    if (parameters.isSnapshot(tStep)) {
                         if (randInd == 1 && decomposition != 0) {
-                            wavefields->write(1, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *model, config.get<IndexType>("FileFormat"));
-                            wavefields->write(2, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *model, config.get<IndexType>("FileFormat"));
+                            wavefields->write(1, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *model, parameters.fileFormat);
+                            wavefields->write(2, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *model, parameters.fileFormat);
                         } else {
-                            wavefields->write(snapType, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber), tStep, *derivatives, *model, config.get<IndexType>("FileFormat"));
+                            wavefields->write(snapType, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber), tStep, *derivatives, *model, parameters.fileFormat);
                         }
                     }
                 }
             } else {                
-                if (config.getAndCatch("compensation", 0))
+                if (parameters.useCompensation)
                     compensation = modelPerShot->getCompensation(DT, 1);
                 for (IndexType tStep = 0; tStep < tStepEnd; tStep++) {
 
@@ -487,7 +851,7 @@ int main(int argc, const char *argv[])
 
                     solver->run(receivers, sources, *modelPerShot, *wavefields, *derivatives, tStep);
                     
-                    if (config.getAndCatch("compensation", 0))
+                    if (parameters.useCompensation)
                         *wavefields *= compensation;
                     
                     if (randInd == 0 && decomposition != 0) {
@@ -501,12 +865,12 @@ int main(int argc, const char *argv[])
                         HOST_PRINT(commShot, "", "Calculated " << tStep << " time steps" << " in shot  " << shotNumber << " at t = " << end_t2 - globalStart_t << "\nLast 100 timesteps calculated in " << end_t2 - start_t2 << " sec. - Estimated runtime (Simulation/total): " << (int)((tStepEnd / 100) * (end_t2 - start_t2)) << " / " << (int)((tStepEnd / 100) * (end_t2 - start_t2) + tInit) << " sec.\n\n");
                     }
 
-                    if (snapType > 0 && tStep >= Common::time2index(config.get<ValueType>("tFirstSnapshot"), DT) && tStep <= Common::time2index(config.get<ValueType>("tlastSnapshot"), DT) && (tStep - Common::time2index(config.get<ValueType>("tFirstSnapshot"), DT)) % Common::time2index(config.get<ValueType>("tincSnapshot"), DT) == 0) {
+                    if (parameters.isSnapshot(tStep)) {
                         if (randInd == 1 && decomposition != 0) {
-                            wavefields->write(1, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *modelPerShot, config.get<IndexType>("FileFormat"));
-                            wavefields->write(2, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *modelPerShot, config.get<IndexType>("FileFormat"));
+                            wavefields->write(1, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *modelPerShot, parameters.fileFormat);
+                            wavefields->write(2, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber) + ".HilbertT", tStep, *derivatives, *modelPerShot, parameters.fileFormat);
                         } else {
-                            wavefields->write(snapType, config.get<std::string>("WavefieldFileName") + ".shot_" + std::to_string(shotNumber), tStep, *derivatives, *modelPerShot, config.get<IndexType>("FileFormat"));
+                            wavefields->write(snapType, parameters.wavefieldFilename + ".shot_" + std::to_string(shotNumber), tStep, *derivatives, *modelPerShot, parameters.fileFormat);
                         }
                     }
                 }
@@ -514,34 +878,43 @@ int main(int argc, const char *argv[])
             solver->resetCPML();
             end_t = common::Walltime::get();
             HOST_PRINT(commShot, "Finished time stepping for shot number: " << shotNumber << " in " << end_t - start_t << " sec.\n", "");
+            solver->getKernelProfiler().printSummary(shotNumber);
+            Common::Profiler::global().addTime(Common::Phase::TimeLoop, end_t - start_t);
             
             // check wavefield and seismogram for NaNs or infinite values
             SCAI_ASSERT_ERROR(commShot->all(wavefields->isFinite(dist)) && commShot->all(receivers.getSeismogramHandler().isFinite()),"Infinite or NaN value in seismogram or/and velocity wavefield!") // if all processors return isfinite=true, everything is finite
             
-            if (config.get<IndexType>("normalizeTraces") == 3) {
-                receivers.getSeismogramHandler().setFrequencyAGC(config.get<ValueType>("CenterFrequencyCPML"));
+            Common::PhaseTimer outputTimer(Common::Phase::Output);
+            std::vector<std::string> outputFilenames;
+            if (parameters.normalizeTraces == 3) {
+                receivers.getSeismogramHandler().setFrequencyAGC(parameters.frequencyAGC);
                 receivers.getSeismogramHandler().calcInverseAGC();
-                receivers.getSeismogramHandler().write(5, config.get<std::string>("SeismogramFilename") + ".shot_" + std::to_string(shotNumber), modelCoordinates);
+                receivers.getSeismogramHandler().write(5, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumber), modelCoordinates, &outputFilenames);
             }
-            receivers.getSeismogramHandler().normalize(config.get<IndexType>("normalizeTraces"));
+            receivers.getSeismogramHandler().normalize(parameters.normalizeTraces);
 
             if (randInd == 1 && decomposition != 0) { 
-                receivers.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("SeismogramFilename") + ".shot_" + std::to_string(shotNumber) + ".Hilbert", modelCoordinates);
+                // the files of the first round are not part of the Hilbert round
+                std::vector<std::string> outputFilenamesHilbert;
+                receivers.getSeismogramHandler().write(parameters.seismogramFormat, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumber) + ".Hilbert", modelCoordinates, &outputFilenamesHilbert);
+                shotManifest.recordShot(randInd, shotInd, shotNumber, outputFilenamesHilbert);
             } else {
-                receivers.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("SeismogramFilename") + ".shot_" + std::to_string(shotNumber), modelCoordinates);
-                receivers.decode(config, config.get<std::string>("SeismogramFilename"), shotNumber, sourceSettingsEncode, 1);
+                receivers.getSeismogramHandler().write(parameters.seismogramFormat, parameters.seismogramFilename + ".shot_" + std::to_string(shotNumber), modelCoordinates, &outputFilenames);
+                receivers.decode(config, parameters.seismogramFilename, shotNumber, sourceSettingsEncode, 1);
                 receivers.writeReceiverMark(config, shotNumber);
+                shotManifest.recordShot(randInd, shotInd, shotNumber, outputFilenames);
             }                
         }
         if (uniqueShotNos.size() == sourceSettings.size() && uniqueShotNos.size() > 1) {
-            if (config.getAndCatch("writeSource", false)) {  
+            Common::PhaseTimer outputTimer(Common::Phase::Output);
+            if (parameters.writeSource) {  
                 sources.getSeismogramHandler().sumShotDomain(commInterShot);
                 if (commInterShot->getRank() == 0) {
                     sources.getSeismogramHandler().assignCOP();
                     if (randInd == 1 && decomposition != 0) {
-                        sources.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("writeSourceFilename") + ".Hilbert", modelCoordinates);
+                        sources.getSeismogramHandler().write(parameters.seismogramFormat, parameters.writeSourceFilename + ".Hilbert", modelCoordinates);
                     } else {
-                        sources.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("writeSourceFilename"), modelCoordinates);
+                        sources.getSeismogramHandler().write(parameters.seismogramFormat, parameters.writeSourceFilename, modelCoordinates);
                     }
                 }
                 start_t = common::Walltime::get();
@@ -552,9 +925,9 @@ int main(int argc, const char *argv[])
                 if (commInterShot->getRank() == 0) {
                     receivers.getSeismogramHandler().assignCOP();
                     if (randInd == 1 && decomposition != 0) { 
-                        receivers.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("SeismogramFilename") + ".Hilbert", modelCoordinates);
+                        receivers.getSeismogramHandler().write(parameters.seismogramFormat, parameters.seismogramFilename + ".Hilbert", modelCoordinates);
                     } else {
-                        receivers.getSeismogramHandler().write(config.get<IndexType>("SeismogramFormat"), config.get<std::string>("SeismogramFilename"), modelCoordinates);
+                        receivers.getSeismogramHandler().write(parameters.seismogramFormat, parameters.seismogramFilename, modelCoordinates);
                     }    
                 }
                 end_t = common::Walltime::get();
@@ -565,10 +938,14 @@ int main(int argc, const char *argv[])
         if (useRandomSource == 0 && decomposition == 0) 
             break;
     }
+    shotScheduler.printUtilisation(commAll);
+    shotScheduler.finish(commAll);
     globalEnd_t = common::Walltime::get();
 
     commAll->synchronize();
 
+    Common::Profiler::global().writeReport(config.getAndCatch("profileReportFilename", std::string("")), commAll, globalEnd_t - globalStart_t);
+
     HOST_PRINT(commAll, "\nTotal runtime of WAVE-Simulation: " << globalEnd_t - globalStart_t << " sec.\nWAVE-Simulation finished!\n\n");
     return 0;
 }
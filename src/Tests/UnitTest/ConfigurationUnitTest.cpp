@@ -1,4 +1,5 @@
 #include "Configuration.hpp"
+#include "SimulationParameters.hpp"
 #include <gtest/gtest.h>
 
 using namespace KITGPI;
@@ -66,3 +67,46 @@ TEST(ConfigurationTest, print)
     Configuration::Configuration config("../src/Tests/Testfiles/configuration_2.txt");
     ASSERT_NO_THROW(config.print());
 }
+
+TEST(ConfigurationTest, SimulationParameters)
+{
+    Configuration::Configuration config;
+    config.add2config("DT", 0.001);
+    config.add2config("T", 0.5);
+    config.add2config("snapType", 1);
+    config.add2config("tFirstSnapshot", 0.1);
+    config.add2config("tlastSnapshot", 0.2);
+    config.add2config("tincSnapshot", 0.05);
+    config.add2config("WavefieldFileName", "wavefields/wavefield");
+    config.add2config("FileFormat", 1);
+    config.add2config("SeismogramFilename", "seismograms/seismogram");
+    config.add2config("SeismogramFormat", 1);
+    config.add2config("normalizeTraces", 0);
+    config.add2config("useReceiversPerShot", 0);
+
+    Configuration::SimulationParameters<double> const parameters(config);
+    ASSERT_EQ(500, parameters.tStepEnd);
+    ASSERT_FALSE(parameters.useCompensation);
+    ASSERT_FALSE(parameters.writeSource);
+    ASSERT_FALSE(parameters.isSnapshot(99));
+    ASSERT_TRUE(parameters.isSnapshot(100));
+    ASSERT_FALSE(parameters.isSnapshot(120));
+    ASSERT_TRUE(parameters.isSnapshot(150));
+    ASSERT_TRUE(parameters.isSnapshot(200));
+    ASSERT_FALSE(parameters.isSnapshot(250));
+
+    // a snapshot interval shorter than DT is clamped to DT
+    config.add2config("tincSnapshot", 0.0, true);
+    Configuration::SimulationParameters<double> const clamped(config);
+    ASSERT_EQ(1, clamped.tStepIncSnapshot);
+    ASSERT_TRUE(clamped.isSnapshot(101));
+
+    // an empty snapshot window writes no snapshots
+    config.add2config("tFirstSnapshot", 0.3, true);
+    Configuration::SimulationParameters<double> const empty(config);
+    ASSERT_FALSE(empty.isSnapshot(200));
+    ASSERT_FALSE(empty.isSnapshot(300));
+
+    config.add2config("DT", 0.0, true);
+    ASSERT_ANY_THROW(Configuration::SimulationParameters<double> invalid(config));
+}
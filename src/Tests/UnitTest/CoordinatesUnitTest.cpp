@@ -128,3 +128,62 @@ TEST(CoordinateTest, TestEstimateDistanceToEdges3D)
     EXPECT_EQ(solutionDistance.y, result.y);
     EXPECT_EQ(solutionDistance.z, result.z);
 }
+
+TEST(CoordinateTest, TestBatchedConversionVariableGrid)
+{
+    // Grid with a fine layer on top of a coarse layer
+    IndexType NX = 10;
+    IndexType NY = 20;
+    IndexType NZ = 1;
+    ValueType DH = 1.0;
+    std::vector<IndexType> dhFactor = {1, 3};
+    std::vector<int> interface = {9};
+
+    Acquisition::Coordinates<ValueType> test(NX, NY, NZ, DH, dhFactor, interface);
+
+    // all gridpoints (consecutive indices) and every third gridpoint
+    for (IndexType step = 1; step <= 3; step += 2) {
+        IndexType numIndexes = (test.getNGridpoints() + step - 1) / step;
+        hmemo::HArray<IndexType> indexes(numIndexes);
+        {
+            auto write_indexes = hmemo::hostWriteAccess(indexes);
+            for (IndexType i = 0; i < numIndexes; i++) {
+                write_indexes[i] = i * step;
+            }
+        }
+
+        std::vector<Acquisition::coordinate3D> coordinates = test.index2coordinate(indexes);
+        hmemo::HArray<IndexType> result = test.coordinate2index(coordinates);
+
+        auto read_result = hmemo::hostReadAccess(result);
+        for (IndexType i = 0; i < numIndexes; i++) {
+            EXPECT_EQ(test.index2coordinate(i * step), coordinates[i]);
+            EXPECT_EQ(i * step, read_result[i]);
+        }
+    }
+}
+
+TEST(CoordinateTest, TestLayerRangesVariableGrid)
+{
+    IndexType NX = 10;
+    IndexType NY = 20;
+    IndexType NZ = 1;
+    ValueType DH = 1.0;
+    std::vector<IndexType> dhFactor = {1, 3};
+    std::vector<int> interface = {9};
+
+    Acquisition::Coordinates<ValueType> test(NX, NY, NZ, DH, dhFactor, interface);
+
+    std::vector<IndexType> rangeStart;
+    std::vector<IndexType> rangeLayer;
+    test.getLayerRanges(rangeStart, rangeLayer);
+
+    ASSERT_EQ(rangeStart.size(), rangeLayer.size() + 1);
+    EXPECT_EQ(0, rangeStart.front());
+    EXPECT_EQ(test.getNGridpoints(), rangeStart.back());
+    for (IndexType range = 0; range < IndexType(rangeLayer.size()); range++) {
+        for (IndexType index = rangeStart[range]; index < rangeStart[range + 1]; index++) {
+            EXPECT_EQ(test.getLayer(test.index2coordinate(index)), rangeLayer[range]);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include <scai/dmemo.hpp>
+#include <scai/lama.hpp>
+#include <scai/lama/DenseVector.hpp>
+
+#include "Configuration.hpp"
+#include "Coordinates.hpp"
+#include "Derivatives/FDTD3D.hpp"
+#include "TestHelper.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace scai;
+using namespace KITGPI;
+using namespace TestHelper;
+
+typedef double ValueType;
+
+namespace
+{
+    //! \brief Exposes the row assembly of the derivative matrices
+    class RowAssemblyTest : public ForwardSolver::Derivatives::FDTD3D<ValueType>
+    {
+      public:
+        using RowAssembly = ForwardSolver::Derivatives::FDTD3D<ValueType>::RowAssembly;
+    };
+
+    //! \brief Expect that two matrices have identical local CSR storages
+    void expectEqualCSR(lama::Matrix<ValueType> const &matrix1, lama::Matrix<ValueType> const &matrix2)
+    {
+        auto const &storage1 = dynamic_cast<lama::CSRSparseMatrix<ValueType> const &>(matrix1).getLocalStorage();
+        auto const &storage2 = dynamic_cast<lama::CSRSparseMatrix<ValueType> const &>(matrix2).getLocalStorage();
+        ASSERT_EQ(storage1.getNumRows(), storage2.getNumRows());
+        ASSERT_EQ(storage1.getNumValues(), storage2.getNumValues());
+
+        auto read_ia1 = hmemo::hostReadAccess(storage1.getIA());
+        auto read_ia2 = hmemo::hostReadAccess(storage2.getIA());
+        for (IndexType i = 0; i <= storage1.getNumRows(); i++) {
+            ASSERT_EQ(read_ia1[i], read_ia2[i]) << "row offset " << i;
+        }
+        auto read_ja1 = hmemo::hostReadAccess(storage1.getJA());
+        auto read_ja2 = hmemo::hostReadAccess(storage2.getJA());
+        auto read_values1 = hmemo::hostReadAccess(storage1.getValues());
+        auto read_values2 = hmemo::hostReadAccess(storage2.getValues());
+        for (IndexType k = 0; k < storage1.getNumValues(); k++) {
+            ASSERT_EQ(read_ja1[k], read_ja2[k]) << "entry " << k;
+            ASSERT_EQ(read_values1[k], read_values2[k]) << "entry " << k;
+        }
+    }
+}
+
+TEST(DerivativesTest, ConvertedMatricesEqualCSR)
+{
+    Acquisition::Coordinates<ValueType> modelCoordinates(12, 10, 8, 1.0);
+    auto comm = dmemo::Communicator::getCommunicatorPtr();
+    auto dist = dmemo::blockDistribution(modelCoordinates.getNGridpoints(), comm);
+    hmemo::ContextPtr ctx = hmemo::Context::getContextPtr();
+    auto x = testVector<ValueType>(dist);
+
+    ForwardSolver::Derivatives::FDTD3D<ValueType> reference;
+    reference.setup(derivativeConfig("CSR"));
+    reference.init(dist, ctx, modelCoordinates, comm);
+    auto const &referenceMatrices = reference;
+
+    for (std::string format : {"ELL", "JDS"}) {
+        ForwardSolver::Derivatives::FDTD3D<ValueType> derivatives;
+        derivatives.setup(derivativeConfig(format));
+        derivatives.init(dist, ctx, modelCoordinates, comm);
+        auto const &matrices = derivatives; // the public getters are const
+
+        std::vector<std::pair<lama::Matrix<ValueType> const *, lama::Matrix<ValueType> const *>> pairs = {{&referenceMatrices.getDxf(), &matrices.getDxf()}, {&referenceMatrices.getDyf(), &matrices.getDyf()}, {&referenceMatrices.getDzf(), &matrices.getDzf()}, {&referenceMatrices.getDxb(), &matrices.getDxb()}, {&referenceMatrices.getDyb(), &matrices.getDyb()}, {&referenceMatrices.getDzb(), &matrices.getDzb()}};
+        for (auto const &pair : pairs) {
+            EXPECT_EQ(lama::Format::CSR, pair.first->getFormat());
+            EXPECT_EQ(format == "ELL" ? lama::Format::ELL : lama::Format::JDS, pair.second->getFormat());
+
+            lama::DenseVector<ValueType> yReference;
+            yReference = *pair.first * x;
+            lama::DenseVector<ValueType> y;
+            y = *pair.second * x;
+            lama::DenseVector<ValueType> difference;
+            difference = yReference - y;
+            EXPECT_LT(difference.maxNorm(), 1e-12 * yReference.maxNorm()) << format;
+        }
+    }
+}
+
+TEST(DerivativesTest, FinishedRowsEqualMatrixAssembly)
+{
+    IndexType numRows = 4;
+    // unsorted rows with duplicate columns and an empty row
+    std::vector<std::vector<std::pair<IndexType, ValueType>>> rows = {{{3, 1.0}, {1, 2.0}, {3, 4.0}, {0, 5.0}}, {{2, 1.5}}, {{1, 1.0}, {1, 2.0}, {1, 3.0}}, {}};
+
+    RowAssemblyTest::RowAssembly rowAssembly;
+    lama::MatrixAssembly<ValueType> assembly;
+    for (IndexType row = 0; row < numRows; row++) {
+        IndexType rowStart = rowAssembly.columns.size();
+        for (auto const &entry : rows[row]) {
+            rowAssembly.push(row, entry.first, entry.second);
+            assembly.push(row, entry.first, entry.second);
+        }
+        rowAssembly.finishRow(rowStart);
+    }
+
+    auto dist = dmemo::blockDistribution(numRows, dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO));
+    lama::CSRSparseMatrix<ValueType> reference;
+    reference.allocate(dist, dist);
+    reference.fillFromAssembly(assembly);
+
+    ASSERT_EQ(std::size_t(numRows), rowAssembly.rowLengths.size());
+    IndexType position = 0;
+    for (IndexType row = 0; row < numRows; row++) {
+        std::vector<ValueType> rowValues(numRows, 0.0);
+        for (IndexType k = position; k < position + rowAssembly.rowLengths[row]; k++) {
+            if (k > position) {
+                EXPECT_LT(rowAssembly.columns[k - 1], rowAssembly.columns[k]) << "columns of row " << row << " are not sorted and unique";
+            }
+            rowValues[rowAssembly.columns[k]] = rowAssembly.values[k];
+        }
+        position += rowAssembly.rowLengths[row];
+        for (IndexType column = 0; column < numRows; column++) {
+            EXPECT_EQ(reference.getValue(row, column), rowValues[column]) << "row " << row << ", column " << column;
+        }
+    }
+    EXPECT_EQ(std::size_t(position), rowAssembly.columns.size());
+}
+
+TEST(DerivativesTest, ThreadedAssemblyEqualsSerial)
+{
+    // at least minAssemblyRows rows per thread
+    Acquisition::Coordinates<ValueType> modelCoordinates(40, 36, 30, 1.0);
+    auto comm = dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO);
+    auto dist = dmemo::blockDistribution(modelCoordinates.getNGridpoints(), comm);
+    hmemo::ContextPtr ctx = hmemo::Context::getContextPtr();
+
+    ForwardSolver::Derivatives::FDTD3D<ValueType> serial;
+    serial.setup(derivativeConfig("CSR", 1, 1));
+    serial.init(dist, ctx, modelCoordinates, comm);
+    auto const &serialMatrices = serial;
+
+    ForwardSolver::Derivatives::FDTD3D<ValueType> threaded;
+    threaded.setup(derivativeConfig("CSR", 1, 4));
+    threaded.init(dist, ctx, modelCoordinates, comm);
+    auto const &threadedMatrices = threaded;
+
+    expectEqualCSR(serialMatrices.getDxf(), threadedMatrices.getDxf());
+    expectEqualCSR(serialMatrices.getDzf(), threadedMatrices.getDzf());
+    expectEqualCSR(serialMatrices.getDxb(), threadedMatrices.getDxb());
+    expectEqualCSR(serialMatrices.getDyb(), threadedMatrices.getDyb());
+    expectEqualCSR(serialMatrices.getDzb(), threadedMatrices.getDzb());
+    expectEqualCSR(serialMatrices.getDyfFreeSurface(), threadedMatrices.getDyfFreeSurface());
+}
@@ -0,0 +1,138 @@
+#include <scai/dmemo.hpp>
+#include <scai/lama.hpp>
+#include <scai/lama/DenseVector.hpp>
+
+#include "../../Partitioning/Partitioning.hpp"
+#include "Configuration.hpp"
+#include "Coordinates.hpp"
+#include "Derivatives/FDTD3D.hpp"
+#include "TestHelper.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace scai;
+using namespace KITGPI;
+using namespace TestHelper;
+
+typedef double ValueType;
+
+namespace
+{
+    //! \brief Apply Dxf, Dyf and Dzf to a test vector and return the sum of the results in the block distribution
+    lama::DenseVector<ValueType> applyDerivatives(dmemo::DistributionPtr dist, Acquisition::Coordinates<ValueType> const &modelCoordinates)
+    {
+        hmemo::ContextPtr ctx = hmemo::Context::getContextPtr();
+        ForwardSolver::Derivatives::FDTD3D<ValueType> derivatives;
+        derivatives.setup(derivativeConfig());
+        derivatives.init(dist, ctx, modelCoordinates, dist->getCommunicatorPtr());
+        auto const &matrices = derivatives; // the public getters are const
+
+        auto x = testVector<ValueType>(dmemo::blockDistribution(dist->getGlobalSize(), dist->getCommunicatorPtr()));
+        x.redistribute(dist);
+
+        lama::DenseVector<ValueType> y;
+        y = matrices.getDxf() * x;
+        lama::DenseVector<ValueType> temp;
+        temp = matrices.getDyf() * x;
+        y += temp;
+        temp = matrices.getDzf() * x;
+        y += temp;
+
+        y.redistribute(dmemo::blockDistribution(dist->getGlobalSize(), dist->getCommunicatorPtr()));
+        return (y);
+    }
+}
+
+TEST(PartitioningTest, MortonRenumberingKeepsOwnership)
+{
+    Acquisition::Coordinates<ValueType> modelCoordinates(12, 10, 8, 1.0);
+    auto comm = dmemo::Communicator::getCommunicatorPtr();
+    auto dist = dmemo::blockDistribution(modelCoordinates.getNGridpoints(), comm);
+
+    auto mortonDist = Partitioning::mortonRenumbering(dist, modelCoordinates);
+
+    ASSERT_EQ(dist->getGlobalSize(), mortonDist->getGlobalSize());
+    ASSERT_EQ(dist->getLocalSize(), mortonDist->getLocalSize());
+    IndexType numReordered = 0;
+    for (IndexType i = 0; i < dist->getLocalSize(); i++) {
+        IndexType globalIndex = dist->local2Global(i);
+        EXPECT_TRUE(mortonDist->isLocal(globalIndex));
+        if (mortonDist->global2Local(globalIndex) != i) {
+            numReordered++;
+        }
+    }
+    // the x-fastest order of a 3D grid is not a Morton curve
+    EXPECT_GT(comm->sum(numReordered), 0);
+}
+
+TEST(PartitioningTest, MortonRenumberingKeepsMatrixVectorProducts)
+{
+    Acquisition::Coordinates<ValueType> modelCoordinates(12, 10, 8, 1.0);
+    auto comm = dmemo::Communicator::getCommunicatorPtr();
+    auto dist = dmemo::blockDistribution(modelCoordinates.getNGridpoints(), comm);
+
+    auto reference = applyDerivatives(dist, modelCoordinates);
+    auto renumbered = applyDerivatives(Partitioning::mortonRenumbering(dist, modelCoordinates), modelCoordinates);
+
+    lama::DenseVector<ValueType> difference;
+    difference = reference - renumbered;
+    EXPECT_LT(difference.maxNorm(), 1e-10 * reference.maxNorm());
+}
+
+TEST(PartitioningTest, NoMortonRenumberingOfSingleProcessShotDomains)
+{
+    Configuration::Configuration config;
+    config.add2config("partitioning", 2);
+    config.add2config("localRenumbering", 1);
+
+    // the batched modelling uses the global index as local index, so the result with and without localRenumbering only agrees if a single process is not renumbered
+    auto commSingle = dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO);
+    EXPECT_FALSE(Partitioning::useMortonRenumbering(config, commSingle));
+
+    config.add2config("localRenumbering", 0, true);
+    EXPECT_FALSE(Partitioning::useMortonRenumbering(config, dmemo::Communicator::getCommunicatorPtr()));
+}
+
+TEST(PartitioningTest, RcbBalancesNonPowerOfTwoParts)
+{
+    Acquisition::Coordinates<ValueType> modelCoordinates(30, 20, 12, 1.0);
+    auto comm = dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO);
+    IndexType numGridpoints = modelCoordinates.getNGridpoints();
+
+    // heavier gridpoints in a corner of the model, e.g. a boundary
+    lama::DenseVector<ValueType> weights(dmemo::blockDistribution(numGridpoints, comm), 1.0);
+    ValueType maxWeight = 0.0;
+    {
+        auto write_weights = hmemo::hostWriteAccess(weights.getLocalValues());
+        for (IndexType i = 0; i < numGridpoints; i++) {
+            Acquisition::coordinate3D coordinate = modelCoordinates.index2coordinate(i);
+            if (coordinate.x < 5 || coordinate.y < 3) {
+                write_weights[i] = 2.5;
+            }
+            maxWeight = std::max(maxWeight, write_weights[i]);
+        }
+    }
+    ValueType sumWeights = weights.sum();
+
+    for (IndexType numParts : {3, 5, 6, 7, 12}) {
+        auto owners = Partitioning::rcbOwners(comm, numParts, weights, modelCoordinates);
+        ASSERT_EQ(numGridpoints, owners.size());
+
+        std::vector<ValueType> partWeights(numParts, 0.0);
+        {
+            auto read_owners = hmemo::hostReadAccess(owners);
+            auto read_weights = hmemo::hostReadAccess(weights.getLocalValues());
+            for (IndexType i = 0; i < numGridpoints; i++) {
+                ASSERT_GE(read_owners[i], 0);
+                ASSERT_LT(read_owners[i], numParts);
+                partWeights[read_owners[i]] += read_weights[i];
+            }
+        }
+
+        // every level of the bisection may miss its target by one gridpoint
+        IndexType numLevels = std::ceil(std::log2(double(numParts)));
+        for (IndexType part = 0; part < numParts; part++) {
+            EXPECT_NEAR(sumWeights / numParts, partWeights[part], numLevels * maxWeight) << "numParts = " << numParts << ", part = " << part;
+        }
+    }
+}
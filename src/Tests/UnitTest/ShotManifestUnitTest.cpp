@@ -0,0 +1,75 @@
+#include <scai/dmemo.hpp>
+
+#include "../../Common/ShotManifest.hpp"
+#include "Configuration.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace scai;
+using namespace KITGPI;
+
+namespace
+{
+    std::string const manifestFilename = "ShotManifestUnitTest.manifest";
+    std::string const outputPrefix = "ShotManifestUnitTest.seismogram.shot_";
+
+    //! \brief Name of the output file of a shot
+    std::string outputFilename(IndexType shotNumber)
+    {
+        return (outputPrefix + std::to_string(shotNumber) + ".p.mtx");
+    }
+
+    //! \brief Write the output file of a shot
+    void writeOutput(IndexType shotNumber, std::string const &content)
+    {
+        std::ofstream output(outputFilename(shotNumber));
+        output << content;
+    }
+
+    //! \brief Read the manifest and return the finished shots of round 0
+    std::vector<IndexType> completedShots(Common::ShotManifest &manifest)
+    {
+        Configuration::Configuration config;
+        config.add2config("shotManifestFilename", manifestFilename);
+        auto comm = dmemo::Communicator::getCommunicatorPtr(dmemo::CommunicatorType::NO);
+        manifest.init(config, comm, comm);
+        return (manifest.getCompletedShots(0));
+    }
+}
+
+TEST(ShotManifestTest, RecoveryAfterTruncatedLine)
+{
+    std::remove(manifestFilename.c_str());
+    Common::ShotManifest manifest;
+    ASSERT_TRUE(completedShots(manifest).empty());
+
+    for (IndexType shotInd = 0; shotInd < 3; shotInd++) {
+        writeOutput(shotInd + 1, "seismogram of shot " + std::to_string(shotInd + 1));
+        manifest.recordShot(0, shotInd, shotInd + 1, {outputFilename(shotInd + 1)});
+    }
+    EXPECT_EQ(std::vector<IndexType>({0, 1, 2}), completedShots(manifest));
+
+    // crash while the entry of shot index 3 is written: only a part of the line without newline is in the manifest
+    writeOutput(4, "seismogram of shot 4");
+    {
+        std::ofstream manifestFile(manifestFilename, std::ios::app);
+        manifestFile << "shot\t0\t3\t4\t1\t" << outputFilename(4) << "\t2";
+    }
+    EXPECT_EQ(std::vector<IndexType>({0, 1, 2}), completedShots(manifest));
+
+    // the restarted run computes shot index 3 again, its entry must not be lost behind the truncated line
+    manifest.recordShot(0, 3, 4, {outputFilename(4)});
+    EXPECT_EQ(std::vector<IndexType>({0, 1, 2, 3}), completedShots(manifest));
+
+    // a modified output file invalidates the entry of its shot
+    writeOutput(2, "modified seismogram of shot 2");
+    EXPECT_EQ(std::vector<IndexType>({0, 2, 3}), completedShots(manifest));
+
+    std::remove(manifestFilename.c_str());
+    for (IndexType shotNumber = 1; shotNumber <= 4; shotNumber++) {
+        std::remove(outputFilename(shotNumber).c_str());
+    }
+}
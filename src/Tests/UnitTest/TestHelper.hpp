@@ -0,0 +1,54 @@
+#pragma once
+
+#include <scai/dmemo.hpp>
+#include <scai/lama.hpp>
+#include <scai/lama/DenseVector.hpp>
+
+#include "Configuration.hpp"
+#include <cmath>
+#include <string>
+
+//! \brief Fixtures which are shared by several unit tests
+namespace TestHelper
+{
+    using namespace scai;
+    using namespace KITGPI;
+
+    /*! \brief Configuration of constant grid derivative matrices in sparse format
+     *
+     \param sparseFormat Sparse format of the derivative matrices
+     \param useFreeSurface FreeSurface of the configuration
+     \param numAssemblyThreads Number of threads of the matrix assembly, 0 = default
+     */
+    inline Configuration::Configuration derivativeConfig(std::string const &sparseFormat = "CSR", IndexType useFreeSurface = 0, IndexType numAssemblyThreads = 0)
+    {
+        Configuration::Configuration config;
+        config.add2config("equationType", "acoustic");
+        config.add2config("FreeSurface", useFreeSurface);
+        config.add2config("useVariableGrid", 0);
+        config.add2config("useVariableFDoperators", 0);
+        config.add2config("spatialFDorder", 4);
+        config.add2config("partitioning", 2);
+        config.add2config("DT", 0.001);
+        config.add2config("sparseFormat", sparseFormat);
+        config.add2config("numAssemblyThreads", numAssemblyThreads);
+        return (config);
+    }
+
+    /*! \brief Test vector with different values at all gridpoints
+     *
+     \param dist Distribution of the vector
+     */
+    template <typename ValueType>
+    lama::DenseVector<ValueType> testVector(dmemo::DistributionPtr dist)
+    {
+        lama::DenseVector<ValueType> x(dist, 0.0);
+        {
+            auto write_x = hmemo::hostWriteAccess(x.getLocalValues());
+            for (IndexType i = 0; i < dist->getLocalSize(); i++) {
+                write_x[i] = std::sin(0.1 * dist->local2Global(i)) + 0.01 * (i % 7);
+            }
+        }
+        return (x);
+    }
+}
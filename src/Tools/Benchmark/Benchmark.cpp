@@ -0,0 +1,410 @@
+#include <scai/common/Settings.hpp>
+#include <scai/common/Walltime.hpp>
+#include <scai/dmemo.hpp>
+#include <scai/lama.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../../Acquisition/Receivers.hpp"
+#include "../../Acquisition/Sources.hpp"
+#include "../../CheckParameter/CheckParameter.hpp"
+#include "../../Common/HostPrint.hpp"
+#include "../../Configuration/Configuration.hpp"
+#include "../../ForwardSolver/Derivatives/DerivativesFactory.hpp"
+#include "../../ForwardSolver/ForwardSolverFactory.hpp"
+#include "../../Modelparameter/ModelparameterFactory.hpp"
+#include "../../Partitioning/Partitioning.hpp"
+#include "../../Wavefields/WavefieldsFactory.hpp"
+#include "Configuration/ValueType.hpp"
+
+using namespace KITGPI;
+using namespace scai;
+
+extern bool verbose; // global variable definition
+
+//! \brief Runtime and modelled work of one benchmark case
+struct BenchmarkResult {
+    std::string dimension;      //!< 2D or 3D
+    std::string equationType;   //!< equation type
+    std::string modelType;      //!< homogeneous or layered
+    IndexType gridSize = 0;     //!< number of gridpoints per dimension
+    IndexType spatialFDorder = 0;
+    IndexType numThreads = 0;   //!< number of threads per process
+    IndexType numGridpoints = 0;
+    double timePerStep = 0;     //!< runtime per time step in seconds (maximum over all processes)
+    double bytesPerStep = 0;    //!< modelled bytes per time step of all processes
+    double flopsPerStep = 0;    //!< modelled floating point operations per time step of all processes
+    double streamBandwidth = 0; //!< STREAM triad bandwidth of all processes in GB/s
+};
+
+/*! \brief Read a comma separated list from the configuration
+ *
+ \param config Configuration
+ \param key Key of the list
+ \param defaultList List which is used if the key is not set
+ */
+template <typename T>
+std::vector<T> getList(Configuration::Configuration const &config, std::string const &key, std::string const &defaultList)
+{
+    std::istringstream list(config.getAndCatch(key, defaultList));
+    std::vector<T> values;
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        std::istringstream itemStream(item);
+        T value;
+        if (itemStream >> value) {
+            values.push_back(value);
+        }
+    }
+    SCAI_ASSERT_ERROR(!values.empty(), "No values given for " << key);
+    return values;
+}
+
+/*! \brief Memory bandwidth of the STREAM triad a = b + s * c in GB/s
+ *
+ * The arrays are initialized by the threads which use them (first touch). The best of several repetitions is taken,
+ * all processes run the triad at the same time and the bandwidth is summed over the processes.
+ \param size Number of values per array and process
+ \param comm Communicator of all processes
+ */
+double measureStreamBandwidth(IndexType size, dmemo::CommunicatorPtr comm)
+{
+    std::unique_ptr<double[]> a(new double[size]);
+    std::unique_ptr<double[]> b(new double[size]);
+    std::unique_ptr<double[]> c(new double[size]);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (IndexType i = 0; i < size; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    double const scalar = 3.0;
+    IndexType const numRepetitions = 10;
+    double bestTime = std::numeric_limits<double>::max();
+    for (IndexType repetition = 0; repetition < numRepetitions; repetition++) {
+        comm->synchronize();
+        double start_t = common::Walltime::get();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (IndexType i = 0; i < size; i++) {
+            a[i] = b[i] + scalar * c[i];
+        }
+        bestTime = std::min(bestTime, comm->max(common::Walltime::get() - start_t));
+    }
+    // the result is used, so the triad cannot be removed by the compiler
+    SCAI_ASSERT_ERROR(a[size / 2] == 1.0 + scalar * 2.0, "STREAM triad failed");
+
+    // STREAM convention: two loads and one store per value, the write allocate is not counted
+    return (comm->sum(3.0 * sizeof(double) * size) / bestTime * 1e-9);
+}
+
+/*! \brief Source and receiver type which is recorded by every equation type
+ *
+ \param dimension 2D or 3D
+ \param equationType equation type
+ */
+IndexType getAcquisitionType(std::string const &dimension, std::string const &equationType)
+{
+    if (equationType.compare("sh") == 0 || equationType.compare("viscosh") == 0) {
+        return (4); // VZ
+    }
+    if (dimension.compare("2d") == 0 && (equationType.compare("emem") == 0 || equationType.compare("viscoemem") == 0)) {
+        return (2); // EX
+    }
+    return (1); // P or EZ
+}
+
+/*! \brief Time the forward solver for one case
+ *
+ * The model is generated on the fly from the configuration (ModelRead=0). For the layered model the velocities and the density
+ * (electromagnetic modelling: the conductivity and the permittivity) of the lower half of the model are multiplied by benchLayerContrast.
+ * DT is set to half of the stability limit of the fastest velocity and the source is a Ricker wavelet with 40 time steps per period,
+ * so the wavefields stay finite during the benchmark.
+ \param config Configuration, the parameters of the case are overwritten in this copy
+ \param comm Communicator of all processes
+ \param ctx Context
+ \param result Parameters of the case, the runtime and the modelled work are added
+ */
+void runCase(Configuration::Configuration config, dmemo::CommunicatorPtr comm, hmemo::ContextPtr ctx, BenchmarkResult &result)
+{
+    std::string const &dimension = result.dimension;
+    std::string const &equationType = result.equationType;
+    bool isSeismic = Common::checkEquationType<ValueType>(equationType);
+    bool isVisco = (equationType.compare(0, 5, "visco") == 0);
+    IndexType numWarmupSteps = config.getAndCatch("benchWarmupSteps", IndexType(10));
+    IndexType numSteps = config.getAndCatch("benchTimeSteps", IndexType(100));
+    ValueType layerContrast = config.getAndCatch("benchLayerContrast", ValueType(1.5));
+    IndexType numRelaxationMechanisms = isVisco ? std::max(IndexType(1), config.getAndCatch("numRelaxationMechanisms", IndexType(1))) : 0;
+
+    config.add2config("dimension", dimension, true);
+    config.add2config("equationType", equationType, true);
+    config.add2config("NX", result.gridSize, true);
+    config.add2config("NY", result.gridSize, true);
+    config.add2config("NZ", dimension.compare("3d") == 0 ? result.gridSize : 1, true);
+    config.add2config("spatialFDorder", result.spatialFDorder, true);
+    config.add2config("numRelaxationMechanisms", numRelaxationMechanisms, true);
+
+    Acquisition::Coordinates<ValueType> modelCoordinates(config);
+    dmemo::DistributionPtr dist = nullptr;
+    if (config.get<IndexType>("partitioning") == 1) {
+        dist = Partitioning::gridPartition<ValueType>(config, comm);
+    } else {
+        dist = std::make_shared<dmemo::BlockDistribution>(modelCoordinates.getNGridpoints(), comm);
+    }
+
+    ForwardSolver::Derivatives::Derivatives<ValueType>::DerivativesPtr derivatives(ForwardSolver::Derivatives::Factory<ValueType>::Create(dimension));
+    Modelparameter::Modelparameter<ValueType>::ModelparameterPtr model(Modelparameter::Factory<ValueType>::Create(equationType));
+    Wavefields::Wavefields<ValueType>::WavefieldPtr wavefields(Wavefields::Factory<ValueType>::Create(dimension, equationType));
+    ForwardSolver::ForwardSolver<ValueType>::ForwardSolverPtr solver(ForwardSolver::Factory<ValueType>::Create(dimension, equationType));
+
+    derivatives->init(dist, ctx, config, modelCoordinates, comm);
+    wavefields->init(ctx, dist, numRelaxationMechanisms);
+    model->init(config, ctx, dist, modelCoordinates);
+
+    if (result.modelType.compare("layered") == 0) {
+        lama::DenseVector<ValueType> layer(dist, 1.0, ctx);
+        {
+            hmemo::HArray<IndexType> ownedIndexes;
+            dist->getOwnedIndexes(ownedIndexes);
+            auto read_ownedIndexes = hmemo::hostReadAccess(ownedIndexes);
+            auto write_layer = hmemo::hostWriteAccess(layer.getLocalValues());
+            for (IndexType localIndex = 0; localIndex < dist->getLocalSize(); localIndex++) {
+                if (modelCoordinates.index2coordinate(read_ownedIndexes[localIndex]).y >= modelCoordinates.getNY() / 2) {
+                    write_layer[localIndex] = layerContrast;
+                }
+            }
+        }
+        auto scaleLowerLayer = [&layer](lama::Vector<ValueType> const &parameter) {
+            lama::DenseVector<ValueType> scaled;
+            scaled = parameter;
+            scaled *= layer;
+            return scaled;
+        };
+        if (isSeismic) {
+            model->setDensity(scaleLowerLayer(model->getDensity()));
+            if (equationType.compare("sh") != 0 && equationType.compare("viscosh") != 0) {
+                model->setVelocityP(scaleLowerLayer(model->getVelocityP()));
+            }
+            if (equationType.compare("acoustic") != 0) {
+                model->setVelocityS(scaleLowerLayer(model->getVelocityS()));
+            }
+        } else {
+            model->setElectricConductivity(scaleLowerLayer(model->getElectricConductivity()));
+            model->setDielectricPermittivity(scaleLowerLayer(model->getDielectricPermittivity()));
+        }
+    }
+
+    CheckParameter::VelocityRange<ValueType> velocityRange;
+    CheckParameter::calcVelocityRange(velocityRange, equationType, *model, modelCoordinates);
+    ValueType vMax = *std::max_element(velocityRange.vMax.begin(), velocityRange.vMax.end());
+    ValueType DH = config.get<ValueType>("DH");
+    IndexType numDimensions = (dimension.compare("3d") == 0) ? 3 : 2;
+    ValueType DT = 0.5 * DH / (std::sqrt(ValueType(numDimensions)) * vMax);
+    ValueType fc = 1.0 / (40 * DT);
+
+    config.add2config("DT", DT, true);
+    config.add2config("T", (numWarmupSteps + numSteps) * DT, true);
+    config.add2config("seismoDT", DT, true);
+    config.add2config("VMaxCPML", vMax, true);
+    config.add2config("CenterFrequencyCPML", fc, true);
+
+    solver->initForwardSolver(config, *derivatives, *wavefields, *model, modelCoordinates, ctx, DT);
+    solver->getKernelProfiler().init(config, dist, modelCoordinates);
+    model->prepareForModelling(modelCoordinates, ctx, dist, comm);
+    solver->prepareForModelling(*model, DT);
+
+    IndexType acquisitionType = getAcquisitionType(dimension, equationType);
+    Acquisition::coordinate3D center;
+    center.x = modelCoordinates.getNX() / 2;
+    center.y = modelCoordinates.getNY() / 4;
+    center.z = modelCoordinates.getNZ() / 2;
+
+    Acquisition::sourceSettings<ValueType> source;
+    source.sourceNo = 1;
+    source.sourceCoords = center;
+    source.sourceType = acquisitionType;
+    source.waveletType = 1;
+    source.waveletShape = 1;
+    source.fc = fc;
+    source.amp = 1;
+    source.tShift = 0;
+    source.row = 0;
+    Acquisition::Sources<ValueType> sources;
+    sources.init(std::vector<Acquisition::sourceSettings<ValueType>>{source}, config, modelCoordinates, ctx, dist);
+
+    Acquisition::receiverSettings receiver;
+    receiver.receiverCoords = center;
+    receiver.receiverCoords.y = 3 * modelCoordinates.getNY() / 4;
+    receiver.receiverType = acquisitionType;
+    Acquisition::Receivers<ValueType> receivers;
+    receivers.init(std::vector<Acquisition::receiverSettings>{receiver}, config, modelCoordinates, ctx, dist);
+
+    wavefields->resetWavefields();
+    for (IndexType tStep = 0; tStep < numWarmupSteps; tStep++) {
+        solver->run(receivers, sources, *model, *wavefields, *derivatives, tStep);
+    }
+    comm->synchronize();
+    double start_t = common::Walltime::get();
+    for (IndexType tStep = numWarmupSteps; tStep < numWarmupSteps + numSteps; tStep++) {
+        solver->run(receivers, sources, *model, *wavefields, *derivatives, tStep);
+    }
+    double time = comm->max(common::Walltime::get() - start_t);
+
+    result.numGridpoints = modelCoordinates.getNGridpoints();
+    result.timePerStep = time / numSteps;
+    result.bytesPerStep = comm->sum(solver->getKernelProfiler().getBytesPerStep());
+    result.flopsPerStep = comm->sum(solver->getKernelProfiler().getFlopsPerStep());
+}
+
+/*------------------------------
+     Benchmark - Forward solver
+     Times the forward solver for synthetic models of all
+     dimensions and equation types and compares the modelled
+     bandwidth with the STREAM triad (roofline)
+-------------------------------*/
+int main(int argc, const char *argv[])
+{
+    common::Settings::parseArgs(argc, argv);
+
+    if (argc != 2) {
+        std::cout << "\n\nNo configuration file given!\n\n"
+                  << std::endl;
+        return (2);
+    }
+
+    Configuration::Configuration config(argv[1]);
+    verbose = config.getAndCatch("verbose", false);
+
+    dmemo::CommunicatorPtr commAll = dmemo::Communicator::getCommunicatorPtr();
+    common::Settings::setRank(commAll->getNodeRank());
+    hmemo::ContextPtr ctx = hmemo::Context::getContextPtr();
+
+    // sweep parameters
+    auto dimensions = getList<std::string>(config, "benchDimensions", "2D,3D");
+    auto equationTypes = getList<std::string>(config, "benchEquationTypes", "acoustic,elastic,viscoelastic,sh,viscosh,tmem,emem,viscotmem,viscoemem");
+    auto modelTypes = getList<std::string>(config, "benchModels", "homogeneous,layered");
+    auto gridSizes2D = getList<IndexType>(config, "benchGridSizes2D", "500,1000,2000");
+    auto gridSizes3D = getList<IndexType>(config, "benchGridSizes3D", "50,100,200");
+    auto spatialFDorders = getList<IndexType>(config, "benchFDorders", "2,4,8");
+    auto numThreadsList = getList<IndexType>(config, "benchThreads", "1");
+    IndexType streamSize = config.getAndCatch("benchStreamSize", IndexType(20000000));
+    std::string reportFilename = config.getAndCatch("benchReportFilename", std::string(""));
+
+    // the synthetic models are generated on the fly on a regular grid, the parameters of the other equation types are set if they are missing
+    config.add2config("ModelRead", 0, true);
+    config.add2config("useVariableGrid", 0, true);
+    config.add2config("useVariableFDoperators", 0, true);
+    config.add2config("useStreamConfig", 0, true);
+    config.add2config("initSourcesFromSU", 0, true);
+    config.add2config("kernelProfiling", 0, true);
+    config.add2config("velocityP", 3500);
+    config.add2config("velocityS", 2000);
+    config.add2config("rho", 2000);
+    config.add2config("tauP", 0.1);
+    config.add2config("tauS", 0.1);
+    config.add2config("mur", 1);
+    config.add2config("sigma", 0.001);
+    config.add2config("epsilonr", 9);
+    config.add2config("tauSigmar", 0.1);
+    config.add2config("tauEpsilon", 0.1);
+    if (config.getAndCatch("relaxationFrequency", 0.0) <= 0) {
+        config.add2config("relaxationFrequency", 10, true);
+    }
+
+    HOST_PRINT(commAll, "\n WAVE-Simulation Benchmark - LAMA Version\n");
+    HOST_PRINT(commAll, "  - Running on " << commAll->getSize() << " mpi processes -\n\n");
+
+    std::vector<BenchmarkResult> results;
+    for (auto numThreads : numThreadsList) {
+#ifdef _OPENMP
+        omp_set_num_threads(numThreads);
+#else
+        if (numThreads != numThreadsList.front()) {
+            HOST_PRINT(commAll, "Built without OpenMP, the number of threads is not changed\n");
+        }
+#endif
+        double streamBandwidth = measureStreamBandwidth(streamSize, commAll);
+        HOST_PRINT(commAll, "\n" << numThreads << " threads per process, STREAM triad " << std::fixed << std::setprecision(2) << streamBandwidth << " GB/s\n" << std::defaultfloat);
+        HOST_PRINT(commAll, std::setw(4) << "dim" << std::setw(14) << "equation" << std::setw(13) << "model" << std::setw(7) << "N" << std::setw(4) << "FD"
+                                         << std::setw(12) << "ms/step" << std::setw(12) << "Mpoints/s" << std::setw(10) << "GB/s" << std::setw(9) << "STREAM" << std::setw(10) << "GFLOP/s" << std::setw(12) << "roofline" << "\n");
+
+        for (auto dimension : dimensions) {
+            std::transform(dimension.begin(), dimension.end(), dimension.begin(), ::tolower);
+            for (auto equationType : equationTypes) {
+                std::transform(equationType.begin(), equationType.end(), equationType.begin(), ::tolower);
+                // sh, viscosh, tmem and viscotmem are only implemented in 2D
+                if (dimension.compare("3d") == 0 && (equationType.compare("sh") == 0 || equationType.compare("viscosh") == 0 || equationType.compare("tmem") == 0 || equationType.compare("viscotmem") == 0)) {
+                    continue;
+                }
+                for (auto const &modelType : modelTypes) {
+                    for (auto gridSize : (dimension.compare("3d") == 0) ? gridSizes3D : gridSizes2D) {
+                        for (auto spatialFDorder : spatialFDorders) {
+                            BenchmarkResult result;
+                            result.dimension = dimension;
+                            result.equationType = equationType;
+                            result.modelType = modelType;
+                            result.gridSize = gridSize;
+                            result.spatialFDorder = spatialFDorder;
+                            result.numThreads = numThreads;
+                            result.streamBandwidth = streamBandwidth;
+                            runCase(config, commAll, ctx, result);
+                            results.push_back(result);
+
+                            // the time step is memory bound, so the roofline is the STREAM bandwidth divided by the bytes per gridpoint
+                            double pointsPerSecond = result.numGridpoints / result.timePerStep;
+                            double bandwidth = result.bytesPerStep / result.timePerStep * 1e-9;
+                            double rooflinePointsPerSecond = streamBandwidth * 1e9 / (result.bytesPerStep / result.numGridpoints);
+                            HOST_PRINT(commAll, std::fixed << std::setw(4) << dimension << std::setw(14) << equationType << std::setw(13) << modelType << std::setw(7) << gridSize << std::setw(4) << spatialFDorder
+                                                           << std::setw(12) << std::setprecision(3) << 1000 * result.timePerStep << std::setw(12) << std::setprecision(2) << pointsPerSecond * 1e-6
+                                                           << std::setw(10) << bandwidth << std::setw(8) << std::setprecision(1) << 100 * bandwidth / streamBandwidth << "%"
+                                                           << std::setw(10) << std::setprecision(2) << result.flopsPerStep / result.timePerStep * 1e-9 << std::setw(12) << rooflinePointsPerSecond * 1e-6 << "\n"
+                                                           << std::defaultfloat);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // machine-readable copy of all cases, e.g. to compare machines or releases
+    if (!reportFilename.empty() && commAll->getRank() == MASTERGPI) {
+        std::ofstream report(reportFilename);
+        report << "{\n";
+        report << "  \"numProcesses\": " << commAll->getSize() << ",\n";
+        report << "  \"valueSize\": " << sizeof(ValueType) << ",\n";
+        report << "  \"cases\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            BenchmarkResult const &result = results[i];
+            report << "    {\"dimension\": \"" << result.dimension << "\", \"equationType\": \"" << result.equationType << "\", \"model\": \"" << result.modelType << "\"";
+            report << ", \"gridSize\": " << result.gridSize << ", \"spatialFDorder\": " << result.spatialFDorder << ", \"numThreads\": " << result.numThreads;
+            report << ", \"numGridpoints\": " << result.numGridpoints << ", \"timePerStep\": " << result.timePerStep;
+            report << ", \"pointsPerSecond\": " << result.numGridpoints / result.timePerStep;
+            report << ", \"bytesPerStep\": " << result.bytesPerStep << ", \"flopsPerStep\": " << result.flopsPerStep;
+            report << ", \"bandwidth\": " << result.bytesPerStep / result.timePerStep * 1e-9 << ", \"streamBandwidth\": " << result.streamBandwidth;
+            report << ", \"rooflinePointsPerSecond\": " << result.streamBandwidth * 1e9 * result.numGridpoints / result.bytesPerStep << "}";
+            report << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        report << "  ]\n";
+        report << "}\n";
+        SCAI_ASSERT_ERROR(report.good(), "Could not write benchmark report " << reportFilename);
+    }
+
+    return 0;
+}
@@ -70,6 +70,36 @@ int main(int argc, char *argv[])
 
     //write model to disc
 
+    if (fileFormat == 4) {
+        // all parameters in one packed model file
+        std::vector<lama::DenseVector<ValueType> const *> parameters = {&rho};
+        std::vector<std::string> names = {"density"};
+        if (type.compare("sh") != 0) {
+            parameters.push_back(&vp);
+            names.push_back("vp");
+        }
+        if (type.compare("acoustic") != 0) {
+            parameters.push_back(&vs);
+            names.push_back("vs");
+        }
+        if (type.compare("viscoelastic") == 0) {
+            parameters.push_back(&tauP);
+            names.push_back("tauP");
+            parameters.push_back(&tauS);
+            names.push_back("tauS");
+        }
+
+        KITGPI::IO::PackedModelHeader header;
+        header.layout = config.getAndCatch("PackedModelLayout", 0);
+        header.parameterisation = config.getAndCatch("parameterisation", 0);
+        header.NX = NX;
+        header.NY = NY;
+        header.NZ = NZ;
+        header.DH = config.get<ValueType>("DH");
+        KITGPI::IO::writePackedModel(parameters, names, filename, header, config.getAndCatch("PackedModelValueSize", IndexType(sizeof(float))));
+        return 0;
+    }
+
     KITGPI::IO::writeVector(rho, filename + ".density", fileFormat);
 
     if (type.compare("sh") != 0) {